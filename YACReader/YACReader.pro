@@ -91,6 +91,10 @@ HEADERS +=  ../common/comic.h \
             ../common/bookmarks.h \
             bookmarks_dialog.h \
             render.h \
+            page_cache.h \
+            image_kernels.h \
+            page_scaler.h \
+            scaled_page_label.h \
             shortcuts_dialog.h \
             translator.h \
             goto_flow_widget.h \
@@ -105,6 +109,7 @@ HEADERS +=  ../common/comic.h \
             ../common/yacreader_global.h \
             ../common/yacreader_global_gui.h \
             ../common/comic_db.h \
+            ../common/cover_store.h \
             ../common/folder.h \
             ../common/library_item.h \
             yacreader_local_client.h \
@@ -112,7 +117,9 @@ HEADERS +=  ../common/comic.h \
             ../common/exit_check.h \
             ../common/scroll_management.h \
             ../common/opengl_checker.h \
-            ../common/pdf_comic.h
+            ../common/pdf_comic.h \
+            ../common/concurrent_queue.h \
+            ../common/cover_loader.h
 
 !CONFIG(no_opengl) {
     HEADERS += ../common/gl/yacreader_flow_gl.h \
@@ -130,6 +137,10 @@ SOURCES +=  ../common/comic.cpp \
             ../common/bookmarks.cpp \
             bookmarks_dialog.cpp \
             render.cpp \
+            page_cache.cpp \
+            image_kernels.cpp \
+            page_scaler.cpp \
+            scaled_page_label.cpp \
             shortcuts_dialog.cpp \
             translator.cpp \
             goto_flow_widget.cpp \
@@ -142,6 +153,7 @@ SOURCES +=  ../common/comic.cpp \
             ../common/check_new_version.cpp \
             ../common/qnaturalsorting.cpp \
             ../common/comic_db.cpp \
+            ../common/cover_store.cpp \
             ../common/folder.cpp \
             ../common/library_item.cpp \
             yacreader_local_client.cpp \
@@ -150,7 +162,9 @@ SOURCES +=  ../common/comic.cpp \
             ../common/yacreader_global_gui.cpp \
             ../common/exit_check.cpp \
             ../common/scroll_management.cpp \
-            ../common/opengl_checker.cpp
+            ../common/opengl_checker.cpp \
+            ../common/concurrent_queue.cpp \
+            ../common/cover_loader.cpp
 
 !CONFIG(no_opengl) {
         SOURCES += ../common/gl/yacreader_flow_gl.cpp \
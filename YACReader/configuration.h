@@ -81,6 +81,8 @@ public:
     bool getDisableShowOnMouseOver() { return settings->value(DISABLE_MOUSE_OVER_GOTO_FLOW).toBool(); }
     bool getDoNotTurnPageOnScroll() { return settings->value(DO_NOT_TURN_PAGE_ON_SCROLL, false).toBool(); }
     bool getUseSingleScrollStepToTurnPage() { return settings->value(USE_SINGLE_SCROLL_STEP_TO_TURN_PAGE, false).toBool(); }
+    // MB
+    int getRenderedPagesCacheSize() { return settings->value(RENDERED_PAGES_CACHE_SIZE, 256).toInt(); }
 };
 
 #endif
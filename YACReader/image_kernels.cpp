@@ -0,0 +1,190 @@
+#include "image_kernels.h"
+
+#include <algorithm>
+#include <iterator>
+
+namespace {
+thread_local bool sequentialBands = false;
+
+// two level histogram, the median is found checking at most 16 + 16 bins
+struct Histogram {
+    int coarse[16];
+    int fine[256];
+
+    void clear()
+    {
+        std::fill(std::begin(coarse), std::end(coarse), 0);
+        std::fill(std::begin(fine), std::end(fine), 0);
+    }
+
+    void add(int value)
+    {
+        coarse[value >> 4]++;
+        fine[value]++;
+    }
+
+    void remove(int value)
+    {
+        coarse[value >> 4]--;
+        fine[value]--;
+    }
+
+    // n-th smallest value, starting at 0
+    int nth(int n) const
+    {
+        int bucket = 0;
+        while (n >= coarse[bucket]) {
+            n -= coarse[bucket];
+            bucket++;
+        }
+
+        int value = bucket << 4;
+        while (n >= fine[value]) {
+            n -= fine[value];
+            value++;
+        }
+        return value;
+    }
+};
+}
+
+void YACReader::setSequentialRowBands(bool sequential)
+{
+    sequentialBands = sequential;
+}
+
+bool YACReader::sequentialRowBands()
+{
+    return sequentialBands;
+}
+
+QImage YACReader::meanFilter(const QImage &image, int filterSize)
+{
+    const QImage source = image.convertToFormat(QImage::Format_RGB32);
+    QImage result = source.copy();
+
+    const int width = source.width();
+    const int height = source.height();
+    const int bound = filterSize / 2;
+    if (width <= 2 * bound || height <= 2 * bound) {
+        return result;
+    }
+
+    const int area = filterSize * filterSize;
+    const uchar *sourceBits = source.constBits();
+    const qsizetype sourceBytesPerLine = source.bytesPerLine();
+    uchar *resultBits = result.bits();
+    const qsizetype resultBytesPerLine = result.bytesPerLine();
+
+    // box filter: the sums of each column are updated when moving down and the sum of the window is
+    // updated when moving right, so every pixel costs the same whatever the filter size is
+    forEachRowBand(height - 2 * bound, qint64(width) * height, [=](int first, int last) {
+        std::vector<int> red(width, 0), green(width, 0), blue(width, 0);
+
+        for (int row = first; row < last; row++) {
+            const int y = row + bound;
+
+            if (row == first) {
+                for (int v = y - bound; v <= y + bound; v++) {
+                    auto in = reinterpret_cast<const QRgb *>(sourceBits + v * sourceBytesPerLine);
+                    for (int x = 0; x < width; x++) {
+                        red[x] += qRed(in[x]);
+                        green[x] += qGreen(in[x]);
+                        blue[x] += qBlue(in[x]);
+                    }
+                }
+            } else {
+                auto out = reinterpret_cast<const QRgb *>(sourceBits + (y - bound - 1) * sourceBytesPerLine);
+                auto in = reinterpret_cast<const QRgb *>(sourceBits + (y + bound) * sourceBytesPerLine);
+                for (int x = 0; x < width; x++) {
+                    red[x] += qRed(in[x]) - qRed(out[x]);
+                    green[x] += qGreen(in[x]) - qGreen(out[x]);
+                    blue[x] += qBlue(in[x]) - qBlue(out[x]);
+                }
+            }
+
+            int r = 0, g = 0, b = 0;
+            for (int x = 0; x < filterSize; x++) {
+                r += red[x];
+                g += green[x];
+                b += blue[x];
+            }
+
+            auto line = reinterpret_cast<QRgb *>(resultBits + y * resultBytesPerLine);
+            for (int x = bound; x < width - bound; x++) {
+                line[x] = qRgb(r / area, g / area, b / area);
+
+                if (x + bound + 1 < width) {
+                    r += red[x + bound + 1] - red[x - bound];
+                    g += green[x + bound + 1] - green[x - bound];
+                    b += blue[x + bound + 1] - blue[x - bound];
+                }
+            }
+        }
+    });
+
+    return result;
+}
+
+QImage YACReader::medianFilter(const QImage &image, int filterSize)
+{
+    const QImage source = image.convertToFormat(QImage::Format_RGB32);
+    QImage result = source.copy();
+
+    const int width = source.width();
+    const int height = source.height();
+    const int bound = filterSize / 2;
+    if (width <= 2 * bound || height <= 2 * bound) {
+        return result;
+    }
+
+    const int median = (filterSize * filterSize) / 2;
+    const uchar *sourceBits = source.constBits();
+    const qsizetype sourceBytesPerLine = source.bytesPerLine();
+    uchar *resultBits = result.bits();
+    const qsizetype resultBytesPerLine = result.bytesPerLine();
+
+    // Huang's sliding histograms: moving right removes the left column of the neighbourhood and adds the right one,
+    // so every pixel costs 2 * filterSize histogram updates (O(filterSize)) plus the 16 + 16 bins checked to find
+    // the median, no sorting
+    forEachRowBand(height - 2 * bound, qint64(width) * height, [=](int first, int last) {
+        Histogram red, green, blue;
+
+        for (int row = first; row < last; row++) {
+            const int y = row + bound;
+
+            red.clear();
+            green.clear();
+            blue.clear();
+            for (int v = y - bound; v <= y + bound; v++) {
+                auto in = reinterpret_cast<const QRgb *>(sourceBits + v * sourceBytesPerLine);
+                for (int x = 0; x < filterSize; x++) {
+                    red.add(qRed(in[x]));
+                    green.add(qGreen(in[x]));
+                    blue.add(qBlue(in[x]));
+                }
+            }
+
+            auto line = reinterpret_cast<QRgb *>(resultBits + y * resultBytesPerLine);
+            for (int x = bound; x < width - bound; x++) {
+                line[x] = qRgb(red.nth(median), green.nth(median), blue.nth(median));
+
+                if (x + bound + 1 < width) {
+                    for (int v = y - bound; v <= y + bound; v++) {
+                        auto in = reinterpret_cast<const QRgb *>(sourceBits + v * sourceBytesPerLine);
+                        QRgb out = in[x - bound];
+                        QRgb next = in[x + bound + 1];
+                        red.remove(qRed(out));
+                        green.remove(qGreen(out));
+                        blue.remove(qBlue(out));
+                        red.add(qRed(next));
+                        green.add(qGreen(next));
+                        blue.add(qBlue(next));
+                    }
+                }
+            }
+        }
+    });
+
+    return result;
+}
@@ -0,0 +1,49 @@
+#ifndef IMAGE_KERNELS_H
+#define IMAGE_KERNELS_H
+
+#include <QImage>
+#include <QThread>
+
+#include <thread>
+#include <vector>
+
+namespace YACReader {
+
+// Threads that already run in parallel with others, like the page render threads, set this so the
+// kernels they call don't start more threads than cores. It only affects the calling thread.
+void setSequentialRowBands(bool sequential);
+bool sequentialRowBands();
+
+// runs rows(first, last) over bands of rows, using several threads for big images
+template<typename Function>
+void forEachRowBand(int height, qint64 pixels, Function rows)
+{
+    const qint64 minPixelsPerThread = 1 << 20;
+    int threads = int(qMin<qint64>(pixels / minPixelsPerThread, qMin(QThread::idealThreadCount(), 4)));
+    threads = qMin(threads, height);
+
+    if (threads <= 1 || sequentialRowBands()) {
+        rows(0, height);
+        return;
+    }
+
+    int band = (height + threads - 1) / threads;
+    std::vector<std::thread> workers;
+    for (int first = band; first < height; first += band) {
+        workers.emplace_back(rows, first, qMin(height, first + band));
+    }
+    rows(0, qMin(band, height));
+
+    for (auto &worker : workers) {
+        worker.join();
+    }
+}
+
+// Mean and median of the filterSize x filterSize neighbourhood of each pixel (filterSize must be odd).
+// The pixels closer than filterSize / 2 to the borders are copied from `image`. The result is RGB32.
+QImage meanFilter(const QImage &image, int filterSize);
+QImage medianFilter(const QImage &image, int filterSize);
+
+}
+
+#endif // IMAGE_KERNELS_H
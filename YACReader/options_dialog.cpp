@@ -12,6 +12,7 @@
 #include <QLabel>
 #include <QColorDialog>
 #include <QCheckBox>
+#include <QSpinBox>
 
 #include "yacreader_spin_slider_widget.h"
 #include "yacreader_flow_config_widget.h"
@@ -79,11 +80,26 @@ OptionsDialog::OptionsDialog(QWidget *parent)
 
     scrollBox->setLayout(scrollLayout);
 
+    auto memoryBox = new QGroupBox(tr("Memory"));
+    auto memoryLayout = new QHBoxLayout;
+
+    pagesCacheSizeSpinBox = new QSpinBox();
+    pagesCacheSizeSpinBox->setRange(32, 8192);
+    pagesCacheSizeSpinBox->setSingleStep(32);
+    pagesCacheSizeSpinBox->setSuffix(" MB");
+
+    memoryLayout->addWidget(new QLabel(tr("Memory used to keep rendered pages")));
+    memoryLayout->addStretch();
+    memoryLayout->addWidget(pagesCacheSizeSpinBox);
+
+    memoryBox->setLayout(memoryLayout);
+
     layoutGeneral->addWidget(pathBox);
     layoutGeneral->addWidget(slideSizeBox);
     // layoutGeneral->addWidget(fitBox);
     layoutGeneral->addWidget(colorBox);
     layoutGeneral->addWidget(scrollBox);
+    layoutGeneral->addWidget(memoryBox);
     layoutGeneral->addWidget(shortcutsBox);
     layoutGeneral->addStretch();
 
@@ -243,6 +259,8 @@ void OptionsDialog::saveOptions()
     settings->setValue(DO_NOT_TURN_PAGE_ON_SCROLL, doNotTurnPageOnScroll->isChecked());
     settings->setValue(USE_SINGLE_SCROLL_STEP_TO_TURN_PAGE, useSingleScrollStepToTurnPage->isChecked());
 
+    settings->setValue(RENDERED_PAGES_CACHE_SIZE, pagesCacheSizeSpinBox->value());
+
     YACReaderOptionsDialog::saveOptions();
 }
 
@@ -283,6 +301,8 @@ void OptionsDialog::restoreOptions(QSettings *settings)
 
     doNotTurnPageOnScroll->setChecked(settings->value(DO_NOT_TURN_PAGE_ON_SCROLL, false).toBool());
     useSingleScrollStepToTurnPage->setChecked(settings->value(USE_SINGLE_SCROLL_STEP_TO_TURN_PAGE, false).toBool());
+
+    pagesCacheSizeSpinBox->setValue(settings->value(RENDERED_PAGES_CACHE_SIZE, 256).toInt());
 }
 
 void OptionsDialog::updateColor(const QColor &color)
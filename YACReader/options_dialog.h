@@ -10,6 +10,7 @@ class QPushButton;
 class QSlider;
 class QPushButton;
 class QRadioButton;
+class QSpinBox;
 class YACReaderSpinSliderWidget;
 
 class OptionsDialog : public YACReaderOptionsDialog
@@ -43,6 +44,8 @@ private:
     QCheckBox *doNotTurnPageOnScroll;
     QCheckBox *useSingleScrollStepToTurnPage;
 
+    QSpinBox *pagesCacheSizeSpinBox;
+
     YACReaderSpinSliderWidget *brightnessS;
 
     YACReaderSpinSliderWidget *contrastS;
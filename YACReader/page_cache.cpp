@@ -0,0 +1,54 @@
+#include "page_cache.h"
+
+#include <QStringList>
+
+#include <limits>
+
+PageCache::PageCache(qint64 maxBytes)
+    : hits(0), misses(0)
+{
+    cache.setMaxCost(static_cast<int>(qMin<qint64>(maxBytes / 1024, std::numeric_limits<int>::max())));
+}
+
+QString PageCache::key(const QString &comic, int page, int rotation, const QVector<int> &filterLevels)
+{
+    QStringList levels;
+    for (int level : filterLevels) {
+        levels.append(QString::number(level));
+    }
+
+    return QString("%1|%2|%3|%4").arg(comic).arg(page).arg(rotation).arg(levels.join(","));
+}
+
+bool PageCache::find(const QString &key, QImage &image)
+{
+    QImage *cached = cache.object(key);
+    if (cached == nullptr) {
+        misses++;
+        return false;
+    }
+
+    hits++;
+    image = *cached;
+    return true;
+}
+
+void PageCache::insert(const QString &key, const QImage &image)
+{
+    if (image.isNull()) {
+        return;
+    }
+
+    // pages bigger than the whole cache are not inserted
+    cache.insert(key, new QImage(image), qMax(1, static_cast<int>(image.sizeInBytes() / 1024)));
+}
+
+void PageCache::clear()
+{
+    cache.clear();
+}
+
+PageCache::Stats PageCache::stats() const
+{
+    return { hits, misses, static_cast<int>(cache.count()), qint64(cache.totalCost()) * 1024, qint64(cache.maxCost()) * 1024 };
+}
@@ -0,0 +1,40 @@
+#ifndef PAGE_CACHE_H
+#define PAGE_CACHE_H
+
+#include <QCache>
+#include <QImage>
+#include <QString>
+#include <QVector>
+
+// LRU cache of rendered pages bounded by the memory used by the images. Pages are cached by comic,
+// page, rotation and filter levels so they are still valid after the buffer moves or the reading
+// mode changes.
+class PageCache
+{
+public:
+    struct Stats {
+        quint64 hits;
+        quint64 misses;
+        int pages;
+        qint64 usedBytes;
+        qint64 maxBytes;
+    };
+
+    explicit PageCache(qint64 maxBytes);
+
+    static QString key(const QString &comic, int page, int rotation, const QVector<int> &filterLevels);
+
+    // copies the cached page into `image`, returns false if the page isn't cached
+    bool find(const QString &key, QImage &image);
+    void insert(const QString &key, const QImage &image);
+    void clear();
+
+    Stats stats() const;
+
+private:
+    QCache<QString, QImage> cache; // cost in KB
+    quint64 hits;
+    quint64 misses;
+};
+
+#endif // PAGE_CACHE_H
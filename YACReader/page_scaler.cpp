@@ -0,0 +1,169 @@
+#include "page_scaler.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace {
+const int scalerThreads = 2;
+const int maxCachedKB = 128 * 1024;
+}
+
+QSize fitPageSize(const QSize &pageSize, const PageFit &fit)
+{
+    QSize pagefit = pageSize;
+    switch (fit.mode) {
+    case YACReader::FitMode::FullRes:
+        break;
+    case YACReader::FitMode::ToWidth:
+        if (!fit.enlarge && fit.viewport.width() > pagefit.width()) {
+            break;
+        }
+        pagefit.scale(fit.viewport.width(), 0, Qt::KeepAspectRatioByExpanding);
+        break;
+    case YACReader::FitMode::ToHeight:
+        if (!fit.enlarge && fit.viewport.height() > pagefit.height()) {
+            break;
+        }
+        pagefit.scale(0, fit.viewport.height(), Qt::KeepAspectRatioByExpanding);
+        break;
+        // if everything fails showing the full page is a good idea
+    case YACReader::FitMode::FullPage:
+    default:
+        pagefit.scale(fit.viewport, Qt::KeepAspectRatio);
+        break;
+    }
+
+    if (fit.zoom != 100) {
+        pagefit.scale(std::floor(pagefit.width() * fit.zoom / 100.0f), 0, Qt::KeepAspectRatioByExpanding);
+    }
+    return pagefit;
+}
+
+PageScaler::PageScaler(QObject *parent)
+    : QObject(parent), cache(maxCachedKB), bailout(false)
+{
+    for (int i = 0; i < scalerThreads; i++) {
+        threads.emplace_back(&PageScaler::work, this);
+    }
+}
+
+PageScaler::~PageScaler()
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        bailout = true;
+        pending.clear();
+    }
+    jobAvailable.notify_all();
+
+    for (auto &thread : threads) {
+        thread.join();
+    }
+}
+
+QString PageScaler::cacheKey(const QString &key, const QSize &size, const QRect &tile)
+{
+    return QString("%1@%2x%3:%4,%5,%6,%7").arg(key).arg(size.width()).arg(size.height()).arg(tile.x()).arg(tile.y()).arg(tile.width()).arg(tile.height());
+}
+
+bool PageScaler::find(const QString &key, const QSize &size, const QRect &tile, QImage &scaled)
+{
+    auto image = cache.object(cacheKey(key, size, tile));
+    if (image == nullptr) {
+        return false;
+    }
+    scaled = *image;
+    return true;
+}
+
+void PageScaler::request(const QString &key, const QImage &image, const QSize &size, const QRect &tile, bool urgent)
+{
+    if (image.isNull() || size.isEmpty()) {
+        return;
+    }
+
+    QString jobKey = cacheKey(key, size, tile);
+    if (cache.contains(jobKey)) {
+        return;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (std::find(running.begin(), running.end(), jobKey) != running.end()) {
+            return;
+        }
+
+        auto queued = std::find_if(pending.begin(), pending.end(), [&](const Job &job) { return cacheKey(job.key, job.size, job.tile) == jobKey; });
+        if (queued != pending.end()) {
+            if (!urgent) {
+                return;
+            }
+            pending.erase(queued);
+        }
+
+        Job job { key, image, size, tile };
+        if (urgent) {
+            pending.push_front(job);
+        } else {
+            pending.push_back(job);
+        }
+
+        // the oldest requests made ahead of time are the least likely to be needed
+        while (pending.size() > maxPendingJobs) {
+            pending.pop_back();
+        }
+    }
+    jobAvailable.notify_one();
+}
+
+void PageScaler::cancelPending()
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    pending.clear();
+}
+
+void PageScaler::work()
+{
+    std::unique_lock<std::mutex> lock(mutex);
+    while (true) {
+        jobAvailable.wait(lock, [this] { return bailout || !pending.empty(); });
+        if (bailout) {
+            return;
+        }
+
+        Job job = pending.front();
+        pending.pop_front();
+        QString jobKey = cacheKey(job.key, job.size, job.tile);
+        running.push_back(jobKey);
+        lock.unlock();
+
+        QImage result;
+        if (job.tile.isNull()) {
+            result = job.image.scaled(job.size, Qt::IgnoreAspectRatio, Qt::SmoothTransformation);
+        } else {
+            // only the source rows under the tile are scaled
+            qreal xFactor = qreal(job.image.width()) / job.size.width();
+            qreal yFactor = qreal(job.image.height()) / job.size.height();
+            QRect source(QPoint(int(std::floor(job.tile.left() * xFactor)), int(std::floor(job.tile.top() * yFactor))),
+                         QPoint(int(std::ceil((job.tile.right() + 1) * xFactor)) - 1, int(std::ceil((job.tile.bottom() + 1) * yFactor)) - 1));
+            result = job.image.copy(source.intersected(job.image.rect())).scaled(job.tile.size(), Qt::IgnoreAspectRatio, Qt::SmoothTransformation);
+        }
+
+        deliver(job, result);
+
+        lock.lock();
+        running.erase(std::find(running.begin(), running.end(), jobKey));
+    }
+}
+
+void PageScaler::deliver(const Job &job, const QImage &result)
+{
+    // the cache is only used from the GUI thread
+    QMetaObject::invokeMethod(
+            this, [this, job, result] {
+                QString jobKey = cacheKey(job.key, job.size, job.tile);
+                cache.insert(jobKey, new QImage(result), qMax(1, static_cast<int>(result.sizeInBytes() / 1024)));
+                emit scaled(job.key, job.size, job.tile);
+            },
+            Qt::QueuedConnection);
+}
@@ -0,0 +1,79 @@
+#ifndef PAGE_SCALER_H
+#define PAGE_SCALER_H
+
+#include <QCache>
+#include <QImage>
+#include <QObject>
+#include <QRect>
+#include <QString>
+
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "yacreader_global_gui.h"
+
+// how pages are fitted in the viewer
+struct PageFit {
+    YACReader::FitMode mode;
+    QSize viewport;
+    int zoom;
+    bool enlarge;
+};
+
+// size (logical pixels) a page of `pageSize` is shown at
+QSize fitPageSize(const QSize &pageSize, const PageFit &fit);
+
+// Scales pages to the size they are shown at using worker threads, so resizing, zooming or turning
+// pages doesn't stall the GUI with smooth transformations. Scaled images are kept in a small LRU cache,
+// this way the pages scaled ahead of time are ready when they are shown.
+//
+// Images are identified by a key given by the caller (e.g. the page cache key), an image is scaled
+// entirely (null `tile`) or only the part of the scaled image inside `tile`, for pages too tall to be
+// scaled at once.
+class PageScaler : public QObject
+{
+    Q_OBJECT
+public:
+    // scaled pages taller than this (device pixels) are scaled in tiles of this height
+    static constexpr int tileHeight = 2048;
+
+    explicit PageScaler(QObject *parent = nullptr);
+    ~PageScaler() override;
+
+    bool find(const QString &key, const QSize &size, const QRect &tile, QImage &scaled);
+    // `urgent` requests (visible pages) are scaled before the ones made ahead of time
+    void request(const QString &key, const QImage &image, const QSize &size, const QRect &tile, bool urgent);
+    // drops the pending requests that haven't started yet
+    void cancelPending();
+
+signals:
+    void scaled(const QString &key, const QSize &size, const QRect &tile);
+
+private:
+    struct Job {
+        QString key;
+        QImage image;
+        QSize size;
+        QRect tile;
+    };
+
+    static constexpr int maxPendingJobs = 16;
+
+    static QString cacheKey(const QString &key, const QSize &size, const QRect &tile);
+    void work();
+    void deliver(const Job &job, const QImage &result);
+
+    QCache<QString, QImage> cache; // cost in KB, only used from the GUI thread
+
+    std::mutex mutex;
+    std::condition_variable jobAvailable;
+    std::deque<Job> pending;
+    std::vector<QString> running;
+    bool bailout;
+    std::vector<std::thread> threads;
+};
+
+#endif // PAGE_SCALER_H
@@ -6,13 +6,17 @@
 #include <QPixmap>
 #include <QApplication>
 #include <QImage>
+#include <QFileInfo>
 
 #include <typeinfo>
 
 #include "comic_db.h"
+#include "image_kernels.h"
 #include "yacreader_global_gui.h"
 #include "configuration.h"
 
+#include "QsLog.h"
+
 template<class T>
 inline const T &kClamp(const T &x, const T &low, const T &high)
 {
@@ -39,86 +43,100 @@ inline int changeGamma(int value, int gamma)
     return kClamp(int(pow(value / 255.0, 100.0 / gamma) * 255), 0, 255);
 }
 
-inline int changeUsingTable(int value, const int table[])
+static void identityTable(uchar table[256])
 {
-    return table[value];
+    for (int i = 0; i < 256; i++) {
+        table[i] = i;
+    }
 }
 
-template<int operation(int, int)>
-static QImage changeImage(const QImage &image, int value)
+// applies the same lookup table to the red, green and blue channels
+static QImage applyTable(const QImage &image, const uchar table[256])
 {
+    bool identity = true;
+    for (int i = 0; i < 256 && identity; i++) {
+        identity = table[i] == i;
+    }
+    if (identity) // no change
+        return image;
+
     QImage im = image;
     im.detach();
     if (im.colorCount() == 0) /* truecolor */
     {
         if (im.format() != QImage::Format_RGB32) /* just in case */
             im = im.convertToFormat(QImage::Format_RGB32);
-        int table[256];
-        for (int i = 0;
-             i < 256;
-             ++i)
-            table[i] = operation(i, value);
-        if (im.hasAlphaChannel()) {
-            for (int y = 0;
-                 y < im.height();
-                 ++y) {
-                QRgb *line = reinterpret_cast<QRgb *>(im.scanLine(y));
-                for (int x = 0;
-                     x < im.width();
-                     ++x)
-                    line[x] = qRgba(changeUsingTable(qRed(line[x]), table),
-                                    changeUsingTable(qGreen(line[x]), table),
-                                    changeUsingTable(qBlue(line[x]), table),
-                                    changeUsingTable(qAlpha(line[x]), table));
-            }
-        } else {
-            for (int y = 0;
-                 y < im.height();
-                 ++y) {
-                QRgb *line = reinterpret_cast<QRgb *>(im.scanLine(y));
-                for (int x = 0;
-                     x < im.width();
-                     ++x)
-                    line[x] = qRgb(changeUsingTable(qRed(line[x]), table),
-                                   changeUsingTable(qGreen(line[x]), table),
-                                   changeUsingTable(qBlue(line[x]), table));
+
+        // scanLine() can't be used from several threads, it detaches the image
+        uchar *bits = im.bits();
+        const qsizetype bytesPerLine = im.bytesPerLine();
+        const int width = im.width();
+        YACReader::forEachRowBand(im.height(), qint64(width) * im.height(), [=](int first, int last) {
+            for (int y = first; y < last; ++y) {
+                QRgb *line = reinterpret_cast<QRgb *>(bits + y * bytesPerLine);
+                for (int x = 0; x < width; ++x) {
+                    QRgb pixel = line[x];
+                    line[x] = 0xff000000u | (uint(table[qRed(pixel)]) << 16) | (uint(table[qGreen(pixel)]) << 8) | uint(table[qBlue(pixel)]);
+                }
             }
-        }
+        });
     } else {
         QVector<QRgb> colors = im.colorTable();
         for (int i = 0;
              i < im.colorCount();
              ++i)
-            colors[i] = qRgb(operation(qRed(colors[i]), value),
-                             operation(qGreen(colors[i]), value),
-                             operation(qBlue(colors[i]), value));
+            colors[i] = qRgb(table[qRed(colors[i])],
+                             table[qGreen(colors[i])],
+                             table[qBlue(colors[i])]);
         im.setColorTable(colors);
     }
     return im;
 }
 
-// brightness is multiplied by 100 in order to avoid floating point numbers
-QImage changeBrightness(const QImage &image, int brightness)
+template<int operation(int, int)>
+static void composeTable(uchar table[256], int value)
 {
-    if (brightness == 0) // no change
-        return image;
-    return changeImage<changeBrightness>(image, brightness);
+    for (int i = 0; i < 256; i++) {
+        table[i] = operation(table[i], value);
+    }
 }
 
-// contrast is multiplied by 100 in order to avoid floating point numbers
-QImage changeContrast(const QImage &image, int contrast)
+static QImage applyTableFilter(ImageFilter *filter, const QImage &image)
 {
-    if (contrast == 100) // no change
-        return image;
-    return changeImage<changeContrast>(image, contrast);
+    uchar table[256];
+    identityTable(table);
+    filter->composeTable(table);
+    return applyTable(image, table);
 }
 
-// gamma is multiplied by 100 in order to avoid floating point numbers
-QImage changeGamma(const QImage &image, int gamma)
+// Applies `filters` in order. Consecutive filters that only change channel values (brightness,
+// contrast, gamma) are merged into a single lookup table, so the image is traversed once for all of them.
+// `cancelled` is checked between passes.
+template<typename Cancelled>
+static QImage applyFilters(QImage image, const QVector<ImageFilter *> &filters, Cancelled cancelled)
 {
-    if (gamma == 100) // no change
-        return image;
-    return changeImage<changeGamma>(image, gamma);
+    int i = 0;
+    while (i < filters.size()) {
+        if (cancelled()) {
+            return QImage();
+        }
+
+        uchar table[256];
+        identityTable(table);
+        int next = i;
+        while (next < filters.size() && filters[next]->composeTable(table)) {
+            next++;
+        }
+
+        if (next > i) {
+            image = applyTable(image, table);
+            i = next;
+        } else {
+            image = filters[i]->setFilter(image);
+            i++;
+        }
+    }
+    return image;
 }
 
 //-----------------------------------------------------------------------------
@@ -132,30 +150,7 @@ MeanNoiseReductionFilter::MeanNoiseReductionFilter(enum NeighborghoodSize ns)
 
 QImage MeanNoiseReductionFilter::setFilter(const QImage &image)
 {
-    int width = image.width();
-    int height = image.height();
-    QImage result(width, height, image.format());
-    int filterSize = sqrt((float)neighborghoodSize);
-    int bound = filterSize / 2;
-    QRgb pix;
-    int r, g, b;
-    for (int j = bound; j < height - bound; j++) {
-        for (int i = bound; i < width - bound; i++) {
-            r = g = b = 0;
-            for (int y = j - bound; y <= j + bound; y++) {
-                for (int x = i - bound; x <= i + bound; x++) {
-                    pix = image.pixel(x, y);
-                    r += qRed(pix);
-                    g += qGreen(pix);
-                    b += qBlue(pix);
-                }
-            }
-            result.setPixel(i, j, QColor(r / neighborghoodSize, g / neighborghoodSize, b / neighborghoodSize).rgb());
-            // qDebug((QString::number(redChannel.at(4))+" "+QString::number(greenChannel.at(4))+" "+QString::number(blueChannel.at(4))).toAscii());
-            // qDebug((QString::number(redChannel.size())+" "+QString::number(greenChannel.size())+" "+QString::number(blueChannel.size())).toAscii());
-        }
-    }
-    return result;
+    return YACReader::meanFilter(image, sqrt((float)neighborghoodSize));
 }
 
 //-----------------------------------------------------------------------------
@@ -169,36 +164,7 @@ MedianNoiseReductionFilter::MedianNoiseReductionFilter(enum NeighborghoodSize ns
 
 QImage MedianNoiseReductionFilter::setFilter(const QImage &image)
 {
-    int width = image.width();
-    int height = image.height();
-    QImage result(width, height, image.format());
-    int filterSize = sqrt((float)neighborghoodSize);
-    int bound = filterSize / 2;
-    QRgb pix;
-    QList<int> redChannel;
-    QList<int> greenChannel;
-    QList<int> blueChannel;
-    for (int j = bound; j < height - bound; j++) {
-        for (int i = bound; i < width - bound; i++) {
-            redChannel.clear();
-            greenChannel.clear();
-            blueChannel.clear();
-            for (int y = j - bound; y <= j + bound; y++) {
-                for (int x = i - bound; x <= i + bound; x++) {
-                    pix = image.pixel(x, y);
-                    redChannel.push_back(qRed(pix));
-                    greenChannel.push_back(qGreen(pix));
-                    blueChannel.push_back(qBlue(pix));
-                }
-            }
-
-            std::sort(redChannel.begin(), redChannel.end());
-            std::sort(greenChannel.begin(), greenChannel.end());
-            std::sort(blueChannel.begin(), blueChannel.end());
-            result.setPixel(i, j, QColor(redChannel.at(4), greenChannel.at(4), blueChannel.at(4)).rgb());
-        }
-    }
-    return result;
+    return YACReader::medianFilter(image, sqrt((float)neighborghoodSize));
 }
 
 //-----------------------------------------------------------------------------
@@ -208,6 +174,11 @@ BrightnessFilter::BrightnessFilter(int l)
     : ImageFilter()
 {
     level = l;
+    // -1 means the value from the settings, it is read once instead of on every page
+    if (level == -1) {
+        QSettings settings(YACReader::getSettingsPath() + "/YACReader.ini", QSettings::IniFormat);
+        level = settings.value(BRIGHTNESS, 0).toInt();
+    }
 }
 
 QImage BrightnessFilter::setFilter(const QImage &image)
@@ -222,12 +193,15 @@ QImage BrightnessFilter::setFilter(const QImage &image)
                 }
         }
         return result;*/
-    if (level == -1) {
-        QSettings settings(YACReader::getSettingsPath() + "/YACReader.ini", QSettings::IniFormat);
-        return changeBrightness(image, settings.value(BRIGHTNESS, 0).toInt());
-    } else {
-        return changeBrightness(image, level);
-    }
+    return applyTableFilter(this, image);
+}
+
+// brightness is multiplied by 100 in order to avoid floating point numbers
+bool BrightnessFilter::composeTable(uchar table[256])
+{
+    if (level != 0) // no change
+        ::composeTable<changeBrightness>(table, level);
+    return true;
 }
 
 //-----------------------------------------------------------------------------
@@ -237,6 +211,11 @@ ContrastFilter::ContrastFilter(int l)
     : ImageFilter()
 {
     level = l;
+    // -1 means the value from the settings, it is read once instead of on every page
+    if (level == -1) {
+        QSettings settings(YACReader::getSettingsPath() + "/YACReader.ini", QSettings::IniFormat);
+        level = settings.value(CONTRAST, 100).toInt();
+    }
 }
 
 QImage ContrastFilter::setFilter(const QImage &image)
@@ -297,12 +276,15 @@ QImage ContrastFilter::setFilter(const QImage &image)
         }
 
         return result;*/
-    if (level == -1) {
-        QSettings settings(YACReader::getSettingsPath() + "/YACReader.ini", QSettings::IniFormat);
-        return changeContrast(image, settings.value(CONTRAST, 100).toInt());
-    } else {
-        return changeContrast(image, level);
-    }
+    return applyTableFilter(this, image);
+}
+
+// contrast is multiplied by 100 in order to avoid floating point numbers
+bool ContrastFilter::composeTable(uchar table[256])
+{
+    if (level != 100) // no change
+        ::composeTable<changeContrast>(table, level);
+    return true;
 }
 //-----------------------------------------------------------------------------
 // ContrastFilter
@@ -311,54 +293,175 @@ GammaFilter::GammaFilter(int l)
     : ImageFilter()
 {
     level = l;
+    // -1 means the value from the settings, it is read once instead of on every page
+    if (level == -1) {
+        QSettings settings(YACReader::getSettingsPath() + "/YACReader.ini", QSettings::IniFormat);
+        level = settings.value(GAMMA, 100).toInt();
+    }
 }
 
 QImage GammaFilter::setFilter(const QImage &image)
 {
-    if (level == -1) {
-        QSettings settings(YACReader::getSettingsPath() + "/YACReader.ini", QSettings::IniFormat);
-        return changeGamma(image, settings.value(GAMMA, 100).toInt());
-    } else {
-        return changeGamma(image, level);
-    }
+    return applyTableFilter(this, image);
+}
+
+// gamma is multiplied by 100 in order to avoid floating point numbers
+bool GammaFilter::composeTable(uchar table[256])
+{
+    if (level != 100) // no change
+        ::composeTable<changeGamma>(table, level);
+    return true;
 }
 
 //-----------------------------------------------------------------------------
 // PageRender
 //-----------------------------------------------------------------------------
-PageRender::PageRender()
-    : QThread()
-{
-}
-PageRender::PageRender(Render *r, int np, const QByteArray &rd, QImage *p, unsigned int d, QVector<ImageFilter *> f)
-    : QThread(),
-      numPage(np),
+PageRender::PageRender(Render *r, int np, quint64 j, const QByteArray &rd, const QImage &i, unsigned int d, const QVector<ImageFilter *> &f)
+    : numPage(np),
+      job(j),
+      generation(0),
       data(rd),
-      page(p),
+      image(i),
       degrees(d),
-      filters(f),
       render(r)
 {
+    for (auto filter : f) {
+        filters.append(filter->clone());
+    }
+}
+
+PageRender::~PageRender()
+{
+    qDeleteAll(filters);
 }
 
-void PageRender::run()
+void PageRender::run(const PageRenderPool *pool)
 {
-    QMutexLocker locker(&(render->mutex));
+    QImage img = image;
+    if (img.isNull()) {
+        img.loadFromData(data);
+    }
+    if (pool->isStale(this)) {
+        return;
+    }
 
-    QImage img;
-    img.loadFromData(data);
     if (degrees > 0) {
         QTransform m;
         m.rotate(degrees);
         img = img.transformed(m, Qt::SmoothTransformation);
     }
-    for (int i = 0; i < filters.size(); i++) {
-        img = filters[i]->setFilter(img);
+    img = applyFilters(img, filters, [this, pool] { return pool->isStale(this); });
+    if (pool->isStale(this)) {
+        return;
+    }
+
+    auto r = render;
+    int page = numPage;
+    quint64 renderJob = job;
+    QMetaObject::invokeMethod(
+            render, [r, page, renderJob, img] { r->pageRendered(page, renderJob, img); }, Qt::QueuedConnection);
+}
+
+//-----------------------------------------------------------------------------
+// PageRenderPool
+//-----------------------------------------------------------------------------
+PageRenderPool::PageRenderPool(int threadCount)
+    : bailout(false), generation(0), windowFirst(0), windowLast(0), currentPage(0), readingForward(true)
+{
+    for (int i = 0; i < threadCount; i++) {
+        threads.emplace_back(&PageRenderPool::work, this);
+    }
+}
+
+PageRenderPool::~PageRenderPool()
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        bailout = true;
+        generation++;
     }
+    jobAvailable.notify_all();
 
-    *page = img;
+    for (auto &thread : threads) {
+        thread.join();
+    }
 
-    emit pageReady(numPage);
+    qDeleteAll(pending);
+}
+
+void PageRenderPool::enqueue(PageRender *page)
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        page->generation = generation;
+        pending.push_back(page);
+    }
+    jobAvailable.notify_one();
+}
+
+void PageRenderPool::setWindow(int first, int current, int last, bool forward)
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    windowFirst = first;
+    windowLast = last;
+    currentPage = current;
+    readingForward = forward;
+
+    for (auto it = pending.begin(); it != pending.end();) {
+        if ((*it)->getNumPage() < first || (*it)->getNumPage() > last) {
+            delete *it;
+            it = pending.erase(it);
+        } else {
+            ++it;
+        }
+    }
+}
+
+void PageRenderPool::cancelAll()
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    generation++;
+    qDeleteAll(pending);
+    pending.clear();
+}
+
+bool PageRenderPool::isStale(const PageRender *page) const
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    return page->generation != generation || page->getNumPage() < windowFirst || page->getNumPage() > windowLast;
+}
+
+// pages behind the reading direction are less likely to be needed soon
+int PageRenderPool::distance(int page) const
+{
+    int d = readingForward ? page - currentPage : currentPage - page;
+    return d >= 0 ? d : -2 * d;
+}
+
+void PageRenderPool::work()
+{
+    // the pages are rendered in parallel already, splitting them in bands would oversubscribe the CPU
+    YACReader::setSequentialRowBands(true);
+
+    while (true) {
+        PageRender *page;
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            jobAvailable.wait(lock, [this] { return bailout || !pending.empty(); });
+            if (bailout) {
+                return;
+            }
+
+            auto next = std::min_element(pending.begin(), pending.end(), [this](PageRender *a, PageRender *b) {
+                return distance(a->getNumPage()) < distance(b->getNumPage());
+            });
+            page = *next;
+            pending.erase(next);
+        }
+
+        page->run(this);
+        delete page;
+    }
 }
 
 //-----------------------------------------------------------------------------
@@ -366,15 +469,17 @@ void PageRender::run()
 //-----------------------------------------------------------------------------
 
 Render::Render()
-    : comic(nullptr), doublePage(false), doubleMangaPage(false), currentIndex(0), numLeftPages(4), numRightPages(4), loadedComic(false), imageRotation(0)
+    : comic(nullptr), doublePage(false), doubleMangaPage(false), currentIndex(0), numLeftPages(4), numRightPages(4), lastRenderJob(0), readingForward(true), loadedComic(false), imageRotation(0)
 {
     int size = numLeftPages + numRightPages + 1;
     currentPageBufferedIndex = numLeftPages;
     for (int i = 0; i < size; i++) {
         buffer.push_back(new QImage());
-        pageRenders.push_back(0);
     }
 
+    renderPool = new PageRenderPool(qBound(1, QThread::idealThreadCount(), 4));
+    pageCache = new PageCache(Configuration::getConfiguration().getRenderedPagesCacheSize() * 1024LL * 1024LL);
+
     filters.push_back(new BrightnessFilter());
     filters.push_back(new ContrastFilter());
     filters.push_back(new GammaFilter());
@@ -382,11 +487,9 @@ Render::Render()
 
 Render::~Render()
 {
-    for (auto *pr : pageRenders) {
-        if (pr != nullptr && pr->wait()) {
-            delete pr;
-        }
-    }
+    // the render threads send the pages to this object
+    delete renderPool;
+    delete pageCache;
 
     // TODO move to share_ptr
     for (auto *filter : filters) {
@@ -407,28 +510,14 @@ void Render::render()
 {
     updateBuffer();
     if (buffer[currentPageBufferedIndex]->isNull()) {
-        if (pagesReady.size() > 0) {
-            if (pagesReady[currentIndex]) {
-                pageRenders[currentPageBufferedIndex] = new PageRender(this, currentIndex, comic->getRawData()->at(currentIndex), buffer[currentPageBufferedIndex], imageRotation, filters);
-            } else
-                // las páginas no están listas, y se están cargando en el cómic
-                emit processingPage(); // para evitar confusiones esta señal debería llamarse de otra forma
-
-            // si se ha creado un hilo para renderizar la página actual, se arranca
-            if (pageRenders[currentPageBufferedIndex] != 0) {
-                // se conecta la señal pageReady del hilo, con el SLOT prepareAvailablePage
-                connect(pageRenders[currentPageBufferedIndex], &PageRender::pageReady, this, &Render::prepareAvailablePage);
-                // se emite la señal de procesando, debido a que los hilos se arrancan aquí
-                if (filters.size() > 0)
-                    emit processingPage();
-                pageRenders[currentPageBufferedIndex]->start();
-                pageRenders[currentPageBufferedIndex]->setPriority(QThread::TimeCriticalPriority);
-            } else
-                // en qué caso sería necesario hacer esto??? //TODO: IMPORTANTE, puede que no sea necesario.
-                emit processingPage();
-        } else
-            // no hay ninguna página lista para ser renderizada, es necesario esperar.
-            emit processingPage();
+        loadFromCache(currentIndex);
+    }
+    if (buffer[currentPageBufferedIndex]->isNull()) {
+        if (pagesReady.size() > 0 && pagesReady[currentIndex] && !pagesRendering.contains(currentIndex)) {
+            renderPage(currentIndex);
+        }
+        // la página se está renderizando o todavía se está cargando en el cómic
+        emit processingPage(); // para evitar confusiones esta señal debería llamarse de otra forma
     } else
     // la página actual está lista
     {
@@ -439,6 +528,83 @@ void Render::render()
     fillBuffer();
 }
 
+void Render::renderPage(int page)
+{
+    // pages rendered on demand can be released by the comic, it will announce them again
+    if (!comic->pageIsLoaded(page)) {
+        pagesReady[page] = false;
+        comic->requestPage(currentIndex);
+        return;
+    }
+
+    pagesRendering.insert(page, ++lastRenderJob);
+    // decoded pages (PDF) can be compressed at any time, getRawPage() reads their data safely
+    QImage decoded = comic->getDecodedPage(page);
+    renderPool->enqueue(new PageRender(this, page, lastRenderJob, decoded.isNull() ? comic->getRawPage(page) : QByteArray(), decoded, imageRotation, filters));
+}
+
+void Render::pageRendered(int page, quint64 job, const QImage &image)
+{
+    // the render was cancelled or it belongs to a page that has left the buffer
+    if (pagesRendering.value(page) != job) {
+        return;
+    }
+    pagesRendering.remove(page);
+
+    int bufferIndex = page - currentIndex + currentPageBufferedIndex;
+    if (bufferIndex < 0 || bufferIndex >= buffer.size()) {
+        return;
+    }
+
+    *buffer[bufferIndex] = image;
+    pageCache->insert(pageCacheKey(page), image);
+    prepareAvailablePage(page);
+}
+
+QString Render::pageCacheKey(int page)
+{
+    QVector<int> levels;
+    for (auto filter : filters) {
+        levels.append(filter->getLevel());
+    }
+    // decoded pages can be rendered again at a different resolution
+    QString comicKey = comicCacheKey;
+    QSize decodedSize = comic != nullptr ? comic->getDecodedPage(page).size() : QSize();
+    if (decodedSize.isValid()) {
+        comicKey += QString("@%1x%2").arg(decodedSize.width()).arg(decodedSize.height());
+    }
+    return PageCache::key(comicKey, page, imageRotation, levels);
+}
+
+bool Render::loadFromCache(int page)
+{
+    int bufferIndex = page - currentIndex + currentPageBufferedIndex;
+    if (bufferIndex < 0 || bufferIndex >= buffer.size()) {
+        return false;
+    }
+
+    return pageCache->find(pageCacheKey(page), *buffer[bufferIndex]);
+}
+
+PageCache::Stats Render::pageCacheStats()
+{
+    return pageCache->stats();
+}
+
+QString Render::pageKey(int page)
+{
+    return pageCacheKey(page);
+}
+
+QImage Render::getBufferedPage(int page)
+{
+    int bufferIndex = page - currentIndex + currentPageBufferedIndex;
+    if (bufferIndex < 0 || bufferIndex >= buffer.size()) {
+        return QImage();
+    }
+    return *buffer[bufferIndex];
+}
+
 QPixmap *Render::getCurrentPage()
 {
     auto page = new QPixmap();
@@ -694,6 +860,11 @@ void Render::createComic(const QString &path)
     previousIndex = currentIndex = 0;
     pagesEmited.clear();
 
+    auto stats = pageCache->stats();
+    QLOG_DEBUG() << "Rendered pages cache:" << stats.hits << "hits," << stats.misses << "misses," << stats.pages << "pages," << stats.usedBytes / (1024 * 1024) << "of" << stats.maxBytes / (1024 * 1024) << "MB";
+    // the modification time avoids showing old pages if the file has been replaced
+    comicCacheKey = path + "@" + QString::number(QFileInfo(path).lastModified().toMSecsSinceEpoch());
+
     if (comic != nullptr) {
         comic->invalidate();
         comic->disconnect();
@@ -709,6 +880,7 @@ void Render::createComic(const QString &path)
         reset();
         return;
     }
+    comic->setPageTargetSize(pageTargetSize);
 
     connect(comic, QOverload<>::of(&Comic::errorOpening), this, QOverload<>::of(&Render::errorOpening), Qt::QueuedConnection);
     connect(comic, QOverload<QString>::of(&Comic::errorOpening), this, QOverload<QString>::of(&Render::errorOpening), Qt::QueuedConnection);
@@ -765,6 +937,7 @@ void Render::startLoad()
 void Render::renderAt(int page)
 {
     previousIndex = currentIndex = page;
+    updateRenderWindow();
     emit pageChanged(page);
 }
 
@@ -866,7 +1039,7 @@ void Render::pageRawDataReady(int page)
         return;
 
     pagesEmited.push_back(page);
-    if (pageRenders.size() > 0) {
+    if (buffer.size() > 0) {
         for (int i = 0; i < pagesEmited.size(); i++) {
             if (pagesEmited.at(i) >= pagesReady.size()) {
                 pagesEmited.clear();
@@ -874,6 +1047,14 @@ void Render::pageRawDataReady(int page)
             }
 
             pagesReady[pagesEmited.at(i)] = true;
+            // decoded pages can be delivered again at a higher resolution, the buffered one is shown until it is replaced
+            int bufferIndex = pagesEmited.at(i) - currentIndex + currentPageBufferedIndex;
+            if (bufferIndex >= 0 && bufferIndex < buffer.size() && !buffer[bufferIndex]->isNull()) {
+                if (!comic->getDecodedPage(pagesEmited.at(i)).isNull()) {
+                    renderPage(pagesEmited.at(i));
+                }
+                continue;
+            }
             if (pagesEmited.at(i) == currentIndex)
                 update();
             else {
@@ -919,22 +1100,13 @@ void Render::rotateLeft()
 // Calcula el número de nuevas páginas que hay que buferear y si debe hacerlo por la izquierda o la derecha (según sea el sentido de la lectura)
 void Render::updateBuffer()
 {
-    QMutexLocker locker(&mutex);
     int windowSize = currentIndex - previousIndex;
 
     if (windowSize > 0) // add pages to right pages and remove on the left
     {
+        readingForward = true;
         windowSize = qMin(windowSize, buffer.size());
         for (int i = 0; i < windowSize; i++) {
-            // renders
-            PageRender *pr = pageRenders.front();
-            pageRenders.pop_front();
-            if (pr != nullptr) {
-                if (pr->wait())
-                    delete pr;
-            }
-            pageRenders.push_back(0);
-
             // images
 
             if (buffer.front() != 0)
@@ -945,18 +1117,10 @@ void Render::updateBuffer()
     } else // add pages to left pages and remove on the right
     {
         if (windowSize < 0) {
+            readingForward = false;
             windowSize = -windowSize;
             windowSize = qMin(windowSize, buffer.size());
             for (int i = 0; i < windowSize; i++) {
-                // renders
-                PageRender *pr = pageRenders.back();
-                pageRenders.pop_back();
-                if (pr != nullptr) {
-                    if (pr->wait())
-                        delete pr;
-                }
-                pageRenders.push_front(0);
-
                 // images
                 buffer.push_front(new QImage());
                 QImage *p = buffer.back();
@@ -967,6 +1131,34 @@ void Render::updateBuffer()
         }
     }
     previousIndex = currentIndex;
+
+    updateRenderWindow();
+}
+
+// renders of pages out of the buffer are cancelled without waiting for them
+void Render::updateRenderWindow()
+{
+    int first = currentIndex - currentPageBufferedIndex;
+    int last = first + buffer.size() - 1;
+    for (auto it = pagesRendering.begin(); it != pagesRendering.end();) {
+        if (it.key() < first || it.key() > last) {
+            it = pagesRendering.erase(it);
+        } else {
+            ++it;
+        }
+    }
+    renderPool->setWindow(first, currentIndex, last, readingForward);
+    if (comic != nullptr) {
+        comic->requestPage(currentIndex);
+    }
+}
+
+void Render::setPageTargetSize(const QSize &size)
+{
+    pageTargetSize = size;
+    if (comic != nullptr) {
+        comic->setPageTargetSize(size);
+    }
 }
 
 void Render::fillBuffer()
@@ -979,23 +1171,25 @@ void Render::fillBuffer()
         if ((currentIndex + i < (int)comic->numPages()) &&
             buffer[currentPageBufferedIndex + i]->isNull() &&
             i <= numRightPages &&
-            pageRenders[currentPageBufferedIndex + i] == 0 &&
-            pagesReady[currentIndex + i]) // preload next pages
+            !pagesRendering.contains(currentIndex + i)) // preload next pages
         {
-            pageRenders[currentPageBufferedIndex + i] = new PageRender(this, currentIndex + i, comic->getRawData()->at(currentIndex + i), buffer[currentPageBufferedIndex + i], imageRotation, filters);
-            connect(pageRenders[currentPageBufferedIndex + i], &PageRender::pageReady, this, &Render::prepareAvailablePage);
-            pageRenders[currentPageBufferedIndex + i]->start();
+            if (loadFromCache(currentIndex + i)) {
+                prepareAvailablePage(currentIndex + i);
+            } else if (pagesReady[currentIndex + i]) {
+                renderPage(currentIndex + i);
+            }
         }
 
         if ((currentIndex - i > 0) &&
             buffer[currentPageBufferedIndex - i]->isNull() &&
             i <= numLeftPages &&
-            pageRenders[currentPageBufferedIndex - i] == 0 &&
-            pagesReady[currentIndex - i]) // preload previous pages
+            !pagesRendering.contains(currentIndex - i)) // preload previous pages
         {
-            pageRenders[currentPageBufferedIndex - i] = new PageRender(this, currentIndex - i, comic->getRawData()->at(currentIndex - i), buffer[currentPageBufferedIndex - i], imageRotation, filters);
-            connect(pageRenders[currentPageBufferedIndex - i], &PageRender::pageReady, this, &Render::prepareAvailablePage);
-            pageRenders[currentPageBufferedIndex - i]->start();
+            if (loadFromCache(currentIndex - i)) {
+                prepareAvailablePage(currentIndex - i);
+            } else if (pagesReady[currentIndex - i]) {
+                renderPage(currentIndex - i);
+            }
         }
     }
 }
@@ -1004,13 +1198,9 @@ void Render::fillBuffer()
 // se terminan todos los hilos en ejecución y se libera la memoria (de hilos e imágenes)
 void Render::invalidate()
 {
-    for (int i = 0; i < pageRenders.size(); i++) {
-        if (pageRenders[i] != 0) {
-            pageRenders[i]->wait();
-            delete pageRenders[i];
-            pageRenders[i] = 0;
-        }
-    }
+    // running renders stop at their next step, the results that still arrive don't match any job in pagesRendering
+    renderPool->cancelAll();
+    pagesRendering.clear();
 
     for (int i = 0; i < buffer.size(); i++) {
         delete buffer[i];
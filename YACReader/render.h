@@ -7,7 +7,15 @@
 #include <QThread>
 #include <QByteArray>
 #include <QVector>
+#include <QHash>
+
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#include <vector>
+
 #include "comic.h"
+#include "page_cache.h"
 //-----------------------------------------------------------------------------
 // FILTERS
 //-----------------------------------------------------------------------------
@@ -24,6 +32,16 @@ public:
     ImageFilter() {};
     virtual ~ImageFilter() {};
     virtual QImage setFilter(const QImage &image) = 0;
+    // the renders use copies of the filters, so their levels can be changed while pages are being rendered
+    virtual ImageFilter *clone() const = 0;
+    // Filters that change each channel value independently of the rest of the image can be merged in a
+    // single lookup table. `table` maps 0-255 to the values after the previous filters, returns false if
+    // the filter can't be expressed as a table.
+    virtual bool composeTable(uchar table[256])
+    {
+        Q_UNUSED(table)
+        return false;
+    }
     inline int getLevel() { return level; };
     inline void setLevel(int l) { level = l; };
 
@@ -38,6 +56,7 @@ public:
                              LARGE = 25 };
     MeanNoiseReductionFilter(enum NeighborghoodSize ns = SMALL);
     QImage setFilter(const QImage &image) override;
+    ImageFilter *clone() const override { return new MeanNoiseReductionFilter(*this); }
 
 private:
     enum NeighborghoodSize neighborghoodSize;
@@ -50,6 +69,7 @@ public:
                              LARGE = 25 };
     MedianNoiseReductionFilter(enum NeighborghoodSize ns = SMALL);
     QImage setFilter(const QImage &image) override;
+    ImageFilter *clone() const override { return new MedianNoiseReductionFilter(*this); }
 
 private:
     enum NeighborghoodSize neighborghoodSize;
@@ -60,6 +80,8 @@ class BrightnessFilter : public ImageFilter
 public:
     BrightnessFilter(int l = -1);
     QImage setFilter(const QImage &image) override;
+    ImageFilter *clone() const override { return new BrightnessFilter(*this); }
+    bool composeTable(uchar table[256]) override;
 };
 
 class ContrastFilter : public ImageFilter
@@ -67,6 +89,8 @@ class ContrastFilter : public ImageFilter
 public:
     ContrastFilter(int l = -1);
     QImage setFilter(const QImage &image) override;
+    ImageFilter *clone() const override { return new ContrastFilter(*this); }
+    bool composeTable(uchar table[256]) override;
 };
 
 class GammaFilter : public ImageFilter
@@ -74,34 +98,70 @@ class GammaFilter : public ImageFilter
 public:
     GammaFilter(int l = -1);
     QImage setFilter(const QImage &image) override;
+    ImageFilter *clone() const override { return new GammaFilter(*this); }
+    bool composeTable(uchar table[256]) override;
 };
 
 //-----------------------------------------------------------------------------
 // RENDER
 //-----------------------------------------------------------------------------
 
-class PageRender : public QThread
+class PageRenderPool;
+
+// decodes, rotates and filters a page in a PageRenderPool thread, the result is sent back to Render in its own thread
+// pages that are already decoded (`image` isn't null) skip the decoding step. The filters are copied when the
+// render is created.
+class PageRender
 {
-    Q_OBJECT
 public:
-    PageRender();
-    PageRender(Render *render, int numPage, const QByteArray &rawData, QImage *page, unsigned int degrees = 0, QVector<ImageFilter *> filters = QVector<ImageFilter *>());
-    int getNumPage() { return numPage; };
-    void setData(const QByteArray &rawData) { data = rawData; };
-    void setPage(QImage *p) { page = p; };
-    void setRotation(unsigned int d) { degrees = d; };
-    void setFilters(QVector<ImageFilter *> f) { filters = f; };
+    PageRender(Render *render, int numPage, quint64 job, const QByteArray &rawData, const QImage &image, unsigned int degrees = 0, const QVector<ImageFilter *> &filters = QVector<ImageFilter *>());
+    ~PageRender();
+    int getNumPage() const { return numPage; };
+    void run(const PageRenderPool *pool);
 
 private:
     int numPage;
+    quint64 job;
+    quint64 generation;
     QByteArray data;
-    QImage *page;
+    QImage image;
     unsigned int degrees;
     QVector<ImageFilter *> filters;
-    void run() override;
     Render *render;
-signals:
-    void pageReady(int);
+
+    friend class PageRenderPool;
+};
+
+// Fixed set of threads rendering the pages buffered by Render. Pending pages are taken closest to the
+// current page first, in reading direction. Jobs for pages that leave the buffer window are dropped,
+// if they are already running they stop after their current step.
+class PageRenderPool
+{
+public:
+    explicit PageRenderPool(int threadCount);
+    ~PageRenderPool();
+
+    // takes ownership of `page`
+    void enqueue(PageRender *page);
+    void setWindow(int first, int current, int last, bool forward);
+    // drops all the pending jobs, the running ones stop after their current step and don't send their results
+    void cancelAll();
+    bool isStale(const PageRender *page) const;
+
+private:
+    std::vector<std::thread> threads;
+    std::vector<PageRender *> pending;
+    bool bailout;
+    quint64 generation;
+    int windowFirst;
+    int windowLast;
+    int currentPage;
+    bool readingForward;
+    mutable std::mutex mutex;
+    std::condition_variable jobAvailable;
+
+    void work();
+    int distance(int page) const;
 };
 //-----------------------------------------------------------------------------
 // RENDER
@@ -181,6 +241,13 @@ public slots:
     Bookmarks *getBookmarks();
     // sets the firt page to render
     void renderAt(int page);
+    // size (device pixels) pages are displayed at, comics rendering their pages on demand (PDF) use it as their resolution
+    void setPageTargetSize(const QSize &size);
+    PageCache::Stats pageCacheStats();
+    // identifies the contents of a rendered page (comic, page, rotation, filters)
+    QString pageKey(int page);
+    // the rendered page if it is in the buffer, a null image otherwise
+    QImage getBufferedPage(int page);
 
 signals:
     void currentPageReady();
@@ -209,8 +276,15 @@ private:
     int currentPageBufferedIndex;
     int numLeftPages;
     int numRightPages;
-    QList<PageRender *> pageRenders;
+    PageRenderPool *renderPool;
+    // render job in flight for each page
+    QHash<int, quint64> pagesRendering;
+    quint64 lastRenderJob;
+    bool readingForward;
     QList<QImage *> buffer;
+    PageCache *pageCache;
+    QString comicCacheKey;
+    QSize pageTargetSize;
     void loadAll();
     void updateRightPages();
     void updateLeftPages();
@@ -219,7 +293,12 @@ private:
     QVector<bool> pagesReady;
     int imageRotation;
     QVector<ImageFilter *> filters;
-    QMutex mutex;
+
+    void renderPage(int page);
+    QString pageCacheKey(int page);
+    bool loadFromCache(int page);
+    void updateRenderWindow();
+    void pageRendered(int page, quint64 job, const QImage &image);
 
     friend class PageRender;
 };
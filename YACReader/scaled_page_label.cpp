@@ -0,0 +1,111 @@
+#include "scaled_page_label.h"
+
+#include <QPaintEvent>
+#include <QPainter>
+
+#include "page_scaler.h"
+
+ScaledPageLabel::ScaledPageLabel(PageScaler *scaler, QWidget *parent)
+    : QLabel(parent), scaler(scaler)
+{
+    connect(scaler, &PageScaler::scaled, this, [this](const QString &key, const QSize &size, const QRect &tile) {
+        if (page.isNull() || key != this->key || size != scaledSize()) {
+            return;
+        }
+
+        if (tile.isNull()) {
+            update();
+        } else {
+            qreal dpr = devicePixelRatioF();
+            update(QRectF(tile.x() / dpr, tile.y() / dpr, tile.width() / dpr, tile.height() / dpr).toAlignedRect());
+        }
+    });
+}
+
+void ScaledPageLabel::setPage(const QPixmap &page, const QString &key)
+{
+    // the original page is still available with pixmap() (e.g. for the magnifying glass)
+    setPixmap(page);
+    this->page = page.toImage();
+    this->key = key;
+
+    // whatever was pending belongs to the previous page
+    scaler->cancelPending();
+    update();
+}
+
+void ScaledPageLabel::clearPage()
+{
+    page = QImage();
+    key.clear();
+}
+
+QSize ScaledPageLabel::scaledSize() const
+{
+    return (QSizeF(size()) * devicePixelRatioF()).toSize();
+}
+
+void ScaledPageLabel::paintEvent(QPaintEvent *event)
+{
+    if (page.isNull()) {
+        QLabel::paintEvent(event);
+        return;
+    }
+
+    QSize target = scaledSize();
+    if (target.isEmpty()) {
+        return;
+    }
+
+    // drawing without SmoothPixmapTransform is fast enough for the GUI thread, it is only used until
+    // the smooth version is ready
+    QPainter painter(this);
+    if (target == page.size()) {
+        painter.drawImage(rect(), page);
+        return;
+    }
+
+    if (target.height() <= PageScaler::tileHeight) {
+        QImage scaled;
+        if (scaler->find(key, target, QRect(), scaled)) {
+            painter.drawImage(rect(), scaled);
+        } else {
+            painter.drawImage(rect(), page);
+            scaler->request(key, page, target, QRect(), true);
+        }
+        return;
+    }
+
+    // tall pages: only the tiles under the painted area
+    qreal dpr = devicePixelRatioF();
+    qreal yFactor = qreal(page.height()) / target.height();
+    int lastTileInPage = (target.height() - 1) / PageScaler::tileHeight;
+    int firstTile = qBound(0, int(event->rect().top() * dpr) / PageScaler::tileHeight, lastTileInPage);
+    int lastTile = qBound(0, int((event->rect().bottom() + 1) * dpr) / PageScaler::tileHeight, lastTileInPage);
+
+    auto tileRect = [&](int index) {
+        int top = index * PageScaler::tileHeight;
+        return QRect(0, top, target.width(), qMin(PageScaler::tileHeight, target.height() - top));
+    };
+
+    for (int i = firstTile; i <= lastTile; i++) {
+        QRect tile = tileRect(i);
+        QRectF area(tile.x() / dpr, tile.y() / dpr, tile.width() / dpr, tile.height() / dpr);
+
+        QImage scaled;
+        if (scaler->find(key, target, tile, scaled)) {
+            painter.drawImage(area, scaled);
+        } else {
+            painter.drawImage(area, page, QRectF(0, tile.y() * yFactor, page.width(), tile.height() * yFactor));
+            scaler->request(key, page, target, tile, true);
+        }
+    }
+
+    // the tiles next to the visible ones are likely to be painted soon
+    if (lastTile < lastTileInPage) {
+        scaler->request(key, page, target, tileRect(lastTile + 1), false);
+    }
+    if (firstTile > 0) {
+        scaler->request(key, page, target, tileRect(firstTile - 1), false);
+    }
+}
@@ -0,0 +1,35 @@
+#ifndef SCALED_PAGE_LABEL_H
+#define SCALED_PAGE_LABEL_H
+
+#include <QLabel>
+#include <QImage>
+
+class PageScaler;
+
+// Label showing the current page at its size. The page is scaled by a PageScaler, while the smooth
+// version isn't ready the page is drawn with a fast transformation. Tall pages are scaled in tiles,
+// only the tiles that are painted are requested.
+// When there is no page (setPage() hasn't been called after clearPage()) it behaves as a regular QLabel.
+class ScaledPageLabel : public QLabel
+{
+    Q_OBJECT
+public:
+    ScaledPageLabel(PageScaler *scaler, QWidget *parent = nullptr);
+
+    // `key` identifies the contents of the page, it is used to find the scaled versions made ahead of time
+    void setPage(const QPixmap &page, const QString &key);
+    void clearPage();
+
+protected:
+    void paintEvent(QPaintEvent *event) override;
+
+private:
+    PageScaler *scaler;
+    QImage page;
+    QString key;
+
+    // size of the page in device pixels
+    QSize scaledSize() const;
+};
+
+#endif // SCALED_PAGE_LABEL_H
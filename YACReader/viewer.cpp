@@ -10,6 +10,8 @@
 #endif
 #include "bookmarks_dialog.h"
 #include "render.h"
+#include "page_scaler.h"
+#include "scaled_page_label.h"
 #include "goto_dialog.h"
 #include "translator.h"
 #include "page_label_widget.h"
@@ -47,7 +49,8 @@ Viewer::Viewer(QWidget *parent)
     translatorXPos = -10000;
     translator->move(-translator->width(), 10);
     // current comic page
-    content = new QLabel(this);
+    pageScaler = new PageScaler(this);
+    content = new ScaledPageLabel(pageScaler, this);
     configureContent(tr("Press 'O' to open comic."));
     // scroll area configuration
     setBackgroundRole(QPalette::Dark);
@@ -308,6 +311,8 @@ void Viewer::goTo(unsigned int page)
 void Viewer::updatePage()
 {
     QPixmap *previousPage = currentPage;
+    int index = render->getIndex();
+    QString pageKey = render->pageKey(index);
     if (doublePage) {
         if (!doubleMangaPage)
             currentPage = render->getCurrentDoublePage();
@@ -316,11 +321,13 @@ void Viewer::updatePage()
         }
         if (currentPage == nullptr) {
             currentPage = render->getCurrentPage();
+        } else {
+            pageKey += "+" + render->pageKey(index + 1) + (doubleMangaPage ? "m" : "");
         }
     } else {
         currentPage = render->getCurrentPage();
     }
-    content->setPixmap(*currentPage);
+    content->setPage(*currentPage, pageKey);
     updateContentSize();
     updateVerticalScrollBar();
 
@@ -345,50 +352,66 @@ void Viewer::updatePage()
 
 void Viewer::updateContentSize()
 {
+    render->setPageTargetSize(pageTargetSize());
+
     // there is an image to resize
     if (currentPage != nullptr && !currentPage->isNull()) {
-        QSize pagefit = currentPage->size();
-        bool stretchImages = Configuration::getConfiguration().getEnlargeImages();
-        YACReader::FitMode fitmode = Configuration::getConfiguration().getFitMode();
-        switch (fitmode) {
-        case YACReader::FitMode::FullRes:
-            break;
-        case YACReader::FitMode::ToWidth:
-            if (!stretchImages && width() > pagefit.width()) {
-                break;
-            }
-            pagefit.scale(width(), 0, Qt::KeepAspectRatioByExpanding);
-            break;
-        case YACReader::FitMode::ToHeight:
-            if (!stretchImages && height() > pagefit.height()) {
-                break;
-            }
-            pagefit.scale(0, height(), Qt::KeepAspectRatioByExpanding);
-            break;
-            // if everything fails showing the full page is a good idea
-        case YACReader::FitMode::FullPage:
-        default:
-            pagefit.scale(size(), Qt::KeepAspectRatio);
-            break;
-        }
+        // the content scales the page in a worker thread
+        content->resize(fitPageSize(currentPage->size(), pageFit()));
+        prefetchScaledPages();
+
+        emit backgroundChanges();
+    }
+    content->update(); // TODO, it shouldn't be neccesary
+}
+
+PageFit Viewer::pageFit()
+{
+    return { Configuration::getConfiguration().getFitMode(), size(), zoom, Configuration::getConfiguration().getEnlargeImages() };
+}
+
+// scales the pages that are likely to be shown next for the current fit mode and size
+void Viewer::prefetchScaledPages()
+{
+    // double pages are composed when they are shown
+    if (doublePage || !render->hasLoadedComic()) {
+        return;
+    }
 
-        if (zoom != 100) {
-            pagefit.scale(floor(pagefit.width() * zoom / 100.0f), 0, Qt::KeepAspectRatioByExpanding);
+    PageFit fit = pageFit();
+    int index = render->getIndex();
+    for (int page : { index + 1, index + 2, index - 1 }) {
+        QImage image = render->getBufferedPage(page);
+        if (image.isNull()) {
+            continue;
         }
-        // apply scaling
-        content->resize(pagefit);
-
-        // TODO: updtateContentSize should only scale the pixmap once
-        if (devicePixelRatioF() > 1) // only in HDPI displays
-        {
-            QPixmap page = currentPage->scaled(content->width() * devicePixelRatioF(), content->height() * devicePixelRatioF(), Qt::KeepAspectRatio, Qt::SmoothTransformation);
-            page.setDevicePixelRatio(devicePixelRatioF());
-            content->setPixmap(page);
+
+        QSize target = (QSizeF(fitPageSize(image.size(), fit)) * devicePixelRatioF()).toSize();
+        if (target == image.size()) {
+            continue;
         }
+        // tall pages are shown from the top
+        QRect tile = target.height() > PageScaler::tileHeight ? QRect(0, 0, target.width(), PageScaler::tileHeight) : QRect();
+        pageScaler->request(render->pageKey(page), image, target, tile, false);
+    }
+}
 
-        emit backgroundChanges();
+// size (in device pixels) pages need to be shown without enlarging them, it is used by the comics that render their pages (PDF)
+QSize Viewer::pageTargetSize()
+{
+    qreal scale = devicePixelRatioF() * zoom / 100.0;
+    int pageWidth = doublePage ? width() / 2 : width();
+    switch (Configuration::getConfiguration().getFitMode()) {
+    case YACReader::FitMode::FullRes:
+        return QSize();
+    case YACReader::FitMode::ToWidth:
+        return QSize(qCeil(pageWidth * scale), QWIDGETSIZE_MAX);
+    case YACReader::FitMode::ToHeight:
+        return QSize(QWIDGETSIZE_MAX, qCeil(height() * scale));
+    case YACReader::FitMode::FullPage:
+    default:
+        return QSize(qCeil(pageWidth * scale), qCeil(height() * scale));
     }
-    content->update(); // TODO, it shouldn't be neccesary
 }
 
 void Viewer::increaseZoomFactor()
@@ -939,6 +962,7 @@ void Viewer::setPageUnavailableMessage()
 
 void Viewer::configureContent(QString msg)
 {
+    content->clearPage();
     content->setSizePolicy(QSizePolicy::Ignored, QSizePolicy::Ignored);
     if (!(devicePixelRatioF() > 1))
         content->setScaledContents(true);
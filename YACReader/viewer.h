@@ -30,6 +30,9 @@ class GoToFlowWidget;
 class Bookmarks;
 class PageLabelWidget;
 class NotificationsLabelWidget;
+class PageScaler;
+class ScaledPageLabel;
+struct PageFit;
 
 class Viewer : public QScrollArea, public ScrollManagement
 {
@@ -139,7 +142,8 @@ private:
     bool drag;
 
     //! Widgets
-    QLabel *content;
+    ScaledPageLabel *content;
+    PageScaler *pageScaler;
 
     YACReaderTranslator *translator;
     int translatorXPos;
@@ -167,6 +171,9 @@ private:
 
     int verticalScrollStep() const;
     int horizontalScrollStep() const;
+    QSize pageTargetSize();
+    PageFit pageFit();
+    void prefetchScaledPages();
 
     //! ZigzagScroll
     enum scrollDirection { UP,
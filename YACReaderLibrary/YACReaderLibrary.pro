@@ -79,6 +79,7 @@ greaterThan(QT_MAJOR_VERSION, 5): QT += openglwidgets core5compat
 # Input
 HEADERS += comic_flow.h \
   ../common/concurrent_queue.h \
+  ../common/cover_loader.h \
   create_library_dialog.h \
   db/comic_query_result_processor.h \
   db/folder_query_result_processor.h \
@@ -102,18 +103,20 @@ HEADERS += comic_flow.h \
   comic_flow_widget.h \
   db_helper.h \
   ./db/data_base_management.h \
+  ./db/db_connection_pool.h \
+  ./db/remote_progress_sync.h \
   ./db/folder_item.h \
   ./db/folder_model.h \
   ./db/comic_model.h \
   ./db/comic_item.h \
   ../common/comic_db.h \
+  ../common/cover_store.h \
   ../common/folder.h \
   ../common/library_item.h \
   ../common/comic.h \
   ../common/bookmarks.h \
   ../common/pictureflow.h \
   ../common/release_acquire_atomic.h \
-  ../common/worker_thread.h \
   ../common/custom_widgets.h \
   ../common/qnaturalsorting.h \
   ../common/yacreader_global.h \
@@ -162,6 +165,7 @@ HEADERS += comic_flow.h \
 
 SOURCES += comic_flow.cpp \
     ../common/concurrent_queue.cpp \
+    ../common/cover_loader.cpp \
     create_library_dialog.cpp \
     db/comic_query_result_processor.cpp \
     db/folder_query_result_processor.cpp \
@@ -186,11 +190,14 @@ SOURCES += comic_flow.cpp \
     comic_flow_widget.cpp \
     db_helper.cpp \
     ./db/data_base_management.cpp \
+    ./db/db_connection_pool.cpp \
+    ./db/remote_progress_sync.cpp \
     ./db/folder_item.cpp \
     ./db/folder_model.cpp \
     ./db/comic_model.cpp \
     ./db/comic_item.cpp \
     ../common/comic_db.cpp \
+    ../common/cover_store.cpp \
     ../common/folder.cpp \
     ../common/library_item.cpp \
     ../common/comic.cpp \
@@ -314,10 +321,12 @@ win32 {
 QT += quick qml quickwidgets
 
 HEADERS += grid_comics_view.h \
-           comics_view_transition.h
+           comics_view_transition.h \
+           cover_image_provider.h
 
 SOURCES += grid_comics_view.cpp \
-           comics_view_transition.cpp
+           comics_view_transition.cpp \
+           cover_image_provider.cpp
 
 greaterThan(QT_MAJOR_VERSION, 5) {
     RESOURCES += qml6.qrc
@@ -1,12 +1,11 @@
 #include "comic_flow.h"
-#include "worker_thread.h"
+#include "cover_loader.h"
 
 #include "yacreader_global.h"
 
 ComicFlow::ComicFlow(QWidget *parent, FlowType flowType)
-    : YACReaderFlow(parent, flowType), worker(new WorkerThread<QImage>)
+    : YACReaderFlow(parent, flowType), loader(new YACReader::CoverLoader)
 {
-    resetWorkerIndex();
     connect(&updateTimer, &QTimer::timeout, this, &ComicFlow::updateImageData);
 
     connect(this, &PictureFlow::centerIndexChanged, this, &ComicFlow::preload);
@@ -42,7 +41,7 @@ void ComicFlow::setImagePaths(const QStringList &paths)
 
     setCenterIndex(0);
 
-    resetWorkerIndex();
+    loader->reset();
     preload();
 }
 
@@ -54,20 +53,20 @@ void ComicFlow::preload()
 
 void ComicFlow::updateImageData()
 {
-    // can't do anything, wait for the next possibility
-    if (worker->busy())
-        return;
-
-    // set image of last one
-    const int idx = workerIndex;
-    if (idx >= 0) {
-        const QImage result = worker->extractResult();
-        if (!result.isNull() && !imagesSetted[idx]) {
-            setSlide(idx, result);
+    // set the covers loaded since the last update
+    const auto covers = loader->takeLoaded();
+    for (const auto &cover : covers) {
+        const int idx = cover.index;
+        if (idx >= imagesLoaded.size() || imagesLoaded[idx])
+            continue;
+
+        // covers that can't be loaded keep the empty slide, they aren't requested again
+        if (!cover.image.isNull()) {
+            setSlide(idx, cover.image);
             imagesSetted[idx] = true;
-            numImagesLoaded++;
-            imagesLoaded[idx] = true;
         }
+        numImagesLoaded++;
+        imagesLoaded[idx] = true;
     }
 
     // try to load only few images on the left and right side
@@ -80,22 +79,22 @@ void ComicFlow::updateImageData()
         indexes[j * 2 + 1] = center + j + 1;
         indexes[j * 2 + 2] = center - j - 1;
     }
+    // the closest covers to the center are loaded first, decoded at the size of the slides
+    loader->setCoverWidth(slideSize().width());
+    QList<YACReader::CoverLoader::Request> requests;
     for (int c = 0; c < 2 * COUNT + 1; c++) {
         int i = indexes[c];
-        if ((i >= 0) && (i < slideCount()))
-            if (!imagesLoaded[i]) // slide(i).isNull())
-            {
-                // schedule thumbnail generation
-                QString fname = imageFiles[i];
-
-                workerIndex = i;
-                worker->performTask([fname] { return QImage { fname }; });
-                return;
-            }
+        if ((i >= 0) && (i < slideCount()) && !imagesLoaded[i])
+            requests.append({ i, imageFiles[i] });
     }
 
     // no need to generate anything? stop polling...
-    updateTimer.stop();
+    if (requests.isEmpty()) {
+        updateTimer.stop();
+        return;
+    }
+
+    loader->load(requests);
 }
 
 void ComicFlow::keyPressEvent(QKeyEvent *event)
@@ -122,7 +121,7 @@ void ComicFlow::removeSlide(int cover)
 
     YACReaderFlow::removeSlide(cover);
 
-    resetWorkerIndex();
+    loader->reset();
     preload();
 }
 
@@ -143,5 +142,6 @@ void ComicFlow::resortCovers(QList<int> newOrder)
     imagesLoaded = imagesLoadedNew;
     imagesSetted = imagesSettedNew;
 
-    resetWorkerIndex();
+    loader->reset();
+    preload();
 }
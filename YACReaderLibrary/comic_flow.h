@@ -11,8 +11,9 @@
 
 #include <memory>
 
-template<typename Result>
-class WorkerThread;
+namespace YACReader {
+class CoverLoader;
+}
 
 class ComicFlow : public YACReaderFlow
 {
@@ -32,15 +33,12 @@ private slots:
     void updateImageData();
 
 private:
-    void resetWorkerIndex() { workerIndex = -1; }
-
     QStringList imageFiles;
     QVector<bool> imagesLoaded;
     QVector<bool> imagesSetted;
     int numImagesLoaded;
-    int workerIndex;
     QTimer updateTimer;
-    std::unique_ptr<WorkerThread<QImage>> worker;
+    std::unique_ptr<YACReader::CoverLoader> loader;
     virtual void wheelEvent(QWheelEvent *event) override;
 };
 
@@ -0,0 +1,162 @@
+#include "cover_image_provider.h"
+
+#include "cover_store.h"
+
+#include <QCache>
+#include <QDateTime>
+#include <QFileInfo>
+#include <QImageReader>
+#include <QMutex>
+#include <QUrl>
+
+#include <algorithm>
+
+using namespace YACReader;
+
+namespace {
+
+// decoded covers shared by all the providers, the cost is in KB
+class CoverCache
+{
+public:
+    CoverCache()
+        : covers(maxCost) { }
+
+    QImage find(const QString &key)
+    {
+        QMutexLocker locker(&mutex);
+        auto cover = covers.object(key);
+        return cover != nullptr ? *cover : QImage();
+    }
+
+    void insert(const QString &key, const QImage &cover)
+    {
+        QMutexLocker locker(&mutex);
+        covers.insert(key, new QImage(cover), std::max(1, static_cast<int>(cover.sizeInBytes() / 1024)));
+    }
+
+private:
+    static constexpr int maxCost = 128 * 1024;
+
+    QMutex mutex;
+    QCache<QString, QImage> covers;
+};
+
+CoverCache &coverCache()
+{
+    static CoverCache cache;
+    return cache;
+}
+
+// the cover at `path` scaled to fill `requestedSize` (a 0 width or height means any), it is never scaled up.
+// Setting the scaled size lets the JPEG decoder use DCT scaling, so only a fraction of the cover is decoded.
+QImage decodeCover(const QString &path, const QSize &requestedSize)
+{
+    QImageReader reader(path);
+
+    QSize size = reader.size();
+    if (size.isValid()) {
+        qreal factor = 0;
+        if (requestedSize.width() > 0) {
+            factor = std::max(factor, static_cast<qreal>(requestedSize.width()) / size.width());
+        }
+        if (requestedSize.height() > 0) {
+            factor = std::max(factor, static_cast<qreal>(requestedSize.height()) / size.height());
+        }
+        if (factor > 0 && factor < 1) {
+            reader.setScaledSize(QSize(qRound(size.width() * factor), qRound(size.height() * factor)));
+        }
+    }
+
+    return reader.read();
+}
+
+class CoverImageResponse : public QQuickImageResponse, public QRunnable
+{
+public:
+    CoverImageResponse(const QString &path, const QString &key, const QSize &requestedSize)
+        : path(path), key(key), requestedSize(requestedSize), cancelled(false)
+    {
+        setAutoDelete(false);
+    }
+
+    void run() override
+    {
+        if (!cancelled) {
+            image = decodeCover(path, requestedSize);
+            if (!image.isNull()) {
+                coverCache().insert(key, image);
+            }
+        }
+
+        emit finished();
+    }
+
+    // finishes the response with a cover from the cache
+    void finish(const QImage &cover)
+    {
+        image = cover;
+        // the engine isn't listening yet, it connects to the response after requestImageResponse returns
+        QMetaObject::invokeMethod(this, "finished", Qt::QueuedConnection);
+    }
+
+    void cancel() override
+    {
+        cancelled = true;
+    }
+
+    QQuickTextureFactory *textureFactory() const override
+    {
+        return QQuickTextureFactory::textureFactoryForImage(image);
+    }
+
+    QString errorString() const override
+    {
+        return image.isNull() && !cancelled ? QStringLiteral("Unable to load the cover ") + path : QString();
+    }
+
+private:
+    QString path;
+    QString key;
+    QSize requestedSize;
+    QImage image;
+    std::atomic<bool> cancelled;
+};
+
+}
+
+CoverImageProvider::CoverImageProvider()
+    : nextPriority(0)
+{
+    pool.setMaxThreadCount(std::max(2, QThread::idealThreadCount() / 2));
+}
+
+CoverImageProvider::~CoverImageProvider()
+{
+    pool.waitForDone();
+}
+
+QQuickImageResponse *CoverImageProvider::requestImageResponse(const QString &id, const QSize &requestedSize)
+{
+    // <hash>/<percent encoded library data path>
+    int separator = id.indexOf('/');
+    QString hash = id.left(separator);
+    QString libraryDataPath = QUrl::fromPercentEncoding(id.mid(separator + 1).toUtf8());
+
+    bool anySize = requestedSize.width() <= 0 && requestedSize.height() <= 0;
+    QString path = CoverStore::forLibrary(libraryDataPath)->coverPath(hash, anySize ? CoverStore::Full : CoverStore::fittingSize(requestedSize));
+
+    // covers are written again when the cover page of a comic changes
+    QString key = QStringLiteral("%1@%2@%3x%4").arg(path).arg(QFileInfo(path).lastModified().toMSecsSinceEpoch()).arg(requestedSize.width()).arg(requestedSize.height());
+
+    auto response = new CoverImageResponse(path, key, requestedSize);
+
+    QImage cover = coverCache().find(key);
+    if (!cover.isNull()) {
+        response->finish(cover);
+    } else {
+        pool.start(response, nextPriority++);
+    }
+
+    return response;
+}
@@ -0,0 +1,33 @@
+#ifndef COVER_IMAGE_PROVIDER_H
+#define COVER_IMAGE_PROVIDER_H
+
+#include <QQuickAsyncImageProvider>
+#include <QThreadPool>
+
+#include <atomic>
+
+namespace YACReader {
+
+// Covers for the QML views, image://cover/<hash>/<percent encoded library data path>.
+//
+// Covers are decoded in a thread pool at the size requested by the Image (sourceSize), using the smallest stored
+// size of the cover that fills it (see CoverStore) and letting the JPEG decoder scale it down while decoding. The
+// decoded covers are kept in a cache shared by all the views, so scrolling back doesn't decode them again.
+// The newest requests are decoded first (they are the cells that just scrolled into view) and the requests of
+// the cells that scrolled away are cancelled by the engine.
+class CoverImageProvider : public QQuickAsyncImageProvider
+{
+public:
+    CoverImageProvider();
+    ~CoverImageProvider() override;
+
+    QQuickImageResponse *requestImageResponse(const QString &id, const QSize &requestedSize) override;
+
+private:
+    QThreadPool pool;
+    std::atomic<int> nextPriority;
+};
+
+}
+
+#endif // COVER_IMAGE_PROVIDER_H
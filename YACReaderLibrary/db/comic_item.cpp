@@ -1,45 +1,192 @@
 
-#include <QStringList>
+#include <QSqlQuery>
+#include <QSqlRecord>
+
+#include <algorithm>
+#include <numeric>
 
 #include "comic_item.h"
+#include "comic_model.h"
+#include "qnaturalsorting.h"
 
-//! [0]
-ComicItem::ComicItem(const QList<QVariant> &data)
+ComicItemList::ComicItemList()
+    : columns(0)
+{
+    strings.append(QString());
+}
 
+int ComicItemList::appendRows(QSqlQuery &sqlquery, int maxRows)
 {
-    itemData = data;
+    columns = sqlquery.record().count();
+    bool hasDate = columns > ComicModel::PublicationDate;
+
+    int appended = 0;
+    while ((maxRows < 0 || appended < maxRows) && sqlquery.next()) {
+        ComicItem item;
+
+        auto number = sqlquery.value(ComicModel::Number);
+        auto numPages = sqlquery.value(ComicModel::NumPages);
+
+        item.id = sqlquery.value(ComicModel::Id).toULongLong();
+        item.parentId = sqlquery.value(ComicModel::Parent_Id).toULongLong();
+        item.number = number.toInt();
+        item.numPages = numPages.toInt();
+        item.currentPage = sqlquery.value(ComicModel::CurrentPage).toInt();
+        item.rating = sqlquery.value(ComicModel::Rating).toInt();
+        item.title = intern(sqlquery.value(ComicModel::Title));
+        item.fileName = store(sqlquery.value(ComicModel::FileName));
+        item.path = store(sqlquery.value(ComicModel::Path));
+        item.hash = store(sqlquery.value(ComicModel::Hash));
+        item.date = hasDate ? intern(sqlquery.value(ComicModel::PublicationDate)) : 0;
+        item.flags = 0;
+        item.setFlag(ComicItem::HasNumber, !number.isNull());
+        item.setFlag(ComicItem::HasNumPages, !numPages.isNull());
+        item.setFlag(ComicItem::Read, sqlquery.value(ComicModel::ReadColumn).toBool());
+        item.setFlag(ComicItem::IsBis, sqlquery.value(ComicModel::IsBis).toBool());
+        item.setFlag(ComicItem::HasBeenOpened, sqlquery.value(ComicModel::HasBeenOpened).toBool());
+
+        rows.append(item);
+        appended++;
+    }
+
+    return appended;
 }
-//! [0]
 
-//! [1]
-ComicItem::~ComicItem()
+void ComicItemList::append(const ComicItemList &other)
 {
+    columns = std::max(columns, other.columns);
+    rows.reserve(rows.count() + other.rows.count());
+
+    for (auto item : other.rows) {
+        item.title = item.title != 0 ? intern(other.strings.at(item.title)) : 0;
+        item.fileName = item.fileName != 0 ? store(other.strings.at(item.fileName)) : 0;
+        item.path = item.path != 0 ? store(other.strings.at(item.path)) : 0;
+        item.hash = item.hash != 0 ? store(other.strings.at(item.hash)) : 0;
+        item.date = item.date != 0 ? intern(other.strings.at(item.date)) : 0;
+        rows.append(item);
+    }
 }
-//! [1]
 
-//! [5]
-int ComicItem::columnCount() const
+QVector<int> ComicItemList::sortByNumber()
 {
-    return itemData.count();
+    QVector<int> previousRows(rows.count());
+    std::iota(previousRows.begin(), previousRows.end(), 0);
+
+    std::stable_sort(previousRows.begin(), previousRows.end(), [this](int row1, int row2) {
+        return lessByNumber(rows.at(row1), rows.at(row2));
+    });
+    reorder(previousRows);
+
+    return previousRows;
 }
-//! [5]
 
-//! [6]
-QVariant ComicItem::data(int column) const
+QVector<int> ComicItemList::mergeByNumber(int firstRow)
 {
-    return itemData.value(column);
+    QVector<int> previousRows(rows.count());
+    std::iota(previousRows.begin(), previousRows.end(), 0);
+
+    std::inplace_merge(previousRows.begin(), previousRows.begin() + firstRow, previousRows.end(), [this](int row1, int row2) {
+        return lessByNumber(rows.at(row1), rows.at(row2));
+    });
+    reorder(previousRows);
+
+    return previousRows;
 }
-//! [6]
 
-void ComicItem::setData(int column, const QVariant &value)
+bool ComicItemList::lessByNumber(const ComicItem &c1, const ComicItem &c2) const
 {
-    itemData[column] = value;
+    bool hasNumber1 = c1.hasFlag(ComicItem::HasNumber);
+    bool hasNumber2 = c2.hasFlag(ComicItem::HasNumber);
+    if (!hasNumber1 && !hasNumber2) {
+        return naturalSortLessThanCI(strings.at(c1.fileName), strings.at(c2.fileName));
+    } else if (hasNumber1 && hasNumber2) {
+        return c1.number < c2.number;
+    } else {
+        return hasNumber1;
+    }
 }
 
-//! [8]
-int ComicItem::row() const
+void ComicItemList::reorder(const QVector<int> &previousRows)
 {
+    QVector<ComicItem> reordered;
+    reordered.reserve(rows.count());
+    for (int row : previousRows) {
+        reordered.append(rows.at(row));
+    }
+    rows.swap(reordered);
+}
 
-    return 0;
+void ComicItemList::clear()
+{
+    rows.clear();
+    strings.resize(1);
+    internedStrings.clear();
+    columns = 0;
+}
+
+QVariant ComicItemList::data(int row, int column) const
+{
+    const ComicItem &item = rows.at(row);
+    switch (column) {
+    case ComicModel::Number:
+        return item.hasFlag(ComicItem::HasNumber) ? QVariant(item.number) : QVariant();
+    case ComicModel::Title:
+        return item.title != 0 ? QVariant(strings.at(item.title)) : QVariant();
+    case ComicModel::FileName:
+        return item.fileName != 0 ? QVariant(strings.at(item.fileName)) : QVariant();
+    case ComicModel::NumPages:
+        return item.hasFlag(ComicItem::HasNumPages) ? QVariant(item.numPages) : QVariant();
+    case ComicModel::Id:
+        return QVariant(item.id);
+    case ComicModel::Parent_Id:
+        return QVariant(item.parentId);
+    case ComicModel::Path:
+        return item.path != 0 ? QVariant(strings.at(item.path)) : QVariant();
+    case ComicModel::Hash:
+        return item.hash != 0 ? QVariant(strings.at(item.hash)) : QVariant();
+    case ComicModel::ReadColumn:
+        return QVariant(item.hasFlag(ComicItem::Read));
+    case ComicModel::IsBis:
+        return QVariant(item.hasFlag(ComicItem::IsBis));
+    case ComicModel::CurrentPage:
+        return QVariant(item.currentPage);
+    case ComicModel::Rating:
+        return QVariant(item.rating);
+    case ComicModel::HasBeenOpened:
+        return QVariant(item.hasFlag(ComicItem::HasBeenOpened));
+    case ComicModel::PublicationDate:
+        return item.date != 0 ? QVariant(strings.at(item.date)) : QVariant();
+    default:
+        return QVariant();
+    }
+}
+
+quint32 ComicItemList::intern(const QVariant &value)
+{
+    return value.isNull() ? 0 : intern(value.toString());
+}
+
+quint32 ComicItemList::intern(const QString &string)
+{
+    auto interned = internedStrings.constFind(string);
+    if (interned != internedStrings.constEnd()) {
+        return interned.value();
+    }
+
+    quint32 index = strings.count();
+    strings.append(string);
+    internedStrings.insert(string, index);
+    return index;
+}
+
+quint32 ComicItemList::store(const QVariant &value)
+{
+    return value.isNull() ? 0 : store(value.toString());
+}
+
+quint32 ComicItemList::store(const QString &string)
+{
+    quint32 index = strings.count();
+    strings.append(string);
+    return index;
 }
-//! [8]
@@ -1,25 +1,89 @@
 #ifndef TABLEITEM_H
 #define TABLEITEM_H
 
-#include <QList>
+#include <QHash>
+#include <QString>
 #include <QVariant>
+#include <QVector>
 
-//! [0]
-class ComicItem : public QObject
+class QSqlQuery;
+
+// One row of ComicModel. Rows are plain records stored contiguously in a ComicItemList, the strings
+// are indexes into the string pool of the list (0 is the null string).
+struct ComicItem {
+    enum Flag : quint8 {
+        HasNumber = 0x01,
+        HasNumPages = 0x02,
+        Read = 0x04,
+        IsBis = 0x08,
+        HasBeenOpened = 0x10,
+    };
+
+    qulonglong id;
+    qulonglong parentId;
+    qint32 number;
+    qint32 numPages;
+    qint32 currentPage;
+    qint32 rating;
+    quint32 title;
+    quint32 fileName;
+    quint32 path;
+    quint32 hash;
+    quint32 date;
+    quint8 flags;
+
+    bool hasFlag(Flag flag) const { return (flags & flag) != 0; }
+    void setFlag(Flag flag, bool on) { flags = on ? (flags | flag) : (flags & ~flag); }
+};
+Q_DECLARE_TYPEINFO(ComicItem, Q_PRIMITIVE_TYPE);
+
+// Rows of a ComicModel. Loading a result set doesn't allocate anything per row but the strings,
+// repeated strings (titles, dates) are interned so they are stored once.
+class ComicItemList
 {
-    Q_OBJECT
 public:
-    ComicItem(const QList<QVariant> &data);
-    ~ComicItem() override;
-    int columnCount() const;
-    QVariant data(int column) const;
-    void setData(int column, const QVariant &value);
-    int row() const;
-    // unsigned long long int id; //TODO sustituir por una clase adecuada
-    // Comic comic;
+    ComicItemList();
+
+    // appends the rows of a query selecting the columns in ComicModel::Columns order (the last ones can be missing),
+    // up to `maxRows` rows if it isn't negative. Returns the number of rows appended.
+    int appendRows(QSqlQuery &sqlquery, int maxRows = -1);
+    // appends the rows of another list, its strings are added to the pool of this one
+    void append(const ComicItemList &other);
+    // sorts by number, comics without number go last sorted by file name. Rows that compare equal keep their
+    // order. Returns the previous row of every row.
+    QVector<int> sortByNumber();
+    // same as sortByNumber() when the rows before `firstRow` and the rows from `firstRow` on are already sorted,
+    // it only merges them
+    QVector<int> mergeByNumber(int firstRow);
+
+    int count() const { return rows.count(); }
+    bool isEmpty() const { return rows.isEmpty(); }
+    int columnCount() const { return columns; }
+    void clear();
+
+    const ComicItem &at(int row) const { return rows.at(row); }
+    ComicItem &operator[](int row) { return rows[row]; }
+    void move(int from, int to) { rows.move(from, to); }
+    void removeAt(int row) { rows.removeAt(row); }
+
+    const QString &string(quint32 index) const { return strings.at(index); }
+    // value of a ComicModel column, null for missing values
+    QVariant data(int row, int column) const;
+    qulonglong id(int row) const { return rows.at(row).id; }
+
 private:
-    QList<QVariant> itemData;
+    quint32 intern(const QVariant &value);
+    quint32 intern(const QString &string);
+    quint32 store(const QVariant &value);
+    quint32 store(const QString &string);
+    bool lessByNumber(const ComicItem &c1, const ComicItem &c2) const;
+    // rows[i] = previous rows[previousRows[i]]
+    void reorder(const QVector<int> &previousRows);
+
+    QVector<ComicItem> rows;
+    QVector<QString> strings;
+    QHash<QString, quint32> internedStrings;
+    int columns;
 };
-//! [0]
 
 #endif
@@ -9,6 +9,7 @@
 #include "data_base_management.h"
 #include "qnaturalsorting.h"
 #include "comic_db.h"
+#include "cover_store.h"
 #include "db_helper.h"
 #include "query_parser.h"
 #include "reading_list_model.h"
@@ -29,7 +30,6 @@ ComicModel::ComicModel(QSqlQuery &sqlquery, QObject *parent)
 
 ComicModel::~ComicModel()
 {
-    qDeleteAll(_data);
 }
 
 int ComicModel::columnCount(const QModelIndex &parent) const
@@ -37,7 +37,7 @@ int ComicModel::columnCount(const QModelIndex &parent) const
     Q_UNUSED(parent)
     if (_data.isEmpty())
         return 0;
-    return _data.first()->columnCount();
+    return _data.columnCount();
 }
 
 bool ComicModel::canDropMimeData(const QMimeData *data, Qt::DropAction action, int row, int column, const QModelIndex &parent) const
@@ -66,51 +66,42 @@ bool ComicModel::dropMimeData(const QMimeData *data, Qt::DropAction action, int
     QList<int> currentIndexes;
     int i;
     foreach (qulonglong id, comicIds) {
-        i = 0;
-        foreach (ComicItem *item, _data) {
-            if (item->data(Id) == id) {
+        for (i = 0; i < _data.count(); i++) {
+            if (_data.id(i) == id) {
                 currentIndexes << i;
                 break;
             }
-            i++;
         }
     }
 
     std::sort(currentIndexes.begin(), currentIndexes.end());
-    QList<ComicItem *> resortedData;
 
     if (currentIndexes.contains(row)) // no resorting
         return false;
 
-    ComicItem *destinationItem;
-    if (row == -1 || row >= _data.length())
-        destinationItem = 0;
+    int destinationRow;
+    if (row == -1 || row >= _data.count())
+        destinationRow = -1;
     else
-        destinationItem = _data.at(row);
+        destinationRow = row;
 
     QList<int> newSorting;
 
-    i = 0;
-    foreach (ComicItem *item, _data) {
+    for (i = 0; i < _data.count(); i++) {
         if (!currentIndexes.contains(i)) {
 
-            if (item == destinationItem) {
+            if (i == destinationRow) {
                 foreach (int index, currentIndexes) {
-                    resortedData << _data.at(index);
                     newSorting << index;
                 }
             }
 
-            resortedData << item;
             newSorting << i;
         }
-
-        i++;
     }
 
-    if (destinationItem == 0) {
+    if (destinationRow == -1) {
         foreach (int index, currentIndexes) {
-            resortedData << _data.at(index);
             newSorting << index;
         }
     }
@@ -123,9 +114,8 @@ bool ComicModel::dropMimeData(const QMimeData *data, Qt::DropAction action, int
         tempRow = _data.count();
 
     foreach (qulonglong id, comicIds) {
-        int i = 0;
-        foreach (ComicItem *item, _data) {
-            if (item->data(Id) == id) {
+        for (int i = 0; i < _data.count(); i++) {
+            if (_data.id(i) == id) {
                 beginMoveRows(parent, i, i, parent, tempRow);
 
                 bool skipElement = i == tempRow || i + 1 == tempRow;
@@ -144,14 +134,13 @@ bool ComicModel::dropMimeData(const QMimeData *data, Qt::DropAction action, int
 
                 break;
             }
-            i++;
         }
     }
 
     // TODO fix selection
     QList<qulonglong> allComicIds;
-    foreach (ComicItem *item, _data) {
-        allComicIds << item->data(Id).toULongLong();
+    for (int i = 0; i < _data.count(); i++) {
+        allComicIds << _data.id(i);
     }
     QString connectionName = "";
     {
@@ -176,7 +165,7 @@ bool ComicModel::dropMimeData(const QMimeData *data, Qt::DropAction action, int
     // endMoveRows();
 
     emit resortedIndexes(newSorting);
-    int destSelectedIndex = row < 0 ? _data.length() : row;
+    int destSelectedIndex = row < 0 ? _data.count() : row;
 
     if (destSelectedIndex > currentIndexes.at(0))
         emit newSelectedIndex(index(qMax(0, destSelectedIndex - 1), 0, parent));
@@ -239,6 +228,7 @@ QHash<int, QByteArray> ComicModel::roleNames() const
     roles[CoverPathRole] = "cover_path";
     roles[PublicationDate] = "date";
     roles[ReadableTitle] = "readable_title";
+    roles[CoverImageRole] = "cover_image";
 
     return roles;
 }
@@ -271,55 +261,60 @@ QVariant ComicModel::data(const QModelIndex &index, int role) const
     // TODO check here if any view is asking for TableModel::Roles
     // these roles will be used from QML/GridView
 
-    auto item = static_cast<ComicItem *>(index.internalPointer());
+    int row = index.row();
+    const ComicItem &item = _data.at(row);
+    const QString &title = _data.string(item.title != 0 ? item.title : item.fileName);
 
     if (role == NumberRole)
-        return item->data(Number);
+        return _data.data(row, Number);
     else if (role == TitleRole)
-        return item->data(Title).isNull() ? item->data(FileName) : item->data(Title);
+        return title;
     else if (role == ReadableTitle) {
-        QString title;
-        if (!item->data(Number).isNull()) {
-            title = title % "#" % item->data(Number).toString() % " ";
+        if (item.hasFlag(ComicItem::HasNumber)) {
+            return QString("#" % QString::number(item.number) % " " % title);
         }
-        return QVariant(title % (item->data(Title).isNull() ? item->data(FileName).toString() : item->data(Title).toString()));
+        return title;
     } else if (role == FileNameRole)
-        return item->data(FileName);
+        return _data.string(item.fileName);
     else if (role == RatingRole)
-        return item->data(Rating);
+        return item.rating;
     else if (role == CoverPathRole)
-        return getCoverUrlPathForComicHash(item->data(Hash).toString());
+        return YACReader::CoverStore::forLibrary(_databasePath)->coverUrl(_data.string(item.hash), YACReader::CoverStore::Grid);
+    else if (role == CoverImageRole) // image://cover/<hash>/<library data path>
+        return QUrl("image://cover/" % _data.string(item.hash) % "/" % QString::fromLatin1(QUrl::toPercentEncoding(_databasePath)));
     else if (role == NumPagesRole)
-        return item->data(NumPages);
+        return _data.data(row, NumPages);
     else if (role == CurrentPageRole)
-        return item->data(CurrentPage);
+        return item.currentPage;
     else if (role == ReadColumnRole)
-        return item->data(ReadColumn).toBool();
+        return item.hasFlag(ComicItem::Read);
     else if (role == HasBeenOpenedRole)
-        return item->data(ComicModel::HasBeenOpened);
+        return item.hasFlag(ComicItem::HasBeenOpened);
     else if (role == IdRole)
-        return item->data(Id);
+        return item.id;
     else if (role == PublicationDateRole)
-        return QVariant(localizedDate(item->data(PublicationDate).toString()));
+        return QVariant(localizedDate(_data.string(item.date)));
 
     if (role != Qt::DisplayRole)
         return QVariant();
 
-    if (index.column() == ComicModel::Hash)
-        return QString::number(item->data(index.column()).toString().right(item->data(index.column()).toString().length() - 40).toInt() / 1024.0 / 1024.0, 'f', 2) + "Mb";
+    if (index.column() == ComicModel::Hash) {
+        const QString &hash = _data.string(item.hash);
+        return QString::number(hash.mid(40).toInt() / 1024.0 / 1024.0, 'f', 2) + "Mb";
+    }
     if (index.column() == ComicModel::ReadColumn)
-        return (item->data(ComicModel::CurrentPage).toInt() == item->data(ComicModel::NumPages).toInt() || item->data(ComicModel::ReadColumn).toBool()) ? QVariant(tr("yes")) : QVariant(tr("no"));
+        return (item.currentPage == item.numPages || item.hasFlag(ComicItem::Read)) ? QVariant(tr("yes")) : QVariant(tr("no"));
     if (index.column() == ComicModel::CurrentPage)
-        return item->data(ComicModel::HasBeenOpened).toBool() ? item->data(index.column()) : QVariant("-");
+        return item.hasFlag(ComicItem::HasBeenOpened) ? QVariant(item.currentPage) : QVariant("-");
 
     if (index.column() == ComicModel::Rating)
         return QVariant();
 
     if (index.column() == ComicModel::PublicationDate) {
-        return QVariant(localizedDate(item->data(PublicationDate).toString()));
+        return QVariant(localizedDate(_data.string(item.date)));
     }
 
-    return item->data(index.column());
+    return _data.data(row, index.column());
 }
 
 Qt::ItemFlags ComicModel::flags(const QModelIndex &index) const
@@ -375,7 +370,9 @@ QVariant ComicModel::headerData(int section, Qt::Orientation orientation,
     }
 
     if (orientation == Qt::Vertical && role == Qt::DecorationRole) {
-        QString fileName = _data.value(section)->data(ComicModel::FileName).toString();
+        if (section < 0 || section >= _data.count())
+            return QVariant();
+        QString fileName = _data.string(_data.at(section).fileName);
         QFileInfo fi(fileName);
         QString ext = fi.suffix();
 
@@ -410,7 +407,7 @@ QModelIndex ComicModel::index(int row, int column, const QModelIndex &parent)
     if (!hasIndex(row, column, parent))
         return QModelIndex();
 
-    return createIndex(row, column, _data.at(row));
+    return createIndex(row, column);
 }
 
 QModelIndex ComicModel::parent(const QModelIndex &index) const
@@ -433,11 +430,9 @@ int ComicModel::rowCount(const QModelIndex &parent) const
 QStringList ComicModel::getPaths(const QString &_source)
 {
     QStringList paths;
-    QString source = _source + "/.yacreaderlibrary/covers/";
-    QList<ComicItem *>::ConstIterator itr;
-    for (itr = _data.constBegin(); itr != _data.constEnd(); itr++) {
-        QString hash = (*itr)->data(ComicModel::Hash).toString();
-        paths << source + hash + ".jpg";
+    auto covers = YACReader::CoverStore::forLibrary(_source + "/.yacreaderlibrary");
+    for (int i = 0; i < _data.count(); i++) {
+        paths << covers->coverPath(_data.string(_data.at(i).hash), YACReader::CoverStore::Flow);
     }
 
     return paths;
@@ -450,7 +445,6 @@ void ComicModel::setupFolderModelData(unsigned long long int folderId, const QSt
     sourceId = folderId;
 
     beginResetModel();
-    qDeleteAll(_data);
     _data.clear();
 
     _databasePath = databasePath;
@@ -477,7 +471,6 @@ void ComicModel::setupLabelModelData(unsigned long long parentLabel, const QStri
     sourceId = parentLabel;
 
     beginResetModel();
-    qDeleteAll(_data);
     _data.clear();
 
     _databasePath = databasePath;
@@ -505,7 +498,6 @@ void ComicModel::setupReadingListModelData(unsigned long long parentReadingList,
     sourceId = parentReadingList;
 
     beginResetModel();
-    qDeleteAll(_data);
     _data.clear();
 
     _databasePath = databasePath;
@@ -538,12 +530,7 @@ void ComicModel::setupReadingListModelData(unsigned long long parentReadingList,
             selectQuery.exec();
 
             // TODO, extra information is needed (resorting)
-            QList<ComicItem *> tempData = _data;
-            _data.clear();
-
             setupModelDataForList(selectQuery);
-
-            _data = tempData << _data;
         }
         connectionName = db.connectionName();
     }
@@ -558,7 +545,6 @@ void ComicModel::setupFavoritesModelData(const QString &databasePath)
     sourceId = -1;
 
     beginResetModel();
-    qDeleteAll(_data);
     _data.clear();
 
     _databasePath = databasePath;
@@ -587,7 +573,6 @@ void ComicModel::setupReadingModelData(const QString &databasePath)
     sourceId = -1;
 
     beginResetModel();
-    qDeleteAll(_data);
     _data.clear();
 
     _databasePath = databasePath;
@@ -608,21 +593,48 @@ void ComicModel::setupReadingModelData(const QString &databasePath)
     endResetModel();
 }
 
-void ComicModel::setModelData(QList<ComicItem *> *data, const QString &databasePath)
+void ComicModel::setModelData(ComicItemList *data, const QString &databasePath)
 {
     _databasePath = databasePath;
 
     beginResetModel();
 
-    qDeleteAll(_data);
+    _data = std::move(*data);
 
-    _data.clear();
+    endResetModel();
 
-    _data.append(*data);
+    emit searchNumResults(_data.count());
 
-    endResetModel();
+    delete data;
+}
+
+void ComicModel::appendModelData(ComicItemList *data)
+{
+    if (!data->isEmpty()) {
+        int firstNewRow = _data.count();
+
+        beginInsertRows(QModelIndex(), _data.count(), _data.count() + data->count() - 1);
+        _data.append(*data);
+        endInsertRows();
+
+        // the results come in pages in no particular order, the new rows are moved to their place in the whole
+        // result instead of sorting every page on its own
+        emit layoutAboutToBeChanged();
+        auto previousRows = _data.mergeByNumber(firstNewRow);
+        QVector<int> newRows(previousRows.size());
+        for (int row = 0; row < previousRows.size(); row++) {
+            newRows[previousRows.at(row)] = row;
+        }
+        const auto persistentIndexes = persistentIndexList();
+        QModelIndexList movedIndexes;
+        for (const auto &index : persistentIndexes) {
+            movedIndexes.append(index.isValid() ? createIndex(newRows.at(index.row()), index.column()) : index);
+        }
+        changePersistentIndexList(persistentIndexes, movedIndexes);
+        emit layoutChanged();
 
-    emit searchNumResults(_data.length());
+        emit searchNumResults(_data.count());
+    }
 
     delete data;
 }
@@ -630,48 +642,20 @@ void ComicModel::setModelData(QList<ComicItem *> *data, const QString &databaseP
 QString ComicModel::getComicPath(QModelIndex mi)
 {
     if (mi.isValid())
-        return _data.at(mi.row())->data(ComicModel::Path).toString();
+        return _data.string(_data.at(mi.row()).path);
     return "";
 }
 
 void ComicModel::setupModelData(QSqlQuery &sqlquery)
 {
-    int numColumns = sqlquery.record().count();
-
-    while (sqlquery.next()) {
-        QList<QVariant> data;
-
-        for (int i = 0; i < numColumns; i++)
-            data << sqlquery.value(i);
-
-        _data.append(new ComicItem(data));
-    }
-
-    std::sort(_data.begin(), _data.end(), [](const ComicItem *c1, const ComicItem *c2) {
-        if (c1->data(ComicModel::Number).isNull() && c2->data(ComicModel::Number).isNull()) {
-            return naturalSortLessThanCI(c1->data(ComicModel::FileName).toString(), c2->data(ComicModel::FileName).toString());
-        } else {
-            if (c1->data(ComicModel::Number).isNull() == false && c2->data(ComicModel::Number).isNull() == false) {
-                return c1->data(ComicModel::Number).toInt() < c2->data(ComicModel::Number).toInt();
-            } else {
-                return c2->data(ComicModel::Number).isNull();
-            }
-        }
-    });
+    _data.appendRows(sqlquery);
+    _data.sortByNumber();
 }
 
 // comics are sorted by "ordering", the sorting is done in the sql query
 void ComicModel::setupModelDataForList(QSqlQuery &sqlquery)
 {
-    int numColumns = sqlquery.record().count();
-
-    while (sqlquery.next()) {
-        QList<QVariant> data;
-        for (int i = 0; i < numColumns; i++)
-            data << sqlquery.value(i);
-
-        _data.append(new ComicItem(data));
-    }
+    _data.appendRows(sqlquery);
 }
 
 ComicDB ComicModel::getComic(const QModelIndex &mi)
@@ -681,7 +665,7 @@ ComicDB ComicModel::getComic(const QModelIndex &mi)
     {
         QSqlDatabase db = DataBaseManagement::loadDatabase(_databasePath);
         bool found;
-        c = DBHelper::loadComic(_data.at(mi.row())->data(ComicModel::Id).toULongLong(), db, found);
+        c = DBHelper::loadComic(_data.id(mi.row()), db, found);
         connectionName = db.connectionName();
     }
     QSqlDatabase::removeDatabase(connectionName);
@@ -696,7 +680,7 @@ ComicDB ComicModel::_getComic(const QModelIndex &mi)
     {
         QSqlDatabase db = DataBaseManagement::loadDatabase(_databasePath);
         bool found;
-        c = DBHelper::loadComic(_data.at(mi.row())->data(ComicModel::Id).toULongLong(), db, found);
+        c = DBHelper::loadComic(_data.id(mi.row()), db, found);
         connectionName = db.connectionName();
     }
     QSqlDatabase::removeDatabase(connectionName);
@@ -709,11 +693,12 @@ QVector<YACReaderComicReadStatus> ComicModel::getReadList()
     int numComics = _data.count();
     QVector<YACReaderComicReadStatus> readList(numComics);
     for (int i = 0; i < numComics; i++) {
-        if (_data.value(i)->data(ComicModel::ReadColumn).toBool())
+        const ComicItem &item = _data.at(i);
+        if (item.hasFlag(ComicItem::Read))
             readList[i] = YACReader::Read;
-        else if (_data.value(i)->data(ComicModel::CurrentPage).toInt() == _data.value(i)->data(ComicModel::NumPages).toInt())
+        else if (item.currentPage == item.numPages)
             readList[i] = YACReader::Read;
-        else if (_data.value(i)->data(ComicModel::HasBeenOpened).toBool())
+        else if (item.hasFlag(ComicItem::HasBeenOpened))
             readList[i] = YACReader::Opened;
         else
             readList[i] = YACReader::Unread;
@@ -737,7 +722,7 @@ QList<ComicDB> ComicModel::getAllComics()
         int numComics = _data.count();
         for (int i = 0; i < numComics; i++) {
             bool found;
-            comics.append(DBHelper::loadComic(_data.value(i)->data(ComicModel::Id).toULongLong(), db, found));
+            comics.append(DBHelper::loadComic(_data.id(i), db, found));
         }
 
         db.commit();
@@ -764,19 +749,20 @@ QVector<YACReaderComicReadStatus> ComicModel::setComicsRead(QList<QModelIndex> l
         QSqlDatabase db = DataBaseManagement::loadDatabase(_databasePath);
         db.transaction();
         foreach (QModelIndex mi, list) {
+            ComicItem &item = _data[mi.row()];
             if (read == YACReader::Read) {
-                _data.value(mi.row())->setData(ComicModel::ReadColumn, QVariant(true));
+                item.setFlag(ComicItem::Read, true);
                 bool found;
-                ComicDB c = DBHelper::loadComic(_data.value(mi.row())->data(ComicModel::Id).toULongLong(), db, found);
+                ComicDB c = DBHelper::loadComic(item.id, db, found);
                 c.info.read = true;
                 DBHelper::update(&(c.info), db);
             }
             if (read == YACReader::Unread) {
-                _data.value(mi.row())->setData(ComicModel::ReadColumn, QVariant(false));
-                _data.value(mi.row())->setData(ComicModel::CurrentPage, QVariant(1));
-                _data.value(mi.row())->setData(ComicModel::HasBeenOpened, QVariant(false));
+                item.setFlag(ComicItem::Read, false);
+                item.currentPage = 1;
+                item.setFlag(ComicItem::HasBeenOpened, false);
                 bool found;
-                ComicDB c = DBHelper::loadComic(_data.value(mi.row())->data(ComicModel::Id).toULongLong(), db, found);
+                ComicDB c = DBHelper::loadComic(item.id, db, found);
                 c.info.read = false;
                 c.info.currentPage = 1;
                 c.info.hasBeenOpened = false;
@@ -802,7 +788,7 @@ void ComicModel::setComicsManga(QList<QModelIndex> list, bool isManga)
         db.transaction();
         foreach (QModelIndex mi, list) {
             bool found;
-            ComicDB c = DBHelper::loadComic(_data.value(mi.row())->data(ComicModel::Id).toULongLong(), db, found);
+            ComicDB c = DBHelper::loadComic(_data.id(mi.row()), db, found);
             c.info.manga = isManga;
             DBHelper::update(&(c.info), db);
         }
@@ -819,11 +805,11 @@ qint64 ComicModel::asignNumbers(QList<QModelIndex> list, int startingNumber)
     {
         QSqlDatabase db = DataBaseManagement::loadDatabase(_databasePath);
         db.transaction();
-        idFirst = _data.value(list[0].row())->data(ComicModel::Id).toULongLong();
+        idFirst = _data.id(list[0].row());
         int i = 0;
         foreach (QModelIndex mi, list) {
             bool found;
-            ComicDB c = DBHelper::loadComic(_data.value(mi.row())->data(ComicModel::Id).toULongLong(), db, found);
+            ComicDB c = DBHelper::loadComic(_data.id(mi.row()), db, found);
             c.info.number = startingNumber + i;
             c.info.edited = true;
             DBHelper::update(&(c.info), db);
@@ -839,12 +825,10 @@ qint64 ComicModel::asignNumbers(QList<QModelIndex> list, int startingNumber)
 }
 QModelIndex ComicModel::getIndexFromId(quint64 id)
 {
-    QList<ComicItem *>::ConstIterator itr;
-    int i = 0;
-    for (itr = _data.constBegin(); itr != _data.constEnd(); itr++) {
-        if ((*itr)->data(ComicModel::Id).toULongLong() == id)
+    int i;
+    for (i = 0; i < _data.count(); i++) {
+        if (_data.id(i) == id)
             break;
-        i++;
     }
 
     return index(i, 0);
@@ -880,12 +864,11 @@ void ComicModel::removeInTransaction(int row)
 {
     auto dbTransaction = QSqlDatabase::database(_databaseConnection);
     bool found;
-    ComicDB c = DBHelper::loadComic(_data.at(row)->data(ComicModel::Id).toULongLong(), dbTransaction, found);
+    ComicDB c = DBHelper::loadComic(_data.id(row), dbTransaction, found);
 
     DBHelper::removeFromDB(&c, dbTransaction);
     beginRemoveRows(QModelIndex(), row, row);
     removeRow(row);
-    delete _data.at(row);
     _data.removeAt(row);
 
     endRemoveRows();
@@ -924,17 +907,17 @@ void ComicModel::remove(int row)
 
 void ComicModel::reload(const ComicDB &comic)
 {
-    int row = 0;
+    int row;
     bool found = false;
-    foreach (ComicItem *item, _data) {
-        if (item->data(ComicModel::Id).toULongLong() == comic.id) {
+    for (row = 0; row < _data.count(); row++) {
+        if (_data.id(row) == comic.id) {
             found = true;
-            item->setData(ComicModel::ReadColumn, comic.info.read);
-            item->setData(ComicModel::CurrentPage, comic.info.currentPage);
-            item->setData(ComicModel::HasBeenOpened, true);
+            ComicItem &item = _data[row];
+            item.setFlag(ComicItem::Read, comic.info.read);
+            item.currentPage = comic.info.currentPage;
+            item.setFlag(ComicItem::HasBeenOpened, true);
             break;
         }
-        row++;
     }
     if (found)
         emit dataChanged(index(row, ReadColumn), index(row, HasBeenOpened), QVector<int>() << ReadColumnRole << CurrentPageRole << HasBeenOpenedRole);
@@ -948,7 +931,7 @@ void ComicModel::resetComicRating(const QModelIndex &mi)
         QSqlDatabase db = DataBaseManagement::loadDatabase(_databasePath);
 
         comic.info.rating = 0;
-        _data[mi.row()]->setData(ComicModel::Rating, 0);
+        _data[mi.row()].rating = 0;
         DBHelper::update(&(comic.info), db);
 
         emit dataChanged(mi, mi);
@@ -959,7 +942,7 @@ void ComicModel::resetComicRating(const QModelIndex &mi)
 
 QUrl ComicModel::getCoverUrlPathForComicHash(const QString &hash) const
 {
-    return QUrl("file:" + _databasePath + "/covers/" + hash + ".jpg");
+    return YACReader::CoverStore::forLibrary(_databasePath)->coverUrl(hash);
 }
 
 void ComicModel::addComicsToFavorites(const QList<qulonglong> &comicIds)
@@ -1114,7 +1097,7 @@ bool ComicModel::isFavorite(const QModelIndex &index)
     {
         QSqlDatabase db = DataBaseManagement::loadDatabase(_databasePath);
 
-        isFavorite = DBHelper::isFavoriteComic(_data[index.row()]->data(Id).toLongLong(), db);
+        isFavorite = DBHelper::isFavoriteComic(_data.id(index.row()), db);
         connectionName = db.connectionName();
     }
     QSqlDatabase::removeDatabase(connectionName);
@@ -1131,7 +1114,7 @@ void ComicModel::updateRating(int rating, QModelIndex mi)
         // TODO optimize update
 
         comic.info.rating = rating;
-        _data[mi.row()]->setData(ComicModel::Rating, rating);
+        _data[mi.row()].rating = rating;
         DBHelper::update(&(comic.info), db);
 
         emit dataChanged(mi, mi);
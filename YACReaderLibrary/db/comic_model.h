@@ -9,11 +9,10 @@
 #include <QUrl>
 
 #include "yacreader_global_gui.h"
+#include "comic_item.h"
 
 class ComicDB;
 
-class ComicItem;
-
 using namespace YACReader;
 
 class ComicModel : public QAbstractItemModel
@@ -55,6 +54,7 @@ public:
         CoverPathRole,
         PublicationDateRole,
         ReadableTitle,
+        CoverImageRole, // cover url for CoverImageProvider
     };
 
     enum Mode {
@@ -147,14 +147,17 @@ public slots:
     void addComicsToLabel(const QList<qulonglong> &comicIds, qulonglong labelId);
     void addComicsToReadingList(const QList<qulonglong> &comicIds, qulonglong readingListId);
 
-    void setModelData(QList<ComicItem *> *data, const QString &databasePath);
+    void setModelData(ComicItemList *data, const QString &databasePath);
+    // adds the next page of search results, `data` is deleted. The rows of the model and of `data` are sorted by
+    // number, the new rows are merged in their place
+    void appendModelData(ComicItemList *data);
 
 protected:
 private:
     void setupModelData(QSqlQuery &sqlquery);
     void setupModelDataForList(QSqlQuery &sqlquery);
     ComicDB _getComic(const QModelIndex &mi);
-    QList<ComicItem *> _data;
+    ComicItemList _data;
 
     QString _databasePath;
     QString _databaseConnection;
@@ -3,83 +3,154 @@
 #include "comic_item.h"
 #include "comic_model.h"
 #include "data_base_management.h"
+#include "db_connection_pool.h"
 #include "qnaturalsorting.h"
 #include "db_helper.h"
 #include "query_parser.h"
 
+#include <QSqlError>
+
 #include "QsLog.h"
 
 YACReader::ComicQueryResultProcessor::ComicQueryResultProcessor()
-    : querySearchQueue(1)
+    : querySearchQueue(1), currentSearch(0), previousResultsComplete(false)
 {
 }
 
-void YACReader::ComicQueryResultProcessor::createModelData(const QString &filter, const QString &databasePath)
+void YACReader::ComicQueryResultProcessor::createModelData(const QString &filter, const QString &databasePath, int limit)
 {
     querySearchQueue.cancelPending();
+    auto search = ++currentSearch;
 
     querySearchQueue.enqueue([=] {
-        QString connectionName = "";
-        {
-            QSqlDatabase db = DataBaseManagement::loadDatabase(databasePath);
-            QSqlQuery selectQuery(db);
+        // Qt doesn't give access to sqlite3_interrupt, so an outdated search is stopped between pages of results.
+        // The query isn't sorted, SQLite finds the rows of every page as they are read instead of finding and
+        // sorting all of them before returning the first one.
+        auto cancelled = [=] { return search != currentSearch; };
 
-            std::string queryString("SELECT ci.number,ci.title,c.fileName,ci.numPages,c.id,c.parentId,c.path,ci.hash,ci.read,ci.isBis,ci.currentPage,ci.rating,ci.hasBeenOpened "
-                                    "FROM comic c INNER JOIN comic_info ci ON (c.comicInfoId = ci.id) LEFT JOIN folder f ON (f.id == c.parentId) WHERE ");
+        if (cancelled()) {
+            return;
+        }
 
-            try {
-                QueryParser parser;
-                auto result = parser.parse(filter.toStdString());
-                result.buildSqlString(queryString);
+        DBConnectionPool::Connection connection(databasePath);
+        auto &db = connection.database();
+        QSqlQuery selectQuery(db);
+        selectQuery.setForwardOnly(true);
+
+        std::string queryString("SELECT ci.number,ci.title,c.fileName,ci.numPages,c.id,c.parentId,c.path,ci.hash,ci.read,ci.isBis,ci.currentPage,ci.rating,ci.hasBeenOpened "
+                                "FROM comic c INNER JOIN comic_info ci ON (c.comicInfoId = ci.id) LEFT JOIN folder f ON (f.id == c.parentId) WHERE (");
+
+        try {
+            QueryParser parser(DataBaseManagement::hasSearchIndex(db));
+            auto result = parser.parse(filter.toStdString());
+            result.buildSqlString(queryString);
+            queryString += ")";
+
+            // typing usually narrows the previous search, if it got all its results there is no need to look
+            // for comics outside of them
+            if (previousResultsComplete && previousDatabasePath == databasePath) {
+                try {
+                    if (result.narrows(parser.parse(previousFilter.toStdString())) && storePreviousResults(db)) {
+                        queryString += " AND c.id IN (SELECT id FROM temp.previous_search_results)";
+                    }
+                } catch (const std::exception &e) {
+                }
+            }
 
-                queryString += " LIMIT :limit";
+            queryString += " LIMIT :limit";
 
-                selectQuery.prepare(queryString.c_str());
-                selectQuery.bindValue(":limit", 500); // TODO, load this value from settings
-                result.bindValues(selectQuery);
+            selectQuery.prepare(queryString.c_str());
+            selectQuery.bindValue(":limit", limit);
+            result.bindValues(selectQuery);
 
-                selectQuery.exec();
+            selectQuery.exec();
 
-                auto data = modelData(selectQuery);
+            // the first page is shown as soon as possible, the rest of the results are added in bigger pages
+            auto data = modelData(selectQuery, firstPageSize);
+            int count = data->count();
+            QVector<qulonglong> results;
+            for (int i = 0; i < data->count(); i++) {
+                results.append(data->id(i));
+            }
 
-                emit newData(data, databasePath);
-            } catch (const std::exception &e) {
-                // Do nothing, uncomplete search string will end here and it is part of how the QueryParser works
-                // I don't like the idea of using exceptions for this though
+            if (cancelled()) {
+                delete data;
+                return;
+            }
+            emit newData(data, databasePath);
+
+            bool complete = true;
+            while (count < limit) {
+                if (cancelled()) {
+                    complete = false;
+                    break;
+                }
+
+                data = modelData(selectQuery, pageSize);
+                if (data->isEmpty()) {
+                    delete data;
+                    break;
+                }
+
+                count += data->count();
+                for (int i = 0; i < data->count(); i++) {
+                    results.append(data->id(i));
+                }
+
+                emit moreData(data, databasePath);
             }
 
-            connectionName = db.connectionName();
+            previousFilter = filter;
+            previousDatabasePath = databasePath;
+            previousResults = results;
+            // if the limit was reached there can be more comics matching the filter
+            previousResultsComplete = complete && count < limit;
+        } catch (const std::exception &e) {
+            // Do nothing, uncomplete search string will end here and it is part of how the QueryParser works
+            // I don't like the idea of using exceptions for this though
         }
-        QSqlDatabase::removeDatabase(connectionName);
     });
 }
 
-QList<ComicItem *> *YACReader::ComicQueryResultProcessor::modelData(QSqlQuery &sqlquery)
+void YACReader::ComicQueryResultProcessor::cancel()
 {
-    auto list = new QList<ComicItem *>();
+    querySearchQueue.cancelPending();
+    ++currentSearch;
+}
 
-    int numColumns = sqlquery.record().count();
+// the ids of the previous results go to a temporary table of the (pooled) search connection, the number of
+// results can be too big to inline them in the query
+bool YACReader::ComicQueryResultProcessor::storePreviousResults(QSqlDatabase &db)
+{
+    QSqlQuery query(db);
+    if (!query.exec("CREATE TEMP TABLE IF NOT EXISTS previous_search_results (id INTEGER PRIMARY KEY)") ||
+        !query.exec("DELETE FROM temp.previous_search_results")) {
+        QLOG_WARN() << "Unable to store the previous search results" << query.lastError().databaseText();
+        return false;
+    }
 
-    while (sqlquery.next()) {
-        QList<QVariant> data;
+    QVariantList ids;
+    ids.reserve(previousResults.size());
+    for (auto id : previousResults) {
+        ids.append(id);
+    }
 
-        for (int i = 0; i < numColumns; i++)
-            data << sqlquery.value(i);
+    db.transaction();
+    query.prepare("INSERT OR IGNORE INTO temp.previous_search_results (id) VALUES (?)");
+    query.addBindValue(ids);
+    bool stored = query.execBatch();
+    db.commit();
 
-        list->append(new ComicItem(data));
-    }
+    return stored;
+}
 
-    std::sort(list->begin(), list->end(), [](const ComicItem *c1, const ComicItem *c2) {
-        if (c1->data(ComicModel::Number).isNull() && c2->data(ComicModel::Number).isNull()) {
-            return naturalSortLessThanCI(c1->data(ComicModel::FileName).toString(), c2->data(ComicModel::FileName).toString());
-        } else {
-            if (c1->data(ComicModel::Number).isNull() == false && c2->data(ComicModel::Number).isNull() == false) {
-                return c1->data(ComicModel::Number).toInt() < c2->data(ComicModel::Number).toInt();
-            } else {
-                return c2->data(ComicModel::Number).isNull();
-            }
-        }
-    });
+ComicItemList *YACReader::ComicQueryResultProcessor::modelData(QSqlQuery &sqlquery, int maxRows)
+{
+    auto list = new ComicItemList();
+
+    list->appendRows(sqlquery, maxRows);
+    // ComicModel merges the sorted pages
+    list->sortByNumber();
 
     return list;
 }
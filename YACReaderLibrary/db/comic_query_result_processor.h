@@ -2,15 +2,22 @@
 #define COMIC_QUERY_RESULT_PROCESSOR_H
 
 #include <QtCore>
+#include <QSqlDatabase>
 #include <QSqlQuery>
 
+#include <atomic>
+
 #include "yacreader_global.h"
 #include "concurrent_queue.h"
 
-class ComicItem;
+class ComicItemList;
 
 namespace YACReader {
 
+// Runs the comic searches in a background thread. Only the last search matters: starting a new one
+// (or calling cancel()) stops the one in progress between pages of results. The first page of results
+// is sent with newData() as soon as it is read, the rest are sent in pages with moreData(). Every page is sorted by
+// number, ComicModel::appendModelData merges them so the whole result keeps that order.
 class ComicQueryResultProcessor : public QObject
 {
     Q_OBJECT
@@ -18,14 +25,30 @@ public:
     ComicQueryResultProcessor();
 
 public slots:
-    void createModelData(const QString &filter, const QString &databasePath);
+    // `limit` is the maximum number of results
+    void createModelData(const QString &filter, const QString &databasePath, int limit);
+    void cancel();
 signals:
-    void newData(QList<ComicItem *> *, const QString &);
+    void newData(ComicItemList *, const QString &);
+    void moreData(ComicItemList *, const QString &);
 
 private:
-    ConcurrentQueue querySearchQueue;
+    static constexpr int firstPageSize = 100;
+    static constexpr int pageSize = 1000;
 
-    static QList<ComicItem *> *modelData(QSqlQuery &sqlquery);
+    ConcurrentQueue querySearchQueue;
+    // id of the last search, the running search stops when it changes
+    std::atomic<quint64> currentSearch;
+
+    // results of the previous search (only used by the search thread), a search that narrows it
+    // only looks for comics in these results
+    QString previousFilter;
+    QString previousDatabasePath;
+    QVector<qulonglong> previousResults;
+    bool previousResultsComplete;
+
+    bool storePreviousResults(QSqlDatabase &db);
+    static ComicItemList *modelData(QSqlQuery &sqlquery, int maxRows);
 };
 };
 
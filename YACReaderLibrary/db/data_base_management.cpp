@@ -2,8 +2,10 @@
 
 #include <QtCore>
 #include "initial_comic_info_extractor.h"
+#include "cover_store.h"
 #include "check_new_version.h"
 #include "db_helper.h"
+#include "db_connection_pool.h"
 
 #include "QsLog.h"
 
@@ -88,6 +90,8 @@ QSqlDatabase DataBaseManagement::createDatabase(QString name, QString path)
 
 QSqlDatabase DataBaseManagement::createDatabase(QString dest)
 {
+    DBConnectionPool::invalidate(QFileInfo(dest).path());
+
     QString threadId = QString::number((long long)QThread::currentThreadId(), 16);
     QSqlDatabase db = QSqlDatabase::addDatabase("QSQLITE", dest + threadId);
     db.setDatabaseName(dest);
@@ -114,9 +118,14 @@ QSqlDatabase DataBaseManagement::createDatabase(QString dest)
 
 QSqlDatabase DataBaseManagement::loadDatabase(QString path)
 {
-    // TODO check path
     QString threadId = QString::number((long long)QThread::currentThreadId(), 16);
-    QSqlDatabase db = QSqlDatabase::addDatabase("QSQLITE", path + threadId);
+    return loadDatabase(path, path + threadId);
+}
+
+QSqlDatabase DataBaseManagement::loadDatabase(const QString &path, const QString &connectionName)
+{
+    // TODO check path
+    QSqlDatabase db = QSqlDatabase::addDatabase("QSQLITE", connectionName);
     db.setDatabaseName(path + "/library.ydb");
     if (!db.open()) {
         return QSqlDatabase();
@@ -343,6 +352,66 @@ bool DataBaseManagement::createV8Tables(QSqlDatabase &database)
     return success;
 }
 
+// text searched by the free text terms of a search (columns of comic_search)
+static const QString searchIndexColumns = "title, volume, storyArc, genere, writer, penciller, inker, colorist, letterer, coverArtist, "
+                                          "publisher, format, ageRating, synopsis, characters, notes, fileName, folderName";
+
+static const QString searchIndexContent = "SELECT c.id, ci.title, ci.volume, ci.storyArc, ci.genere, ci.writer, ci.penciller, ci.inker, ci.colorist, ci.letterer, ci.coverArtist, "
+                                          "ci.publisher, ci.format, ci.ageRating, ci.synopsis, ci.characters, ci.notes, c.fileName, f.name "
+                                          "FROM comic c INNER JOIN comic_info ci ON (c.comicInfoId = ci.id) LEFT JOIN folder f ON (f.id = c.parentId)";
+
+bool DataBaseManagement::hasSearchIndex(const QSqlDatabase &database)
+{
+    QSqlQuery query(database);
+    query.exec("SELECT 1 FROM sqlite_master WHERE type = 'table' AND name = 'comic_search'");
+    return query.next();
+}
+
+bool DataBaseManagement::createSearchIndex(QSqlDatabase &database)
+{
+    // all or nothing, it can be used inside or outside a transaction
+    QSqlQuery savepoint(database);
+    savepoint.exec("SAVEPOINT search_index");
+
+    // FTS5 table with a row per comic (rowid = comic.id), it is kept up to date by triggers
+    QSqlQuery queryCreateIndex(database);
+    if (!queryCreateIndex.exec("CREATE VIRTUAL TABLE comic_search USING fts5(" + searchIndexColumns + ", prefix = '2 3')")) {
+        // the SQLite library has been built without FTS5, searches don't use the index
+        QLOG_WARN() << "Unable to create the search index:" << queryCreateIndex.lastError().text();
+        savepoint.exec("ROLLBACK TO search_index");
+        savepoint.exec("RELEASE search_index");
+        return false;
+    }
+
+    const QString insert = "INSERT INTO comic_search (rowid, " + searchIndexColumns + ") " + searchIndexContent;
+    const QStringList queries {
+        insert,
+        "CREATE TRIGGER comic_search_insert AFTER INSERT ON comic BEGIN " + insert + " WHERE c.id = new.id; END",
+        "CREATE TRIGGER comic_search_update AFTER UPDATE OF parentId, comicInfoId, fileName ON comic BEGIN "
+        "DELETE FROM comic_search WHERE rowid = old.id; " + insert + " WHERE c.id = new.id; END",
+        "CREATE TRIGGER comic_search_delete AFTER DELETE ON comic BEGIN "
+        "DELETE FROM comic_search WHERE rowid = old.id; END",
+        "CREATE TRIGGER comic_info_search_update AFTER UPDATE OF title, volume, storyArc, genere, writer, penciller, inker, colorist, letterer, coverArtist, "
+        "publisher, format, ageRating, synopsis, characters, notes ON comic_info BEGIN "
+        "DELETE FROM comic_search WHERE rowid IN (SELECT id FROM comic WHERE comicInfoId = new.id); " + insert + " WHERE c.comicInfoId = new.id; END",
+        "CREATE TRIGGER folder_search_update AFTER UPDATE OF name ON folder BEGIN "
+        "DELETE FROM comic_search WHERE rowid IN (SELECT id FROM comic WHERE parentId = new.id); " + insert + " WHERE c.parentId = new.id; END",
+    };
+
+    for (const auto &sql : queries) {
+        QSqlQuery query(database);
+        if (!query.exec(sql)) {
+            QLOG_ERROR() << "Error creating the search index:" << query.lastError().text();
+            savepoint.exec("ROLLBACK TO search_index");
+            savepoint.exec("RELEASE search_index");
+            return false;
+        }
+    }
+
+    savepoint.exec("RELEASE search_index");
+    return true;
+}
+
 void DataBaseManagement::exportComicsInfo(QString source, QString dest)
 {
     QString connectionName = "";
@@ -583,8 +652,13 @@ bool DataBaseManagement::importComicsInfo(QString source, QString dest)
                 QString basePath = QString(dest).remove("/.yacreaderlibrary/library.ydb");
                 QString path = basePath + getComic.record().value("path").toString();
                 int coverPage = getComic.record().value("coverPage").toInt();
-                InitialComicInfoExtractor ie(path, basePath + "/.yacreaderlibrary/covers/" + hash + ".jpg", coverPage);
+                auto covers = CoverStore::forLibrary(basePath + "/.yacreaderlibrary");
+                InitialComicInfoExtractor ie(path, covers->filePath(hash), coverPage);
+                ie.setWriteCoverOnExtract(false);
                 ie.extract();
+                if (!ie.getCoverData().isEmpty()) {
+                    covers->write(hash, ie.getCoverData());
+                }
             }
         }
         sourceDBconnection = sourceDB.connectionName();
@@ -760,6 +834,8 @@ bool DataBaseManagement::updateToCurrentVersion(const QString &path)
 
     QString fullPath = path + "/library.ydb";
 
+    DBConnectionPool::invalidate(path);
+
     if (compareVersions(DataBaseManagement::checkValidDB(fullPath), "7.0.0") < 0)
         pre7 = true;
     if (compareVersions(DataBaseManagement::checkValidDB(fullPath), "7.0.3") < 0)
@@ -866,9 +942,10 @@ bool DataBaseManagement::updateToCurrentVersion(const QString &path)
                     QSqlQuery updateCoverInfo(db);
                     updateCoverInfo.prepare("UPDATE comic_info SET coverSizeRatio = :coverSizeRatio WHERE id = :id");
 
+                    CoverStore covers(path);
                     QImageReader thumbnail;
                     while (selectQuery.next()) {
-                        thumbnail.setFileName(path % "/covers/" % selectQuery.value(1).toString() % ".jpg");
+                        thumbnail.setFileName(covers.coverPath(selectQuery.value(1).toString()));
 
                         float coverSizeRatio = static_cast<float>(thumbnail.size().width()) / thumbnail.size().height();
                         updateCoverInfo.bindValue(":coverSizeRatio", coverSizeRatio);
@@ -895,11 +972,22 @@ bool DataBaseManagement::updateToCurrentVersion(const QString &path)
                     returnValue = returnValue && successAddingColumns;
                 }
             }
+
+            if (!hasSearchIndex(db)) {
+                createSearchIndex(db);
+            }
         }
         connectionName = db.connectionName();
     }
 
     QSqlDatabase::removeDatabase(connectionName);
+
+    // covers stored by older versions are moved to their shard, their smaller sizes are created in the next full update
+    int migratedCovers = CoverStore::forLibrary(path)->migrate();
+    if (migratedCovers > 0) {
+        QLOG_INFO() << "Covers moved to the sharded covers folder:" << migratedCovers;
+    }
+
     return returnValue;
 }
 
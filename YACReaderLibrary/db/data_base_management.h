@@ -48,9 +48,14 @@ public:
     static QSqlDatabase createDatabase(QString dest);
     // carga una base de datos desde la ruta path
     static QSqlDatabase loadDatabase(QString path);
+    // opens the library DB in `path` with a custom connection name, e.g. for connections that outlive the call
+    static QSqlDatabase loadDatabase(const QString &path, const QString &connectionName);
     static QSqlDatabase loadDatabaseFromFile(QString path);
     static bool createTables(QSqlDatabase &database);
     static bool createV8Tables(QSqlDatabase &database);
+    // full text index used by searches (comic_search), it is optional: searches work without it if SQLite doesn't support FTS5
+    static bool hasSearchIndex(const QSqlDatabase &database);
+    static bool createSearchIndex(QSqlDatabase &database);
 
     static void exportComicsInfo(QString source, QString dest);
     static bool importComicsInfo(QString source, QString dest);
@@ -0,0 +1,250 @@
+#include "db_connection_pool.h"
+
+#include <QCoreApplication>
+#include <QDir>
+#include <QHash>
+#include <QMutex>
+#include <QSqlError>
+#include <QThread>
+#include <QThreadStorage>
+#include <QTimer>
+
+#include <atomic>
+
+#include "data_base_management.h"
+
+#include "QsLog.h"
+
+namespace {
+const int maxCachedStatements = 64;
+const int idleTimeout = 60 * 1000; // ms
+
+struct CachedStatement {
+    explicit CachedStatement(QSqlDatabase &db)
+        : query(db), inUse(false) { }
+    QSqlQuery query;
+    bool inUse;
+};
+
+struct PooledConnection {
+    QString name;
+    QString path;
+    quint64 generation;
+    int leases;
+    QHash<QString, CachedStatement *> statements;
+};
+
+QMutex generationsMutex;
+QHash<QString, quint64> generations;
+
+quint64 currentGeneration(const QString &key)
+{
+    QMutexLocker locker(&generationsMutex);
+    return generations.value(key, 0);
+}
+
+// destroyed by QThreadStorage when its thread finishes
+class ThreadConnections
+{
+public:
+    ThreadConnections()
+        : idleTimer(nullptr)
+    {
+        // threads without an event loop (e.g. std::thread workers) keep their connections until they finish
+        if (QThread::currentThread()->eventDispatcher() != nullptr) {
+            idleTimer = new QTimer;
+            idleTimer->setSingleShot(true);
+            idleTimer->setInterval(idleTimeout);
+            QObject::connect(idleTimer, &QTimer::timeout, idleTimer, [this] { closeIdle(); });
+        }
+    }
+
+    ~ThreadConnections()
+    {
+        delete idleTimer;
+
+        const auto connections = byPath.values();
+        for (auto connection : connections) {
+            close(connection);
+        }
+    }
+
+    void close(PooledConnection *connection)
+    {
+        qDeleteAll(connection->statements);
+        connection->statements.clear();
+        {
+            QSqlDatabase db = QSqlDatabase::database(connection->name, false);
+            db.close();
+        }
+        QSqlDatabase::removeDatabase(connection->name);
+
+        byName.remove(connection->name);
+        byPath.remove(connection->path);
+        delete connection;
+    }
+
+    // stale connections are closed as soon as they aren't used, the rest after being idle for a while
+    void release(PooledConnection *connection)
+    {
+        if (--connection->leases > 0) {
+            return;
+        }
+
+        if (connection->generation != currentGeneration(connection->path)) {
+            close(connection);
+        } else if (idleTimer != nullptr) {
+            idleTimer->start();
+        }
+    }
+
+    void closeIdle()
+    {
+        const auto connections = byPath.values();
+        for (auto connection : connections) {
+            if (connection->leases == 0) {
+                close(connection);
+            }
+        }
+    }
+
+    QHash<QString, PooledConnection *> byPath;
+    QHash<QString, PooledConnection *> byName;
+
+private:
+    QTimer *idleTimer;
+};
+
+QThreadStorage<ThreadConnections *> &threadConnections()
+{
+    static QThreadStorage<ThreadConnections *> storage;
+    return storage;
+}
+
+ThreadConnections *currentThreadConnections()
+{
+    auto &storage = threadConnections();
+    return storage.hasLocalData() ? storage.localData() : nullptr;
+}
+
+std::atomic<quint64> connectionHits { 0 };
+std::atomic<quint64> connectionMisses { 0 };
+std::atomic<quint64> statementHits { 0 };
+std::atomic<quint64> statementMisses { 0 };
+}
+
+DBConnectionPool::Connection::Connection(const QString &path)
+    : pooled(false)
+{
+    auto app = QCoreApplication::instance();
+    if (app == nullptr || QThread::currentThread() == app->thread()) {
+        connectionMisses++;
+        db = DataBaseManagement::loadDatabase(path);
+        return;
+    }
+
+    auto &storage = threadConnections();
+    if (!storage.hasLocalData()) {
+        storage.setLocalData(new ThreadConnections);
+    }
+    auto connections = storage.localData();
+
+    QString key = QDir::cleanPath(path);
+    quint64 generation = currentGeneration(key);
+
+    auto connection = connections->byPath.value(key);
+    if (connection != nullptr && connection->generation != generation && connection->leases == 0) {
+        connections->close(connection);
+        connection = nullptr;
+    }
+
+    if (connection != nullptr) {
+        connectionHits++;
+        db = QSqlDatabase::database(connection->name, false);
+    } else {
+        connectionMisses++;
+
+        QString threadId = QString::number((long long)QThread::currentThreadId(), 16);
+        QString name = "pool:" + key + threadId;
+        db = DataBaseManagement::loadDatabase(key, name);
+        if (!db.isValid()) {
+            QLOG_ERROR() << "Unable to open pooled connection to" << key;
+            QSqlDatabase::removeDatabase(name);
+            return;
+        }
+
+        connection = new PooledConnection { name, key, generation, 0, {} };
+        connections->byPath.insert(key, connection);
+        connections->byName.insert(name, connection);
+    }
+
+    connection->leases++;
+    pooled = true;
+}
+
+DBConnectionPool::Connection::~Connection()
+{
+    QString name = db.connectionName();
+    db = QSqlDatabase();
+
+    if (!pooled) {
+        if (!name.isEmpty()) {
+            QSqlDatabase::removeDatabase(name);
+        }
+        return;
+    }
+
+    auto connections = currentThreadConnections();
+    auto connection = connections != nullptr ? connections->byName.value(name) : nullptr;
+    if (connection != nullptr) {
+        connections->release(connection);
+    }
+}
+
+DBConnectionPool::PreparedQuery::PreparedQuery(QSqlDatabase &db, const QString &sql)
+    : localQuery(db), query(&localQuery), inUse(nullptr)
+{
+    auto connections = currentThreadConnections();
+    auto connection = connections != nullptr ? connections->byName.value(db.connectionName()) : nullptr;
+
+    if (connection != nullptr) {
+        auto statement = connection->statements.value(sql);
+        if (statement == nullptr && connection->statements.size() < maxCachedStatements) {
+            statement = new CachedStatement(db);
+            statement->query.prepare(sql);
+            connection->statements.insert(sql, statement);
+            statementMisses++;
+        } else if (statement != nullptr && !statement->inUse) {
+            statementHits++;
+        }
+
+        if (statement != nullptr && !statement->inUse) {
+            statement->inUse = true;
+            inUse = &statement->inUse;
+            query = &statement->query;
+            return;
+        }
+    }
+
+    statementMisses++;
+    localQuery.prepare(sql);
+}
+
+DBConnectionPool::PreparedQuery::~PreparedQuery()
+{
+    if (inUse != nullptr) {
+        query->finish();
+        *inUse = false;
+    }
+}
+
+void DBConnectionPool::invalidate(const QString &path)
+{
+    QMutexLocker locker(&generationsMutex);
+    generations[QDir::cleanPath(path)]++;
+}
+
+DBConnectionPool::Stats DBConnectionPool::stats()
+{
+    return { connectionHits, connectionMisses, statementHits, statementMisses };
+}
@@ -0,0 +1,66 @@
+#ifndef DB_CONNECTION_POOL_H
+#define DB_CONNECTION_POOL_H
+
+#include <QString>
+#include <QSqlDatabase>
+#include <QSqlQuery>
+
+// Keeps one open connection per thread and library DB, so the server doesn't need to open the DB,
+// parse the schema and close it again for every DBHelper call.
+//
+// Pooled connections are owned by the thread that opened them and they are closed when that thread
+// finishes, after being idle for a minute (only in threads running an event loop, like the server ones)
+// or, after invalidate() has been called for their library, as soon as they aren't leased.
+// The main thread is never pooled, it gets a regular connection that is removed when the lease ends,
+// this way the GUI never keeps a library DB open.
+class DBConnectionPool
+{
+public:
+    struct Stats {
+        quint64 connectionHits;
+        quint64 connectionMisses;
+        quint64 statementHits;
+        quint64 statementMisses;
+    };
+
+    // lease of the calling thread connection to the library DB stored in `path` (a .yacreaderlibrary folder)
+    class Connection
+    {
+    public:
+        explicit Connection(const QString &path);
+        ~Connection();
+
+        // the connection must not be closed or removed by the caller
+        QSqlDatabase &database() { return db; }
+
+    private:
+        QSqlDatabase db;
+        bool pooled;
+        Q_DISABLE_COPY(Connection)
+    };
+
+    // Prepared statement cached in the pooled connection, if `db` isn't a pooled connection or the
+    // statement is already in use a regular QSqlQuery is prepared instead. The statement is finished
+    // when PreparedQuery goes out of scope so no locks are kept between calls.
+    class PreparedQuery
+    {
+    public:
+        PreparedQuery(QSqlDatabase &db, const QString &sql);
+        ~PreparedQuery();
+
+        QSqlQuery &operator*() { return *query; }
+        QSqlQuery *operator->() { return query; }
+
+    private:
+        QSqlQuery localQuery;
+        QSqlQuery *query;
+        bool *inUse;
+        Q_DISABLE_COPY(PreparedQuery)
+    };
+
+    // marks the connections to `path` as stale, they are closed when released and reopened the next time they are used
+    static void invalidate(const QString &path);
+    static Stats stats();
+};
+
+#endif // DB_CONNECTION_POOL_H
@@ -4,6 +4,7 @@
 #include "qnaturalsorting.h"
 
 FolderItem::FolderItem(const QList<QVariant> &data, FolderItem *parent)
+    : originalItem(nullptr), childrenFetched(true), hasSubfolders(false)
 {
     parentItem = parent;
     itemData = data;
@@ -16,28 +17,30 @@ FolderItem::~FolderItem()
 
 void FolderItem::appendChild(FolderItem *item)
 {
-    item->parentItem = this;
+    insertChild(insertionRow(item), item);
+}
 
+int FolderItem::insertionRow(FolderItem *item) const
+{
     if (childItems.isEmpty())
-        childItems.append(item);
-    else {
-        FolderItem *last = childItems.back();
-        QString nameLast = last->data(1).toString(); // TODO usar info name si est� disponible, sino el nombre del fichero.....
-        QString nameCurrent = item->data(1).toString();
-        QList<FolderItem *>::iterator i;
-        i = childItems.end();
+        return 0;
+
+    int i = childItems.count() - 1;
+    QString nameLast = childItems.at(i)->data(1).toString(); // TODO usar info name si est� disponible, sino el nombre del fichero.....
+    QString nameCurrent = item->data(1).toString();
+    while (naturalSortLessThanCI(nameCurrent, nameLast) && i != 0) {
         i--;
-        while (naturalSortLessThanCI(nameCurrent, nameLast) && i != childItems.begin()) {
-            i--;
-            nameLast = (*i)->data(1).toString();
-        }
-        if (!naturalSortLessThanCI(nameCurrent, nameLast)) // si se ha encontrado un elemento menor que current, se inserta justo despu�s
-            childItems.insert(++i, item);
-        else
-            childItems.insert(i, item);
+        nameLast = childItems.at(i)->data(1).toString();
     }
+    if (!naturalSortLessThanCI(nameCurrent, nameLast)) // si se ha encontrado un elemento menor que current, se inserta justo despu�s
+        return i + 1;
+    return i;
+}
 
-    // childItems.append(item);
+void FolderItem::insertChild(int row, FolderItem *item)
+{
+    item->parentItem = this;
+    childItems.insert(row, item);
 }
 
 FolderItem *FolderItem::child(int row)
@@ -65,6 +68,11 @@ void FolderItem::setData(int column, const QVariant &value)
     itemData[column] = value;
 }
 
+void FolderItem::setData(const QList<QVariant> &data)
+{
+    itemData = data;
+}
+
 void FolderItem::removeChild(int childIndex)
 {
     childItems.removeAt(childIndex);
@@ -52,6 +52,9 @@ public:
     ~FolderItem();
 
     void appendChild(FolderItem *child);
+    // row where `child` goes to keep the children sorted, insertChild() doesn't sort
+    int insertionRow(FolderItem *child) const;
+    void insertChild(int row, FolderItem *child);
 
     FolderItem *child(int row);
     int childCount() const;
@@ -64,7 +67,11 @@ public:
     unsigned long long int id;
     QList<QString> comicNames;
     FolderItem *originalItem;
+    // lazy loading: false until the subfolders are loaded, hasSubfolders tells if the folder has any
+    bool childrenFetched;
+    bool hasSubfolders;
     void setData(int column, const QVariant &value);
+    void setData(const QList<QVariant> &data);
     void removeChild(int childIndex);
     void clearChildren();
     QList<FolderItem *> children();
@@ -3,6 +3,7 @@
 #include "folder_item.h"
 #include "data_base_management.h"
 #include "folder.h"
+#include "cover_store.h"
 #include "db_helper.h"
 #include "qnaturalsorting.h"
 #include "yacreader_global_gui.h"
@@ -54,12 +55,12 @@ void drawMacOSXFinishedFolderIcon()
 #define ROOT 1
 
 FolderModel::FolderModel(QObject *parent)
-    : QAbstractItemModel(parent), isSubfolder(false), rootItem(nullptr), folderIcon(YACReader::noHighlightedIcon(":/images/sidebar/folder.svg")), folderFinishedIcon(YACReader::noHighlightedIcon(":/images/sidebar/folder_finished.svg"))
+    : QAbstractItemModel(parent), isSubfolder(false), rootItem(nullptr), lazy(false), folderIcon(YACReader::noHighlightedIcon(":/images/sidebar/folder.svg")), folderFinishedIcon(YACReader::noHighlightedIcon(":/images/sidebar/folder_finished.svg"))
 {
 }
 
 FolderModel::FolderModel(QSqlQuery &sqlquery, QObject *parent)
-    : QAbstractItemModel(parent), isSubfolder(false), rootItem(nullptr)
+    : QAbstractItemModel(parent), isSubfolder(false), rootItem(nullptr), lazy(false)
 {
     // lo m�s probable es que el nodo ra�z no necesite tener informaci�n
     QList<QVariant> rootData;
@@ -110,8 +111,166 @@ void FolderModel::reload()
 
 void FolderModel::reload(const QModelIndex &index)
 {
-    // TODO: reload just the content under index for better efficiency
-    setupModelData(_databasePath);
+    if (rootItem == nullptr) {
+        setupModelData(_databasePath);
+        return;
+    }
+
+    auto item = index.isValid() ? static_cast<FolderItem *>(index.internalPointer()) : rootItem;
+
+    // only the subtree under `index` is loaded, the tree is updated with the differences so the rest of
+    // the model (and the state of the views, e.g. expanded folders) is kept
+    FolderRows rows;
+    QList<QVariant> itemData;
+    bool itemFound = item == rootItem;
+    QList<QPair<FolderItem *, QList<QVariant>>> ancestors;
+    QString connectionName = "";
+    {
+        QSqlDatabase db = DataBaseManagement::loadDatabase(_databasePath);
+        QSqlQuery selectQuery(db);
+        selectQuery.prepare("WITH RECURSIVE subtree(id) AS ("
+                            "SELECT :id UNION ALL "
+                            "SELECT f.id FROM folder f INNER JOIN subtree s ON (f.parentId = s.id) WHERE f.id <> 1) "
+                            "SELECT f.*, f.id IN (SELECT parentId FROM folder WHERE id <> 1) AS hasSubfolders FROM folder f INNER JOIN subtree s ON (f.id = s.id)");
+        selectQuery.bindValue(":id", item->id);
+        selectQuery.exec();
+
+        int id = selectQuery.record().indexOf("id");
+        int parentId = selectQuery.record().indexOf("parentId");
+        int hasSubfolders = selectQuery.record().indexOf("hasSubfolders");
+        while (selectQuery.next()) {
+            FolderRow row { selectQuery.value(id).toULongLong(), selectQuery.value(hasSubfolders).toBool(), folderItemData(selectQuery) };
+            if (row.id == item->id) {
+                itemData = row.data;
+                itemFound = true;
+            } else {
+                rows[selectQuery.value(parentId).toULongLong()].append(row);
+            }
+        }
+
+        // the parents info (e.g. the cover) can change after updating one of their subfolders
+        QSqlQuery ancestorQuery(db);
+        ancestorQuery.prepare("SELECT * FROM folder WHERE id = :id");
+        for (auto ancestor = item->parent(); ancestor != nullptr && ancestor != rootItem; ancestor = ancestor->parent()) {
+            ancestorQuery.bindValue(":id", ancestor->id);
+            ancestorQuery.exec();
+            if (ancestorQuery.next()) {
+                ancestors.append(qMakePair(ancestor, folderItemData(ancestorQuery)));
+            }
+        }
+
+        connectionName = db.connectionName();
+    }
+    QSqlDatabase::removeDatabase(connectionName);
+
+    if (!itemFound) {
+        // the folder doesn't exist anymore
+        reload(index.parent());
+        return;
+    }
+
+    if (item != rootItem && itemData != item->getData()) {
+        item->setData(itemData);
+        emit dataChanged(index.siblingAtColumn(Name), index.siblingAtColumn(FirstChildHash));
+    }
+
+    syncChildren(item, index.siblingAtColumn(Name), rows);
+
+    for (const auto &ancestor : ancestors) {
+        if (ancestor.second != ancestor.first->getData()) {
+            ancestor.first->setData(ancestor.second);
+            auto ancestorIndex = createIndex(ancestor.first->row(), Name, ancestor.first);
+            emit dataChanged(ancestorIndex, ancestorIndex.siblingAtColumn(FirstChildHash));
+        }
+    }
+}
+
+void FolderModel::syncChildren(FolderItem *parent, const QModelIndex &parentIndex, const FolderRows &rows)
+{
+    if (!parent->childrenFetched) {
+        // nothing to update until the folder is expanded
+        return;
+    }
+
+    const auto freshRows = rows.value(parent->id);
+    QHash<qulonglong, const FolderRow *> freshById;
+    for (const auto &row : freshRows) {
+        freshById.insert(row.id, &row);
+    }
+
+    // removed folders, renamed folders are removed and inserted again in their new sorted position
+    for (int i = parent->childCount() - 1; i >= 0; i--) {
+        auto child = parent->child(i);
+        auto fresh = freshById.value(child->id);
+        if (fresh == nullptr || fresh->data.value(Path) != child->data(Path)) {
+            beginRemoveRows(parentIndex, i, i);
+            parent->removeChild(i);
+            forgetItems(child);
+            delete child;
+            endRemoveRows();
+        }
+    }
+
+    QHash<qulonglong, FolderItem *> current;
+    for (auto child : parent->children()) {
+        current.insert(child->id, child);
+    }
+
+    QList<FolderItem *> existing;
+    for (const auto &row : freshRows) {
+        auto child = current.value(row.id);
+        if (child != nullptr) {
+            child->hasSubfolders = row.hasSubfolders;
+            if (child->getData() != row.data) {
+                child->setData(row.data);
+                auto childIndex = index(child->row(), Name, parentIndex);
+                emit dataChanged(childIndex, childIndex.siblingAtColumn(FirstChildHash));
+            }
+            existing.append(child);
+            continue;
+        }
+
+        // new folders are inserted with their whole subtree already built
+        auto newItem = new FolderItem(row.data);
+        newItem->id = row.id;
+        newItem->hasSubfolders = row.hasSubfolders;
+        if (lazy) {
+            newItem->childrenFetched = false;
+        } else {
+            buildSubtree(newItem, rows);
+        }
+
+        int destRow = parent->insertionRow(newItem);
+        beginInsertRows(parentIndex, destRow, destRow);
+        parent->insertChild(destRow, newItem);
+        items.insert(newItem->id, newItem);
+        endInsertRows();
+    }
+
+    for (auto child : existing) {
+        syncChildren(child, index(child->row(), Name, parentIndex), rows);
+    }
+}
+
+void FolderModel::buildSubtree(FolderItem *parent, const FolderRows &rows)
+{
+    for (const auto &row : rows.value(parent->id)) {
+        auto item = new FolderItem(row.data);
+        item->id = row.id;
+        parent->appendChild(item);
+        items.insert(item->id, item);
+        buildSubtree(item, rows);
+    }
+}
+
+void FolderModel::forgetItems(FolderItem *item)
+{
+    if (items.value(item->id) == item) {
+        items.remove(item->id);
+    }
+    for (auto child : item->children()) {
+        forgetItems(child);
+    }
 }
 
 QVariant FolderModel::data(const QModelIndex &index, int role) const
@@ -218,6 +377,14 @@ QModelIndex FolderModel::index(int row, int column, const QModelIndex &parent)
 
 QModelIndex FolderModel::index(qulonglong folderId) const
 {
+    auto item = items.value(folderId);
+    if (item != nullptr && item != rootItem && item->parent() != nullptr) {
+        int row = item->row();
+        if (row >= 0) {
+            return createIndex(row, 0, item);
+        }
+    }
+
     QModelIndex index;
     YACReader::iterate(QModelIndex(), this, [&](const QModelIndex &idx) {
         if (index.isValid()) {
@@ -289,9 +456,22 @@ void FolderModel::setupModelData(QString path)
     QString connectionName = "";
     {
         QSqlDatabase db = DataBaseManagement::loadDatabase(path);
-        QSqlQuery selectQuery("select * from folder where id <> 1 order by parentId,name", db);
 
-        setupModelData(selectQuery, rootItem);
+        QSqlQuery countQuery("SELECT COUNT(*) FROM folder", db);
+        lazy = countQuery.next() && countQuery.value(0).toInt() > lazyLoadingThreshold;
+
+        if (lazy) {
+            items.clear();
+            items.insert(rootItem->id, rootItem);
+            const auto subfolders = loadSubfolders(rootItem->id, db);
+            for (auto subfolder : subfolders) {
+                rootItem->insertChild(rootItem->childCount(), subfolder);
+                items.insert(subfolder->id, subfolder);
+            }
+        } else {
+            QSqlQuery selectQuery("select * from folder where id <> 1 order by parentId,name", db);
+            setupModelData(selectQuery, rootItem);
+        }
         connectionName = db.connectionName();
     }
     // selectQuery.finish();
@@ -299,6 +479,146 @@ void FolderModel::setupModelData(QString path)
     endResetModel();
 }
 
+QList<FolderItem *> FolderModel::loadSubfolders(qulonglong parentId, QSqlDatabase &db)
+{
+    QList<FolderItem *> subfolders;
+
+    QSqlQuery selectQuery(db);
+    // the subquery is run once for all the rows, folder.parentId isn't indexed
+    selectQuery.prepare("SELECT f.*, f.id IN (SELECT parentId FROM folder WHERE id <> 1) AS hasSubfolders "
+                        "FROM folder f WHERE f.parentId = :parentId AND f.id <> 1");
+    selectQuery.bindValue(":parentId", parentId);
+    selectQuery.exec();
+
+    int id = selectQuery.record().indexOf("id");
+    int hasSubfolders = selectQuery.record().indexOf("hasSubfolders");
+    while (selectQuery.next()) {
+        auto item = new FolderItem(folderItemData(selectQuery));
+        item->id = selectQuery.value(id).toULongLong();
+        item->hasSubfolders = selectQuery.value(hasSubfolders).toBool();
+        item->childrenFetched = false;
+        subfolders.append(item);
+    }
+
+    // same order FolderItem::appendChild uses
+    std::stable_sort(subfolders.begin(), subfolders.end(), [](FolderItem *f1, FolderItem *f2) {
+        return naturalSortLessThanCI(f1->data(Path).toString(), f2->data(Path).toString());
+    });
+
+    return subfolders;
+}
+
+bool FolderModel::hasChildren(const QModelIndex &parent) const
+{
+    if (parent.column() > 0)
+        return false;
+
+    auto item = parent.isValid() ? static_cast<FolderItem *>(parent.internalPointer()) : rootItem;
+    if (item == nullptr)
+        return false;
+
+    if (!item->childrenFetched)
+        return item->hasSubfolders;
+
+    return item->childCount() > 0;
+}
+
+bool FolderModel::canFetchMore(const QModelIndex &parent) const
+{
+    auto item = parent.isValid() ? static_cast<FolderItem *>(parent.internalPointer()) : rootItem;
+    return item != nullptr && !item->childrenFetched;
+}
+
+void FolderModel::fetchMore(const QModelIndex &parent)
+{
+    auto item = parent.isValid() ? static_cast<FolderItem *>(parent.internalPointer()) : rootItem;
+    if (item == nullptr || item->childrenFetched)
+        return;
+
+    QList<FolderItem *> subfolders;
+    QString connectionName = "";
+    {
+        QSqlDatabase db = DataBaseManagement::loadDatabase(_databasePath);
+        subfolders = loadSubfolders(item->id, db);
+        connectionName = db.connectionName();
+    }
+    QSqlDatabase::removeDatabase(connectionName);
+
+    item->childrenFetched = true;
+    if (subfolders.isEmpty())
+        return;
+
+    beginInsertRows(parent, 0, subfolders.count() - 1);
+    for (auto subfolder : subfolders) {
+        item->insertChild(item->childCount(), subfolder);
+        items.insert(subfolder->id, subfolder);
+    }
+    endInsertRows();
+}
+
+void FolderModel::fetchFolder(qulonglong folderId)
+{
+    if (!lazy || items.contains(folderId))
+        return;
+
+    QList<qulonglong> ancestors; // from the root folder to the parent of the folder
+    QString connectionName = "";
+    {
+        QSqlDatabase db = DataBaseManagement::loadDatabase(_databasePath);
+        QSqlQuery selectQuery(db);
+        selectQuery.prepare("WITH RECURSIVE ancestors(id, parentId, depth) AS ("
+                            "SELECT id, parentId, 0 FROM folder WHERE id = :id UNION ALL "
+                            "SELECT f.id, f.parentId, a.depth + 1 FROM folder f INNER JOIN ancestors a ON (f.id = a.parentId) WHERE a.id <> 1) "
+                            "SELECT id FROM ancestors WHERE depth > 0 ORDER BY depth DESC");
+        selectQuery.bindValue(":id", folderId);
+        selectQuery.exec();
+        while (selectQuery.next())
+            ancestors << selectQuery.value(0).toULongLong();
+        connectionName = db.connectionName();
+    }
+    QSqlDatabase::removeDatabase(connectionName);
+
+    for (auto id : ancestors) {
+        auto item = items.value(id);
+        if (item == nullptr)
+            return;
+
+        if (!item->childrenFetched)
+            fetchMore(item == rootItem ? QModelIndex() : createIndex(item->row(), 0, item));
+    }
+}
+
+void FolderModel::fetchFolders(FolderItem *tree)
+{
+    if (!lazy)
+        return;
+
+    auto item = items.value(tree->id);
+    if (item == nullptr)
+        return;
+
+    if (tree->childCount() > 0 && !item->childrenFetched)
+        fetchMore(item == rootItem ? QModelIndex() : createIndex(item->row(), 0, item));
+
+    const auto children = tree->children();
+    for (auto child : children)
+        fetchFolders(child);
+}
+
+QList<QVariant> FolderModel::folderItemData(QSqlQuery &sqlquery)
+{
+    QSqlRecord record = sqlquery.record();
+
+    QList<QVariant> data;
+    data << sqlquery.value(record.indexOf("name")).toString();
+    data << sqlquery.value(record.indexOf("path")).toString();
+    data << sqlquery.value(record.indexOf("finished")).toBool();
+    data << sqlquery.value(record.indexOf("completed")).toBool();
+    data << sqlquery.value(record.indexOf("manga")).toBool();
+    data << sqlquery.value(record.indexOf("firstChildHash")).toString();
+    return data;
+}
+
 void FolderModel::fullSetup(QSqlQuery &sqlquery, FolderItem *parent)
 {
     rootItem = parent;
@@ -563,6 +883,11 @@ QModelIndex FolderModel::getIndexFromFolder(const Folder &folder, const QModelIn
         return QModelIndex();
     }
 
+    if (lazy) {
+        fetchFolder(folder.id);
+        return index(folder.id);
+    }
+
     auto numRows = rowCount(parent);
     for (auto i = 0; i < numRows; i++) {
         auto modelIndex = index(i, 0, parent);
@@ -705,7 +1030,7 @@ QModelIndex FolderModel::addFolderAtParent(const QString &folderName, const QMod
 
 QUrl FolderModel::getCoverUrlPathForComicHash(const QString &hash) const
 {
-    return QUrl("file:" + _databasePath + "/covers/" + hash + ".jpg");
+    return YACReader::CoverStore::forLibrary(_databasePath)->coverUrl(hash, YACReader::CoverStore::Grid);
 }
 
 void FolderModel::deleteFolder(const QModelIndex &mi)
@@ -716,6 +1041,7 @@ void FolderModel::deleteFolder(const QModelIndex &mi)
 
     FolderItem *parent = item->parent();
     parent->removeChild(mi.row());
+    forgetItems(item);
 
     Folder f;
     f.setId(item->id);
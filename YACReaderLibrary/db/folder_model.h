@@ -2,6 +2,7 @@
 #define TREEMODEL_H
 
 #include <QAbstractItemModel>
+#include <QHash>
 #include <QSortFilterProxyModel>
 #include <QModelIndex>
 #include <QVariant>
@@ -9,6 +10,7 @@
 #include <QSqlDatabase>
 #include <QUrl>
 #include <QIcon>
+#include <QVector>
 
 #include "folder.h"
 #include "folder_query_result_processor.h"
@@ -60,6 +62,15 @@ public:
     int columnCount(const QModelIndex &parent = QModelIndex()) const override;
     QHash<int, QByteArray> roleNames() const override;
 
+    // libraries with more folders than lazyLoadingThreshold load the subfolders when they are expanded
+    bool hasChildren(const QModelIndex &parent = QModelIndex()) const override;
+    bool canFetchMore(const QModelIndex &parent) const override;
+    void fetchMore(const QModelIndex &parent) override;
+    // loads the folder and its parents, so it can be found in the model
+    void fetchFolder(qulonglong folderId);
+    // loads the folders in `tree`, a tree with the ids of some of the folders (e.g. search results)
+    void fetchFolders(FolderItem *tree);
+
     // Convenience methods
     void reload();
     void reload(const QModelIndex &index);
@@ -111,8 +122,29 @@ public slots:
     void updateFolderChildrenInfo(qulonglong folderId);
 
 private:
+    // folder loaded from the DB, not added to the tree yet
+    struct FolderRow {
+        qulonglong id;
+        bool hasSubfolders;
+        QList<QVariant> data;
+    };
+    using FolderRows = QHash<qulonglong, QVector<FolderRow>>; // by parent id
+
+    static constexpr int lazyLoadingThreshold = 10000;
+
+    // FolderItem data of the current row of `sqlquery`, a `SELECT * FROM folder` query
+    static QList<QVariant> folderItemData(QSqlQuery &sqlquery);
+
     void fullSetup(QSqlQuery &sqlquery, FolderItem *parent);
 
+    // reload(index) helpers, the children of `parent` are made equal to `rows` notifying the changes
+    void syncChildren(FolderItem *parent, const QModelIndex &parentIndex, const FolderRows &rows);
+    void buildSubtree(FolderItem *parent, const FolderRows &rows);
+    void forgetItems(FolderItem *item);
+
+    // subfolders of `parentId` for lazy loading, sorted and not fetched
+    QList<FolderItem *> loadSubfolders(qulonglong parentId, QSqlDatabase &db);
+
     void setupModelData(QSqlQuery &sqlquery, FolderItem *parent);
     void updateFolderModelData(QSqlQuery &sqlquery, FolderItem *parent);
 
@@ -120,6 +152,7 @@ private:
     QMap<unsigned long long int, FolderItem *> items; // relación entre folders
 
     QString _databasePath;
+    bool lazy;
 
     QIcon folderIcon;
     QIcon folderFinishedIcon;
@@ -39,7 +39,7 @@ void YACReader::FolderQueryResultProcessor::createModelData(const QString &filte
                                         "INNER JOIN comic_info ci ON (c.comicInfoId = ci.id) WHERE ");
 
                 try {
-                    QueryParser parser;
+                    QueryParser parser(DataBaseManagement::hasSearchIndex(db));
                     auto result = parser.parse(filter.toStdString());
                     result.buildSqlString(queryString);
 
@@ -50,7 +50,7 @@ void YACReader::FolderQueryResultProcessor::createModelData(const QString &filte
 
                     selectQuery.exec();
 
-                    setupFilteredModelData(selectQuery);
+                    setupFilteredModelData(selectQuery, db);
                 } catch (const std::exception &e) {
                     // Do nothing, uncomplete search string will end here and it is part of how the QueryParser works
                     // I don't like the idea of using exceptions for this though
@@ -64,7 +64,7 @@ void YACReader::FolderQueryResultProcessor::createModelData(const QString &filte
     });
 }
 
-void YACReader::FolderQueryResultProcessor::setupFilteredModelData(QSqlQuery &sqlquery)
+void YACReader::FolderQueryResultProcessor::setupFilteredModelData(QSqlQuery &sqlquery, QSqlDatabase &db)
 {
     FolderItem *rootItem = 0;
 
@@ -90,6 +90,9 @@ void YACReader::FolderQueryResultProcessor::setupFilteredModelData(QSqlQuery &sq
     int completed = record.indexOf("completed");
     int parentIdIndex = record.indexOf("parentId");
 
+    QSqlQuery parentQuery(db);
+    parentQuery.prepare("SELECT * FROM folder WHERE id = :id");
+
     while (sqlquery.next()) { // se procesan todos los folders que cumplen con el filtro
         // datos de la base de datos
         QList<QVariant> data;
@@ -109,9 +112,6 @@ void YACReader::FolderQueryResultProcessor::setupFilteredModelData(QSqlQuery &sq
         if (!filteredItems->contains(item->id))
             filteredItems->insert(item->id, item);
 
-        // es necesario conocer las coordenadas de origen para poder realizar scroll autom�tico en la vista
-        item->originalItem = model->items.value(item->id);
-
         // si el padre ya existe en el modelo, el item se a�ade como hijo
         if (filteredItems->contains(parentId))
             filteredItems->value(parentId)->appendChild(item);
@@ -122,14 +122,16 @@ void YACReader::FolderQueryResultProcessor::setupFilteredModelData(QSqlQuery &sq
 
             // mientras no se alcance el nodo ra�z se procesan todos los padres (de abajo a arriba)
             while (parentId != ROOT) {
-                // el padre no estaba en el modelo filtrado, as� que se rescata del modelo original
-                FolderItem *parentItem = model->items.value(parentId);
+                // the parent wasn't in the filtered model, it is loaded from the DB (the folders model can be loading its folders lazily)
+                parentQuery.bindValue(":id", parentId);
+                parentQuery.exec();
+                if (!parentQuery.next()) {
+                    break;
+                }
                 // se debe crear un nuevo nodo (para no compartir los hijos con el nodo original)
-                FolderItem *newparentItem = new FolderItem(parentItem->getData()); // padre que se a�adir� a la estructura de directorios filtrados
+                FolderItem *newparentItem = new FolderItem(FolderModel::folderItemData(parentQuery)); // padre que se a�adir� a la estructura de directorios filtrados
                 newparentItem->id = parentId;
 
-                newparentItem->originalItem = parentItem;
-
                 // si el modelo contiene al padre, se a�ade el item actual como hijo
                 if (filteredItems->contains(parentId)) {
                     filteredItems->value(parentId)->appendChild(item);
@@ -144,7 +146,7 @@ void YACReader::FolderQueryResultProcessor::setupFilteredModelData(QSqlQuery &sq
 
                 // variables de control del bucle, se avanza hacia el nodo padre
                 item = newparentItem;
-                parentId = parentItem->parentItem->id;
+                parentId = parentQuery.value("parentId").toULongLong();
             }
 
             // si el nodo es hijo de 1 y no hab�a sido previamente insertado como hijo, se a�ade como tal
@@ -9,6 +9,7 @@
 class FolderItem;
 class FolderModel;
 class QSqlQuery;
+class QSqlDatabase;
 
 namespace YACReader {
 
@@ -29,7 +30,7 @@ private:
 
     FolderModel *model;
 
-    void setupFilteredModelData(QSqlQuery &sqlquery);
+    void setupFilteredModelData(QSqlQuery &sqlquery, QSqlDatabase &db);
 };
 };
 
@@ -1,6 +1,8 @@
 #include "query_parser.h"
 
 #include <QVariant>
+#include <algorithm>
+#include <cctype>
 #include <type_traits>
 #include <numeric>
 #include <stdexcept>
@@ -26,6 +28,8 @@ int QueryParser::TreeNode::buildSqlString(std::string &sqlString, int bindPositi
             }
             sqlString += "UPPER(c.filename) LIKE UPPER(:bindPosition" + std::to_string(bindPosition) + ") OR ";
             sqlString += "UPPER(f.name) LIKE UPPER(:bindPosition" + std::to_string(bindPosition) + ")) ";
+        } else if (toLower(children[0].t) == "search") {
+            sqlString += "c.id IN (SELECT rowid FROM comic_search WHERE comic_search MATCH :bindPosition" + std::to_string(bindPosition) + ") ";
         } else if (isIn(fieldType(children[0].t), { FieldType::numeric, FieldType::boolean })) {
             sqlString += "ci." + children[0].t + " = :bindPosition" + std::to_string(bindPosition) + " ";
         } else if (fieldType(children[0].t) == FieldType::filename) {
@@ -67,6 +71,8 @@ int QueryParser::TreeNode::bindValues(QSqlQuery &selectQuery, int bindPosition)
             } else {
                 selectQuery.bindValue(QString::fromStdString(bind_string), std::stoi(value));
             }
+        } else if (toLower(children[0].t) == "search") {
+            selectQuery.bindValue(QString::fromStdString(bind_string), QString::fromStdString(searchIndexQuery(children[1].t)));
         } else {
             selectQuery.bindValue(QString::fromStdString(bind_string), QString::fromStdString("%%" + children[1].t + "%%"));
         }
@@ -80,7 +86,42 @@ int QueryParser::TreeNode::bindValues(QSqlQuery &selectQuery, int bindPosition)
     return bindPosition;
 }
 
-QueryParser::QueryParser()
+bool QueryParser::TreeNode::narrows(const TreeNode &other) const
+{
+    std::vector<const TreeNode *> terms, otherTerms;
+    if (!textTerms(terms) || !other.textTerms(otherTerms)) {
+        return false;
+    }
+
+    // text terms match substrings (LIKE) or word prefixes (search index), a term is narrowed by
+    // any term of the same field starting with it
+    return std::all_of(otherTerms.begin(), otherTerms.end(), [&terms](const TreeNode *otherTerm) {
+        auto otherValue = toLower(otherTerm->children[1].t);
+        return std::any_of(terms.begin(), terms.end(), [&](const TreeNode *term) {
+            return toLower(term->children[0].t) == toLower(otherTerm->children[0].t) && toLower(term->children[1].t).compare(0, otherValue.size(), otherValue) == 0;
+        });
+    });
+}
+
+bool QueryParser::TreeNode::textTerms(std::vector<const TreeNode *> &terms) const
+{
+    if (t == "and") {
+        return children[0].textTerms(terms) && children[1].textTerms(terms);
+    }
+
+    if (t == "token") {
+        auto location = toLower(children[0].t);
+        if (location == "all" || location == "search" || isIn(fieldType(location), { FieldType::text, FieldType::filename, FieldType::folder })) {
+            terms.push_back(this);
+            return true;
+        }
+    }
+
+    return false;
+}
+
+QueryParser::QueryParser(bool useSearchIndex)
+    : useSearchIndex(useSearchIndex)
 {
 }
 
@@ -105,6 +146,19 @@ std::string QueryParser::toLower(const std::string &string)
     return res;
 }
 
+std::string QueryParser::searchIndexQuery(const std::string &term)
+{
+    // the term is a single FTS5 string (quotes are escaped doubling them), its words must appear in sequence
+    std::string query("\"");
+    for (auto c : term) {
+        query += c;
+        if (c == '"') {
+            query += '"';
+        }
+    }
+    return query + "\" *";
+}
+
 std::string QueryParser::token(bool advance)
 {
     if (isEof()) {
@@ -229,7 +283,7 @@ QueryParser::TreeNode QueryParser::locationExpression()
 QueryParser::TreeNode QueryParser::baseToken()
 {
     if (tokenType() == Token::Type::quotedWord) {
-        return TreeNode("token", { TreeNode("all", {}), TreeNode(token(true), {}) });
+        return freeTextToken(token(true));
     }
 
     auto words(split(token(true), ':'));
@@ -243,5 +297,13 @@ QueryParser::TreeNode QueryParser::baseToken()
         return TreeNode("token", { TreeNode(loc, {}), TreeNode(join(words, ":"), {}) });
     }
 
-    return TreeNode("token", { TreeNode("all", {}), TreeNode(join(words, ":"), {}) });
+    return freeTextToken(join(words, ":"));
+}
+
+QueryParser::TreeNode QueryParser::freeTextToken(const std::string &term) const
+{
+    // terms without words (e.g. only punctuation) can't be looked up in the index
+    bool hasWords = std::any_of(term.begin(), term.end(), [](unsigned char c) { return std::isalnum(c) || c >= 0x80; });
+
+    return TreeNode("token", { TreeNode(useSearchIndex && hasWords ? "search" : "all", {}), TreeNode(term, {}) });
 }
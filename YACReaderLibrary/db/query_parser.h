@@ -28,7 +28,7 @@
  *    QSqlQuery selectQuery(db);
  *    std::string queryString("SELECT ... FROM ... WHERE ");
  *
- *    QueryParser parser;                   // Create the parser object
+ *    QueryParser parser(useSearchIndex);   // Create the parser object
  *    TreeNode result = parser.parse(expr); // Parse the query expression
  *
  *    result.buildSqlString(queryString);   // Append the SQL query to a string
@@ -37,6 +37,9 @@
  *    result.bindValues(selectQuery);       // Populate the SQL query variables
  *
  *    selectQuery.exec();
+ *
+ * Free text terms are looked up in the full text index (comic_search) if it is used, they match
+ * the words starting with the term. Otherwise they match any part of the text fields (LIKE).
  */
 class QueryParser
 {
@@ -52,13 +55,22 @@ public:
 
         int buildSqlString(std::string &sqlString, int bindPosition = 0) const;
         int bindValues(QSqlQuery &selectQuery, int bindPosition = 0) const;
+
+        // true if the results of this expression are a subset of the results of `other`, e.g. after typing
+        // more characters in the search box. Only conjunctions of text terms are compared, false otherwise.
+        bool narrows(const TreeNode &other) const;
+
+    private:
+        bool textTerms(std::vector<const TreeNode *> &terms) const;
     };
 
-    explicit QueryParser();
+    explicit QueryParser(bool useSearchIndex = false);
     TreeNode parse(const std::string &expr);
 
 private:
     static std::string toLower(const std::string &string);
+    // FTS5 query matching the words of `term`, the last one as a prefix
+    static std::string searchIndexQuery(const std::string &term);
 
     std::string token(bool advance = false);
     std::string lcaseToken(bool advance = false);
@@ -93,6 +105,9 @@ private:
     TreeNode notExpression();
     TreeNode locationExpression();
     TreeNode baseToken();
+    TreeNode freeTextToken(const std::string &term) const;
+
+    bool useSearchIndex;
 
     static const std::map<FieldType, std::vector<std::string>> fieldNames;
 };
@@ -0,0 +1,255 @@
+#include "remote_progress_sync.h"
+
+#include <QDateTime>
+#include <QHash>
+#include <QSqlQuery>
+#include <QStringList>
+#include <QVariant>
+
+#include <algorithm>
+#include <functional>
+
+namespace {
+// comic_info values changed by the sync
+struct StoredProgress {
+    QString hash;
+    int numPages;
+    int currentPage;
+    bool read;
+    bool hasBeenOpened;
+    QVariant lastTimeOpened;
+    int rating;
+    bool changed;
+};
+
+const char *progressColumns = "ci.id,ci.hash,ci.numPages,ci.currentPage,ci.read,ci.hasBeenOpened,ci.lastTimeOpened,ci.rating";
+
+StoredProgress storedProgress(const QSqlQuery &query, int firstColumn)
+{
+    StoredProgress progress;
+    progress.hash = query.value(firstColumn + 1).toString();
+    progress.numPages = query.value(firstColumn + 2).toInt();
+    progress.currentPage = query.value(firstColumn + 3).toInt();
+    progress.read = query.value(firstColumn + 4).toBool();
+    progress.hasBeenOpened = query.value(firstColumn + 5).toBool();
+    progress.lastTimeOpened = query.value(firstColumn + 6);
+    progress.rating = query.value(firstColumn + 7).toInt();
+    progress.changed = false;
+    return progress;
+}
+
+bool sameProgress(const StoredProgress &p1, const StoredProgress &p2)
+{
+    return p1.currentPage == p2.currentPage && p1.read == p2.read && p1.hasBeenOpened == p2.hasBeenOpened && p1.rating == p2.rating &&
+            p1.lastTimeOpened.isNull() == p2.lastTimeOpened.isNull() && p1.lastTimeOpened.toULongLong() == p2.lastTimeOpened.toULongLong();
+}
+
+// calls `select` with the [from, to) ranges of the chunks of `count` items
+void forEachChunk(int count, const std::function<void(int from, int to)> &select)
+{
+    for (int from = 0; from < count; from += RemoteProgressSync::chunkSize) {
+        select(from, qMin(from + RemoteProgressSync::chunkSize, count));
+    }
+}
+
+void writeProgress(const QHash<qulonglong, StoredProgress> &comicsInfo, QSqlDatabase &db)
+{
+    QVariantList ids, read, currentPage, hasBeenOpened, lastTimeOpened, rating;
+    for (auto comicInfo = comicsInfo.cbegin(); comicInfo != comicsInfo.cend(); ++comicInfo) {
+        if (!comicInfo->changed) {
+            continue;
+        }
+
+        ids.append(comicInfo.key());
+        read.append(comicInfo->read ? 1 : 0);
+        currentPage.append(comicInfo->currentPage);
+        hasBeenOpened.append(comicInfo->hasBeenOpened ? 1 : 0);
+        lastTimeOpened.append(comicInfo->lastTimeOpened);
+        rating.append(comicInfo->rating);
+    }
+
+    if (ids.isEmpty()) {
+        return;
+    }
+
+    QSqlQuery updateComicInfo(db);
+    updateComicInfo.prepare("UPDATE comic_info SET "
+                            "read = :read, "
+                            "currentPage = :currentPage, "
+                            "hasBeenOpened = :hasBeenOpened, "
+                            "lastTimeOpened = :lastTimeOpened, "
+                            "rating = :rating"
+                            " WHERE id = :id ");
+    updateComicInfo.bindValue(":read", read);
+    updateComicInfo.bindValue(":currentPage", currentPage);
+    updateComicInfo.bindValue(":hasBeenOpened", hasBeenOpened);
+    updateComicInfo.bindValue(":lastTimeOpened", lastTimeOpened);
+    updateComicInfo.bindValue(":id", ids);
+    updateComicInfo.bindValue(":rating", rating);
+    updateComicInfo.execBatch();
+}
+}
+
+QList<qulonglong> RemoteProgressSync::syncById(const QList<Progress> &comics, QSqlDatabase &db)
+{
+    QList<qulonglong> moreRecentComics;
+
+    QList<qulonglong> ids;
+    ids.reserve(comics.size());
+    for (const auto &comic : comics) {
+        ids.append(comic.comicId);
+    }
+    std::sort(ids.begin(), ids.end());
+    ids.erase(std::unique(ids.begin(), ids.end()), ids.end());
+
+    db.transaction();
+
+    // comic id -> comic_info id, comics with the same hash share their comic_info
+    QHash<qulonglong, qulonglong> comicInfoIds;
+    QHash<qulonglong, StoredProgress> comicsInfo;
+
+    QSqlQuery selectQuery(db);
+    selectQuery.setForwardOnly(true);
+    forEachChunk(ids.size(), [&](int from, int to) {
+        // ids are numbers, they can be part of the query
+        QStringList chunk;
+        for (int i = from; i < to; i++) {
+            chunk.append(QString::number(ids.at(i)));
+        }
+
+        selectQuery.exec(QString("SELECT c.id,%1 FROM comic c INNER JOIN comic_info ci ON (c.comicInfoId = ci.id) WHERE c.id IN (%2)").arg(progressColumns, chunk.join(",")));
+        while (selectQuery.next()) {
+            auto comicInfoId = selectQuery.value(1).toULongLong();
+            comicInfoIds.insert(selectQuery.value(0).toULongLong(), comicInfoId);
+            if (!comicsInfo.contains(comicInfoId)) {
+                comicsInfo.insert(comicInfoId, storedProgress(selectQuery, 1));
+            }
+        }
+    });
+    selectQuery.finish();
+
+    for (const auto &comic : comics) {
+        auto comicInfoId = comicInfoIds.find(comic.comicId);
+        if (comicInfoId == comicInfoIds.end()) {
+            continue;
+        }
+
+        auto &info = comicsInfo[comicInfoId.value()];
+        if (info.hash != comic.hash) {
+            continue;
+        }
+
+        const StoredProgress stored = info;
+        bool isMoreRecent = false;
+
+        // completion takes precedence over lastTimeOpened, if we just want to synchronize the lastest status we should use only lastTimeOpened
+        if ((info.currentPage > 1 && info.currentPage > comic.currentPage) || info.hasBeenOpened || (info.read && !comic.read)) {
+            isMoreRecent = true;
+        }
+
+        if (info.lastTimeOpened.toULongLong() > 0 && comic.lastTimeOpened == 0) {
+            isMoreRecent = true;
+        }
+
+        info.currentPage = qMax(info.currentPage, comic.currentPage);
+
+        if (info.currentPage == info.numPages)
+            info.read = true;
+
+        info.read = info.read || comic.read;
+
+        info.hasBeenOpened = info.hasBeenOpened || comic.currentPage > 0;
+
+        if (info.lastTimeOpened.toULongLong() < comic.lastTimeOpened && comic.lastTimeOpened > 0)
+            info.lastTimeOpened = comic.lastTimeOpened;
+
+        if (comic.rating > 0)
+            info.rating = comic.rating;
+
+        if (!sameProgress(stored, info)) {
+            info.changed = true;
+        }
+
+        if (isMoreRecent) {
+            moreRecentComics.append(comic.comicId);
+        }
+    }
+
+    writeProgress(comicsInfo, db);
+
+    db.commit();
+
+    return moreRecentComics;
+}
+
+void RemoteProgressSync::syncByHash(const QList<Progress> &comics, QSqlDatabase &db)
+{
+    QStringList hashes;
+    hashes.reserve(comics.size());
+    for (const auto &comic : comics) {
+        hashes.append(comic.hash);
+    }
+    hashes.removeDuplicates();
+
+    db.transaction();
+
+    QHash<QString, qulonglong> comicInfoIds;
+    QHash<qulonglong, StoredProgress> comicsInfo;
+
+    QSqlQuery selectQuery(db);
+    selectQuery.setForwardOnly(true);
+    forEachChunk(hashes.size(), [&](int from, int to) {
+        QStringList placeholders;
+        for (int i = from; i < to; i++) {
+            placeholders.append("?");
+        }
+
+        selectQuery.prepare(QString("SELECT %1 FROM comic_info ci WHERE ci.hash IN (%2)").arg(progressColumns, placeholders.join(",")));
+        for (int i = from; i < to; i++) {
+            selectQuery.addBindValue(hashes.at(i));
+        }
+        selectQuery.exec();
+
+        while (selectQuery.next()) {
+            auto comicInfoId = selectQuery.value(0).toULongLong();
+            auto progress = storedProgress(selectQuery, 0);
+            comicInfoIds.insert(progress.hash, comicInfoId);
+            comicsInfo.insert(comicInfoId, progress);
+        }
+    });
+    selectQuery.finish();
+
+    auto now = QDateTime::currentMSecsSinceEpoch() / 1000;
+
+    for (const auto &comic : comics) {
+        auto comicInfoId = comicInfoIds.find(comic.hash);
+        if (comicInfoId == comicInfoIds.end()) {
+            continue;
+        }
+
+        auto &info = comicsInfo[comicInfoId.value()];
+
+        if (comic.currentPage > 0) {
+            info.currentPage = comic.currentPage;
+
+            if (info.currentPage == info.numPages)
+                info.read = true;
+
+            info.hasBeenOpened = true;
+            info.changed = true;
+        }
+
+        if (comic.rating > 0) {
+            info.rating = comic.rating;
+            info.changed = true;
+        }
+
+        if (info.changed) {
+            info.lastTimeOpened = now;
+        }
+    }
+
+    writeProgress(comicsInfo, db);
+
+    db.commit();
+}
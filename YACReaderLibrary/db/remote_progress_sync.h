@@ -0,0 +1,36 @@
+#ifndef REMOTE_PROGRESS_SYNC_H
+#define REMOTE_PROGRESS_SYNC_H
+
+#include <QList>
+#include <QSqlDatabase>
+#include <QString>
+
+// Merges the reading progress sent by remote clients (/sync) into a library DB. All the comics of a payload
+// are loaded with a few queries (in chunks of ids/hashes), merged in memory and only the ones whose progress
+// changes are written, in a single batch inside one transaction.
+class RemoteProgressSync
+{
+public:
+    // progress of a comic in the client
+    struct Progress {
+        qulonglong comicId = 0; // comic.id, not used when the comics are looked up by hash
+        QString hash;
+        int currentPage = 0;
+        int rating = 0;
+        qulonglong lastTimeOpened = 0;
+        bool read = false;
+    };
+
+    // comics identified by their id in the library, the hash must match too. Returns the ids of the comics
+    // with more recent progress in the library than in the client.
+    static QList<qulonglong> syncById(const QList<Progress> &comics, QSqlDatabase &db);
+    // comics identified only by their hash (the client doesn't know the library they come from). lastTimeOpened
+    // is set to the current time only for the comics whose page or rating is updated, comics sent without
+    // progress are left untouched.
+    static void syncByHash(const QList<Progress> &comics, QSqlDatabase &db);
+
+    // SQLite limits the number of variables in a statement, hashes are looked up in chunks of this size
+    static constexpr int chunkSize = 500;
+};
+
+#endif // REMOTE_PROGRESS_SYNC_H
@@ -19,6 +19,8 @@
 #include "library_item.h"
 #include "comic_db.h"
 #include "data_base_management.h"
+#include "db_connection_pool.h"
+#include "remote_progress_sync.h"
 #include "folder.h"
 #include "yacreader_libraries.h"
 
@@ -37,15 +39,12 @@ YACReaderLibraries DBHelper::getLibraries()
 QList<LibraryItem *> DBHelper::getFolderSubfoldersFromLibrary(qulonglong libraryId, qulonglong folderId)
 {
     QString libraryPath = DBHelper::getLibraries().getPath(libraryId);
-    QString connectionName = "";
     QList<LibraryItem *> list;
     {
-        QSqlDatabase db = DataBaseManagement::loadDatabase(libraryPath + "/.yacreaderlibrary");
+        DBConnectionPool::Connection connection(libraryPath + "/.yacreaderlibrary");
+        QSqlDatabase &db = connection.database();
         list = DBHelper::getFoldersFromParent(folderId, db, false);
-
-        connectionName = db.connectionName();
     }
-    QSqlDatabase::removeDatabase(connectionName);
     return list;
 }
 
@@ -79,15 +78,12 @@ QList<LibraryItem *> DBHelper::getFolderComicsFromLibraryForReading(qulonglong l
 QList<LibraryItem *> DBHelper::getFolderComicsFromLibrary(qulonglong libraryId, qulonglong folderId, bool sort)
 {
     QString libraryPath = DBHelper::getLibraries().getPath(libraryId);
-    QString connectionName = "";
     QList<LibraryItem *> list;
     {
-        QSqlDatabase db = DataBaseManagement::loadDatabase(libraryPath + "/.yacreaderlibrary");
+        DBConnectionPool::Connection connection(libraryPath + "/.yacreaderlibrary");
+        QSqlDatabase &db = connection.database();
         list = DBHelper::getComicsFromParent(folderId, db, sort);
-
-        connectionName = db.connectionName();
     }
-    QSqlDatabase::removeDatabase(connectionName);
     return list;
 }
 
@@ -95,74 +91,68 @@ quint32 DBHelper::getNumChildrenFromFolder(qulonglong libraryId, qulonglong fold
 {
     QString libraryPath = DBHelper::getLibraries().getPath(libraryId);
     quint32 result = 0;
-    QString connectionName = "";
 
     {
-        QSqlDatabase db = DataBaseManagement::loadDatabase(libraryPath + "/.yacreaderlibrary");
+        DBConnectionPool::Connection connection(libraryPath + "/.yacreaderlibrary");
+        QSqlDatabase &db = connection.database();
 
-        QSqlQuery selectQuery(db);
-        selectQuery.prepare("SELECT count(*) FROM folder WHERE parentId = :parentId and id <> 1");
-        selectQuery.bindValue(":parentId", folderId);
-        selectQuery.exec();
+        {
+            DBConnectionPool::PreparedQuery selectQuery(db, "SELECT count(*) FROM folder WHERE parentId = :parentId and id <> 1");
+            selectQuery->bindValue(":parentId", folderId);
+            selectQuery->exec();
 
-        result += selectQuery.record().value(0).toULongLong();
+            result += selectQuery->record().value(0).toULongLong();
+        }
 
-        selectQuery.prepare("SELECT count(*) FROM comic c WHERE c.parentId = :parentId");
-        selectQuery.bindValue(":parentId", folderId);
-        selectQuery.exec();
+        {
+            DBConnectionPool::PreparedQuery selectQuery(db, "SELECT count(*) FROM comic c WHERE c.parentId = :parentId");
+            selectQuery->bindValue(":parentId", folderId);
+            selectQuery->exec();
 
-        result += selectQuery.record().value(0).toULongLong();
-        connectionName = db.connectionName();
+            result += selectQuery->record().value(0).toULongLong();
+        }
     }
 
-    QSqlDatabase::removeDatabase(connectionName);
-
     return result;
 }
 
 qulonglong DBHelper::getParentFromComicFolderId(qulonglong libraryId, qulonglong id)
 {
     QString libraryPath = DBHelper::getLibraries().getPath(libraryId);
-    QString connectionName = "";
     Folder f;
     {
-        QSqlDatabase db = DataBaseManagement::loadDatabase(libraryPath + "/.yacreaderlibrary");
+        DBConnectionPool::Connection connection(libraryPath + "/.yacreaderlibrary");
+        QSqlDatabase &db = connection.database();
 
         f = DBHelper::loadFolder(id, db);
-        connectionName = db.connectionName();
     }
 
-    QSqlDatabase::removeDatabase(connectionName);
     return f.parentId;
 }
 ComicDB DBHelper::getComicInfo(qulonglong libraryId, qulonglong id)
 {
     QString libraryPath = DBHelper::getLibraries().getPath(libraryId);
-    QString connectionName = "";
     ComicDB comic;
     {
-        QSqlDatabase db = DataBaseManagement::loadDatabase(libraryPath + "/.yacreaderlibrary");
+        DBConnectionPool::Connection connection(libraryPath + "/.yacreaderlibrary");
+        QSqlDatabase &db = connection.database();
 
         bool found;
         comic = DBHelper::loadComic(id, db, found);
-        connectionName = db.connectionName();
     }
-    QSqlDatabase::removeDatabase(connectionName);
     return comic;
 }
 
 QList<ComicDB> DBHelper::getSiblings(qulonglong libraryId, qulonglong parentId)
 {
     QString libraryPath = DBHelper::getLibraries().getPath(libraryId);
-    QString connectionName = "";
     QList<ComicDB> comics;
     {
-        QSqlDatabase db = DataBaseManagement::loadDatabase(libraryPath + "/.yacreaderlibrary");
+        DBConnectionPool::Connection connection(libraryPath + "/.yacreaderlibrary");
+        QSqlDatabase &db = connection.database();
         comics = DBHelper::getSortedComicsFromParent(parentId, db);
-        connectionName = db.connectionName();
     }
 
-    QSqlDatabase::removeDatabase(connectionName);
     return comics;
 }
 
@@ -171,22 +161,19 @@ QString DBHelper::getFolderName(qulonglong libraryId, qulonglong id)
     QString libraryPath = DBHelper::getLibraries().getPath(libraryId);
 
     QString name = "";
-    QString connectionName = "";
 
     {
-        QSqlDatabase db = DataBaseManagement::loadDatabase(libraryPath + "/.yacreaderlibrary");
-        QSqlQuery selectQuery(db); // TODO check
-        selectQuery.prepare("SELECT name FROM folder WHERE id = :id");
-        selectQuery.bindValue(":id", id);
-        selectQuery.exec();
-
-        if (selectQuery.next()) {
-            name = selectQuery.value(0).toString();
+        DBConnectionPool::Connection connection(libraryPath + "/.yacreaderlibrary");
+        QSqlDatabase &db = connection.database();
+        DBConnectionPool::PreparedQuery selectQuery(db, "SELECT name FROM folder WHERE id = :id"); // TODO check
+        selectQuery->bindValue(":id", id);
+        selectQuery->exec();
+
+        if (selectQuery->next()) {
+            name = selectQuery->value(0).toString();
         }
-        connectionName = db.connectionName();
     }
 
-    QSqlDatabase::removeDatabase(connectionName);
     return name;
 }
 QList<QString> DBHelper::getLibrariesNames()
@@ -205,10 +192,10 @@ QList<ComicDB> DBHelper::getLabelComics(qulonglong libraryId, qulonglong labelId
     QString libraryPath = DBHelper::getLibraries().getPath(libraryId);
 
     QList<ComicDB> list;
-    QString connectionName = "";
 
     {
-        QSqlDatabase db = DataBaseManagement::loadDatabase(libraryPath + "/.yacreaderlibrary");
+        DBConnectionPool::Connection connection(libraryPath + "/.yacreaderlibrary");
+        QSqlDatabase &db = connection.database();
         QSqlQuery selectQuery(db);
         selectQuery.prepare("SELECT c.id,c.fileName,ci.title,ci.currentPage,ci.numPages,ci.hash,ci.read,ci.coverSizeRatio "
                             "FROM comic c INNER JOIN comic_info ci ON (c.comicInfoId = ci.id) "
@@ -233,9 +220,7 @@ QList<ComicDB> DBHelper::getLabelComics(qulonglong libraryId, qulonglong labelId
 
             list.append(comic);
         }
-        connectionName = db.connectionName();
     }
-    QSqlDatabase::removeDatabase(connectionName);
 
     return list;
 }
@@ -246,10 +231,10 @@ QList<ComicDB> DBHelper::getFavorites(qulonglong libraryId)
     QList<ComicDB> list;
 
     const int FAV_ID = 1;
-    QString connectionName = "";
 
     {
-        QSqlDatabase db = DataBaseManagement::loadDatabase(libraryPath + "/.yacreaderlibrary");
+        DBConnectionPool::Connection connection(libraryPath + "/.yacreaderlibrary");
+        QSqlDatabase &db = connection.database();
         QSqlQuery selectQuery(db);
         selectQuery.prepare("SELECT c.id,c.fileName,ci.title,ci.currentPage,ci.numPages,ci.hash,ci.read,ci.coverSizeRatio "
                             "FROM comic c INNER JOIN comic_info ci ON (c.comicInfoId = ci.id) "
@@ -274,11 +259,7 @@ QList<ComicDB> DBHelper::getFavorites(qulonglong libraryId)
 
             list.append(comic);
         }
-
-        connectionName = db.connectionName();
     }
-    // TODO ?
-    QSqlDatabase::removeDatabase(connectionName);
 
     return list;
 }
@@ -287,10 +268,10 @@ QList<ComicDB> DBHelper::getReading(qulonglong libraryId)
 {
     QString libraryPath = DBHelper::getLibraries().getPath(libraryId);
     QList<ComicDB> list;
-    QString connectionName = "";
 
     {
-        QSqlDatabase db = DataBaseManagement::loadDatabase(libraryPath + "/.yacreaderlibrary");
+        DBConnectionPool::Connection connection(libraryPath + "/.yacreaderlibrary");
+        QSqlDatabase &db = connection.database();
         QSqlQuery selectQuery(db);
         selectQuery.prepare("SELECT c.id,c.parentId,c.fileName,ci.title,ci.currentPage,ci.numPages,ci.hash,ci.read,ci.coverSizeRatio "
                             "FROM comic c INNER JOIN comic_info ci ON (c.comicInfoId = ci.id) "
@@ -313,10 +294,7 @@ QList<ComicDB> DBHelper::getReading(qulonglong libraryId)
 
             list.append(comic);
         }
-        connectionName = db.connectionName();
     }
-    // TODO ?
-    QSqlDatabase::removeDatabase(connectionName);
 
     return list;
 }
@@ -324,11 +302,11 @@ QList<ComicDB> DBHelper::getReading(qulonglong libraryId)
 QList<ReadingList> DBHelper::getReadingLists(qulonglong libraryId)
 {
     QString libraryPath = DBHelper::getLibraries().getPath(libraryId);
-    QString connectionName = "";
     QList<ReadingList> list;
 
     {
-        QSqlDatabase db = DataBaseManagement::loadDatabase(libraryPath + "/.yacreaderlibrary");
+        DBConnectionPool::Connection connection(libraryPath + "/.yacreaderlibrary");
+        QSqlDatabase &db = connection.database();
 
         QSqlQuery selectQuery("SELECT * from reading_list WHERE parentId IS NULL ORDER BY name DESC", db);
 
@@ -352,10 +330,7 @@ QList<ReadingList> DBHelper::getReadingLists(qulonglong libraryId)
                 list.insert(i, item);
             }
         }
-        connectionName = db.connectionName();
     }
-    // TODO ?
-    QSqlDatabase::removeDatabase(connectionName);
 
     return list;
 }
@@ -364,10 +339,10 @@ QList<ComicDB> DBHelper::getReadingListFullContent(qulonglong libraryId, qulongl
 {
     QString libraryPath = DBHelper::getLibraries().getPath(libraryId);
     QList<ComicDB> list;
-    QString connectionName = "";
 
     {
-        QSqlDatabase db = DataBaseManagement::loadDatabase(libraryPath + "/.yacreaderlibrary");
+        DBConnectionPool::Connection connection(libraryPath + "/.yacreaderlibrary");
+        QSqlDatabase &db = connection.database();
         QList<qulonglong> ids;
         ids << readingListId;
 
@@ -434,12 +409,8 @@ QList<ComicDB> DBHelper::getReadingListFullContent(qulonglong libraryId, qulongl
                 list.append(comic);
             }
         }
-        connectionName = db.connectionName();
     }
 
-    // TODO ?
-    QSqlDatabase::removeDatabase(connectionName);
-
     return list;
 }
 
@@ -563,13 +534,11 @@ void DBHelper::update(ComicDB *comic, QSqlDatabase &db)
 void DBHelper::update(qulonglong libraryId, ComicInfo &comicInfo)
 {
     QString libraryPath = DBHelper::getLibraries().getPath(libraryId);
-    QString connectionName = "";
     {
-        QSqlDatabase db = DataBaseManagement::loadDatabase(libraryPath + "/.yacreaderlibrary");
+        DBConnectionPool::Connection connection(libraryPath + "/.yacreaderlibrary");
+        QSqlDatabase &db = connection.database();
         DBHelper::update(&comicInfo, db);
-        connectionName = db.connectionName();
     }
-    QSqlDatabase::removeDatabase(connectionName);
 }
 
 void DBHelper::update(ComicInfo *comicInfo, QSqlDatabase &db)
@@ -804,9 +773,9 @@ void DBHelper::updateChildrenInfo(QSqlDatabase &db)
 void DBHelper::updateProgress(qulonglong libraryId, const ComicInfo &comicInfo)
 {
     QString libraryPath = DBHelper::getLibraries().getPath(libraryId);
-    QString connectionName = "";
     {
-        QSqlDatabase db = DataBaseManagement::loadDatabase(libraryPath + "/.yacreaderlibrary");
+        DBConnectionPool::Connection connection(libraryPath + "/.yacreaderlibrary");
+        QSqlDatabase &db = connection.database();
 
         bool found;
         ComicDB comic = DBHelper::loadComic(comicInfo.id, db, found);
@@ -815,19 +784,15 @@ void DBHelper::updateProgress(qulonglong libraryId, const ComicInfo &comicInfo)
         comic.info.read = comic.info.read || comic.info.currentPage == comic.info.numPages;
 
         DBHelper::updateReadingRemoteProgress(comic.info, db);
-
-        connectionName = db.connectionName();
     }
-
-    QSqlDatabase::removeDatabase(connectionName);
 }
 
 void DBHelper::setComicAsReading(qulonglong libraryId, const ComicInfo &comicInfo)
 {
     QString libraryPath = DBHelper::getLibraries().getPath(libraryId);
-    QString connectionName = "";
     {
-        QSqlDatabase db = DataBaseManagement::loadDatabase(libraryPath + "/.yacreaderlibrary");
+        DBConnectionPool::Connection connection(libraryPath + "/.yacreaderlibrary");
+        QSqlDatabase &db = connection.database();
 
         bool found;
         ComicDB comic = DBHelper::loadComic(comicInfo.id, db, found);
@@ -835,39 +800,34 @@ void DBHelper::setComicAsReading(qulonglong libraryId, const ComicInfo &comicInf
         comic.info.read = comic.info.read || comic.info.currentPage == comic.info.numPages;
 
         DBHelper::updateReadingRemoteProgress(comic.info, db);
-        connectionName = db.connectionName();
     }
-    QSqlDatabase::removeDatabase(connectionName);
 }
 
 void DBHelper::updateReadingRemoteProgress(const ComicInfo &comicInfo, QSqlDatabase &db)
 {
-    QSqlQuery updateComicInfo(db);
-    updateComicInfo.prepare("UPDATE comic_info SET "
-                            "read = :read, "
-                            "currentPage = :currentPage, "
-                            "hasBeenOpened = :hasBeenOpened, "
-                            "lastTimeOpened = :lastTimeOpened, "
-                            "rating = :rating"
-                            " WHERE id = :id ");
-
-    updateComicInfo.bindValue(":read", comicInfo.read ? 1 : 0);
-    updateComicInfo.bindValue(":currentPage", comicInfo.currentPage);
-    updateComicInfo.bindValue(":hasBeenOpened", comicInfo.hasBeenOpened ? 1 : 0);
-    updateComicInfo.bindValue(":lastTimeOpened", QDateTime::currentMSecsSinceEpoch() / 1000);
-    updateComicInfo.bindValue(":id", comicInfo.id);
-    updateComicInfo.bindValue(":rating", comicInfo.rating);
-    updateComicInfo.exec();
+    DBConnectionPool::PreparedQuery updateComicInfo(db, "UPDATE comic_info SET "
+                                                        "read = :read, "
+                                                        "currentPage = :currentPage, "
+                                                        "hasBeenOpened = :hasBeenOpened, "
+                                                        "lastTimeOpened = :lastTimeOpened, "
+                                                        "rating = :rating"
+                                                        " WHERE id = :id ");
 
-    updateComicInfo.clear();
+    updateComicInfo->bindValue(":read", comicInfo.read ? 1 : 0);
+    updateComicInfo->bindValue(":currentPage", comicInfo.currentPage);
+    updateComicInfo->bindValue(":hasBeenOpened", comicInfo.hasBeenOpened ? 1 : 0);
+    updateComicInfo->bindValue(":lastTimeOpened", QDateTime::currentMSecsSinceEpoch() / 1000);
+    updateComicInfo->bindValue(":id", comicInfo.id);
+    updateComicInfo->bindValue(":rating", comicInfo.rating);
+    updateComicInfo->exec();
 }
 
 void DBHelper::updateFromRemoteClient(qulonglong libraryId, const ComicInfo &comicInfo)
 {
     QString libraryPath = DBHelper::getLibraries().getPath(libraryId);
-    QString connectionName = "";
     {
-        QSqlDatabase db = DataBaseManagement::loadDatabase(libraryPath + "/.yacreaderlibrary");
+        DBConnectionPool::Connection connection(libraryPath + "/.yacreaderlibrary");
+        QSqlDatabase &db = connection.database();
 
         bool found;
         ComicDB comic = DBHelper::loadComic(comicInfo.id, db, found);
@@ -890,9 +850,7 @@ void DBHelper::updateFromRemoteClient(qulonglong libraryId, const ComicInfo &com
 
             DBHelper::updateReadingRemoteProgress(comic.info, db);
         }
-        connectionName = db.connectionName();
     }
-    QSqlDatabase::removeDatabase(connectionName);
 }
 
 void DBHelper::updateFromRemoteClientWithHash(const ComicInfo &comicInfo)
@@ -900,13 +858,13 @@ void DBHelper::updateFromRemoteClientWithHash(const ComicInfo &comicInfo)
     YACReaderLibraries libraries = DBHelper::getLibraries();
 
     QStringList names = libraries.getNames();
-    QString connectionName = "";
 
     foreach (QString name, names) {
         QString libraryPath = DBHelper::getLibraries().getPath(libraries.getId(name));
 
         {
-            QSqlDatabase db = DataBaseManagement::loadDatabase(libraryPath + "/.yacreaderlibrary");
+            DBConnectionPool::Connection connection(libraryPath + "/.yacreaderlibrary");
+            QSqlDatabase &db = connection.database();
             ComicInfo info = loadComicInfo(comicInfo.hash, db);
 
             if (!info.existOnDb) {
@@ -929,9 +887,7 @@ void DBHelper::updateFromRemoteClientWithHash(const ComicInfo &comicInfo)
                 info.rating = comicInfo.rating;
 
             DBHelper::update(&info, db);
-            connectionName = db.connectionName();
         }
-        QSqlDatabase::removeDatabase(connectionName);
     }
 }
 
@@ -939,80 +895,37 @@ QMap<qulonglong, QList<ComicDB>> DBHelper::updateFromRemoteClient(const QMap<qul
 {
     QMap<qulonglong, QList<ComicDB>> moreRecentComics;
 
-    foreach (qulonglong libraryId, comics.keys()) {
-        QList<ComicDB> libraryMoreRecentComics;
-
-        QString libraryPath = DBHelper::getLibraries().getPath(libraryId);
-
-        QString connectionName = "";
-        {
-            QSqlDatabase db = DataBaseManagement::loadDatabase(libraryPath + "/.yacreaderlibrary");
-
-            db.transaction();
-
-            QSqlQuery updateComicInfo(db);
-            updateComicInfo.prepare("UPDATE comic_info SET "
-                                    "read = :read, "
-                                    "currentPage = :currentPage, "
-                                    "hasBeenOpened = :hasBeenOpened, "
-                                    "lastTimeOpened = :lastTimeOpened, "
-                                    "rating = :rating"
-                                    " WHERE id = :id ");
-
-            foreach (ComicInfo comicInfo, comics[libraryId]) {
-                bool found;
-                ComicDB comic = DBHelper::loadComic(comicInfo.id, db, found);
-
-                if (comic.info.hash == comicInfo.hash) {
-                    bool isMoreRecent = false;
-
-                    // completion takes precedence over lastTimeOpened, if we just want to synchronize the lastest status we should use only lastTimeOpened
-                    if ((comic.info.currentPage > 1 && comic.info.currentPage > comicInfo.currentPage) || comic.info.hasBeenOpened || (comic.info.read && !comicInfo.read)) {
-                        isMoreRecent = true;
-                    }
-
-                    if (comic.info.lastTimeOpened.toULongLong() > 0 && comicInfo.lastTimeOpened.toULongLong() == 0) {
-                        isMoreRecent = true;
-                    }
-
-                    comic.info.currentPage = qMax(comic.info.currentPage, comicInfo.currentPage);
-
-                    if (comic.info.currentPage == comic.info.numPages)
-                        comic.info.read = true;
-
-                    comic.info.read = comic.info.read || comicInfo.read;
-
-                    comic.info.hasBeenOpened = comic.info.hasBeenOpened || comicInfo.currentPage > 0;
+    YACReaderLibraries libraries = DBHelper::getLibraries();
 
-                    if (comic.info.lastTimeOpened.toULongLong() < comicInfo.lastTimeOpened.toULongLong() && comicInfo.lastTimeOpened.toULongLong() > 0)
-                        comic.info.lastTimeOpened = comicInfo.lastTimeOpened;
+    for (auto libraryComics = comics.cbegin(); libraryComics != comics.cend(); ++libraryComics) {
+        QString libraryPath = libraries.getPath(libraryComics.key());
+        if (libraryPath.isEmpty()) {
+            continue;
+        }
 
-                    if (comicInfo.rating > 0)
-                        comic.info.rating = comicInfo.rating;
+        QList<RemoteProgressSync::Progress> progress;
+        progress.reserve(libraryComics->size());
+        for (const auto &comicInfo : *libraryComics) {
+            RemoteProgressSync::Progress comicProgress;
+            comicProgress.comicId = comicInfo.id;
+            comicProgress.hash = comicInfo.hash;
+            comicProgress.currentPage = comicInfo.currentPage;
+            comicProgress.rating = comicInfo.rating;
+            comicProgress.lastTimeOpened = comicInfo.lastTimeOpened.toULongLong();
+            comicProgress.read = comicInfo.read;
+            progress.append(comicProgress);
+        }
 
-                    updateComicInfo.bindValue(":read", comic.info.read ? 1 : 0);
-                    updateComicInfo.bindValue(":currentPage", comic.info.currentPage);
-                    updateComicInfo.bindValue(":hasBeenOpened", comic.info.hasBeenOpened ? 1 : 0);
-                    updateComicInfo.bindValue(":lastTimeOpened", comic.info.lastTimeOpened);
-                    updateComicInfo.bindValue(":id", comic.info.id);
-                    updateComicInfo.bindValue(":rating", comic.info.rating);
-                    updateComicInfo.exec();
+        {
+            DBConnectionPool::Connection connection(libraryPath + "/.yacreaderlibrary");
+            QSqlDatabase &db = connection.database();
 
-                    if (isMoreRecent) {
-                        libraryMoreRecentComics.append(comic);
-                    }
-                }
-            }
+            auto moreRecentComicIds = RemoteProgressSync::syncById(progress, db);
 
-            if (!libraryMoreRecentComics.isEmpty()) {
-                moreRecentComics[libraryId] = libraryMoreRecentComics;
+            if (!moreRecentComicIds.isEmpty()) {
+                moreRecentComics[libraryComics.key()] = DBHelper::loadComics(moreRecentComicIds, db);
             }
-
-            db.commit();
-            connectionName = db.connectionName();
         }
-
-        QSqlDatabase::removeDatabase(connectionName);
     }
 
     return moreRecentComics;
@@ -1020,63 +933,31 @@ QMap<qulonglong, QList<ComicDB>> DBHelper::updateFromRemoteClient(const QMap<qul
 
 void DBHelper::updateFromRemoteClientWithHash(const QList<ComicInfo> &comics)
 {
-    YACReaderLibraries libraries = DBHelper::getLibraries();
-
-    QStringList names = libraries.getNames();
-
-    foreach (QString name, names) {
-        QString libraryPath = DBHelper::getLibraries().getPath(libraries.getId(name));
-        QString connectionName = "";
-        {
-            QSqlDatabase db = DataBaseManagement::loadDatabase(libraryPath + "/.yacreaderlibrary");
-
-            db.transaction();
-
-            QSqlQuery updateComicInfo(db);
-            updateComicInfo.prepare("UPDATE comic_info SET "
-                                    "read = :read, "
-                                    "currentPage = :currentPage, "
-                                    "hasBeenOpened = :hasBeenOpened, "
-                                    "lastTimeOpened = :lastTimeOpened, "
-                                    "rating = :rating"
-                                    " WHERE id = :id ");
-
-            foreach (ComicInfo comicInfo, comics) {
-                ComicInfo info = loadComicInfo(comicInfo.hash, db);
-
-                if (!info.existOnDb) {
-                    continue;
-                }
-
-                if (comicInfo.currentPage > 0) {
-                    info.currentPage = comicInfo.currentPage;
-
-                    if (info.currentPage == info.numPages)
-                        info.read = true;
-
-                    info.hasBeenOpened = true;
+    if (comics.isEmpty()) {
+        return;
+    }
 
-                    if (info.lastTimeOpened.toULongLong() < comicInfo.lastTimeOpened.toULongLong())
-                        info.lastTimeOpened = comicInfo.lastTimeOpened;
-                }
+    QList<RemoteProgressSync::Progress> progress;
+    progress.reserve(comics.size());
+    for (const auto &comicInfo : comics) {
+        RemoteProgressSync::Progress comicProgress;
+        comicProgress.hash = comicInfo.hash;
+        comicProgress.currentPage = comicInfo.currentPage;
+        comicProgress.rating = comicInfo.rating;
+        comicProgress.lastTimeOpened = comicInfo.lastTimeOpened.toULongLong();
+        progress.append(comicProgress);
+    }
 
-                if (comicInfo.rating > 0) {
-                    info.rating = comicInfo.rating;
-                }
+    YACReaderLibraries libraries = DBHelper::getLibraries();
 
-                updateComicInfo.bindValue(":read", info.read ? 1 : 0);
-                updateComicInfo.bindValue(":currentPage", info.currentPage);
-                updateComicInfo.bindValue(":hasBeenOpened", info.hasBeenOpened ? 1 : 0);
-                updateComicInfo.bindValue(":lastTimeOpened", QDateTime::currentMSecsSinceEpoch() / 1000);
-                updateComicInfo.bindValue(":id", info.id);
-                updateComicInfo.bindValue(":rating", info.rating);
-                updateComicInfo.exec();
-            }
+    foreach (QString name, libraries.getNames()) {
+        QString libraryPath = libraries.getPath(name);
+        {
+            DBConnectionPool::Connection connection(libraryPath + "/.yacreaderlibrary");
+            QSqlDatabase &db = connection.database();
 
-            db.commit();
-            connectionName = db.connectionName();
+            RemoteProgressSync::syncByHash(progress, db);
         }
-        QSqlDatabase::removeDatabase(connectionName);
     }
 }
 
@@ -1478,10 +1359,10 @@ QList<LibraryItem *> DBHelper::getComicsFromParent(qulonglong parentId, QSqlData
 QList<Label> DBHelper::getLabels(qulonglong libraryId)
 {
     QString libraryPath = DBHelper::getLibraries().getPath(libraryId);
-    QString connectionName = "";
     QList<Label> labels;
     {
-        QSqlDatabase db = DataBaseManagement::loadDatabase(libraryPath + "/.yacreaderlibrary");
+        DBConnectionPool::Connection connection(libraryPath + "/.yacreaderlibrary");
+        QSqlDatabase &db = connection.database();
 
         QSqlQuery selectQuery("SELECT * FROM label ORDER BY ordering,name", db); // TODO add some kind of
         QSqlRecord record = selectQuery.record();
@@ -1517,9 +1398,7 @@ QList<Label> DBHelper::getLabels(qulonglong libraryId)
                 }
             }
         }
-        connectionName = db.connectionName();
     }
-    QSqlDatabase::removeDatabase(connectionName);
 
     return labels;
 }
@@ -1651,12 +1530,11 @@ ComicDB DBHelper::loadComic(qulonglong id, QSqlDatabase &db, bool &found)
 {
     ComicDB comic;
 
-    QSqlQuery selectQuery(db);
-    selectQuery.prepare("select c.id,c.parentId,c.fileName,c.path,ci.hash from comic c inner join comic_info ci on (c.comicInfoId = ci.id) where c.id = :id");
-    selectQuery.bindValue(":id", id);
-    selectQuery.exec();
+    DBConnectionPool::PreparedQuery selectQuery(db, "select c.id,c.parentId,c.fileName,c.path,ci.hash from comic c inner join comic_info ci on (c.comicInfoId = ci.id) where c.id = :id");
+    selectQuery->bindValue(":id", id);
+    selectQuery->exec();
 
-    QSqlRecord record = selectQuery.record();
+    QSqlRecord record = selectQuery->record();
 
     int parentId = record.indexOf("parentId");
     int name = record.indexOf("fileName");
@@ -1664,11 +1542,11 @@ ComicDB DBHelper::loadComic(qulonglong id, QSqlDatabase &db, bool &found)
     int hash = record.indexOf("hash");
 
     comic.id = id;
-    if (selectQuery.next()) {
-        comic.parentId = selectQuery.value(parentId).toULongLong();
-        comic.name = selectQuery.value(name).toString();
-        comic.path = selectQuery.value(path).toString();
-        comic.info = DBHelper::loadComicInfo(selectQuery.value(hash).toString(), db);
+    if (selectQuery->next()) {
+        comic.parentId = selectQuery->value(parentId).toULongLong();
+        comic.name = selectQuery->value(name).toString();
+        comic.path = selectQuery->value(path).toString();
+        comic.info = DBHelper::loadComicInfo(selectQuery->value(hash).toString(), db);
         found = true;
     } else {
         found = false;
@@ -1677,6 +1555,41 @@ ComicDB DBHelper::loadComic(qulonglong id, QSqlDatabase &db, bool &found)
     return comic;
 }
 
+QList<ComicDB> DBHelper::loadComics(const QList<qulonglong> &ids, QSqlDatabase &db)
+{
+    QList<ComicDB> comics;
+
+    QSqlQuery selectQuery(db);
+    selectQuery.setForwardOnly(true);
+    for (int from = 0; from < ids.size(); from += RemoteProgressSync::chunkSize) {
+        // ids are numbers, they can be part of the query
+        QStringList chunk;
+        for (int i = from; i < qMin(from + RemoteProgressSync::chunkSize, ids.size()); i++) {
+            chunk.append(QString::number(ids.at(i)));
+        }
+
+        selectQuery.exec("SELECT c.id AS comicId,c.parentId,c.fileName,c.path,ci.* FROM comic c INNER JOIN comic_info ci ON (c.comicInfoId = ci.id) WHERE c.id IN (" + chunk.join(",") + ")");
+
+        QSqlRecord record = selectQuery.record();
+        int comicId = record.indexOf("comicId");
+        int parentId = record.indexOf("parentId");
+        int name = record.indexOf("fileName");
+        int path = record.indexOf("path");
+
+        while (selectQuery.next()) {
+            ComicDB comic;
+            comic.id = selectQuery.value(comicId).toULongLong();
+            comic.parentId = selectQuery.value(parentId).toULongLong();
+            comic.name = selectQuery.value(name).toString();
+            comic.path = selectQuery.value(path).toString();
+            comic.info = DBHelper::getComicInfoFromQuery(selectQuery);
+            comics.append(comic);
+        }
+    }
+
+    return comics;
+}
+
 ComicDB DBHelper::loadComic(QString cname, QString cpath, QString chash, QSqlDatabase &database)
 {
     ComicDB comic;
@@ -1701,13 +1614,12 @@ ComicInfo DBHelper::loadComicInfo(QString hash, QSqlDatabase &db)
 {
     ComicInfo comicInfo;
 
-    QSqlQuery findComicInfo(db);
-    findComicInfo.prepare("SELECT * FROM comic_info WHERE hash = :hash");
-    findComicInfo.bindValue(":hash", hash);
-    findComicInfo.exec();
+    DBConnectionPool::PreparedQuery findComicInfo(db, "SELECT * FROM comic_info WHERE hash = :hash");
+    findComicInfo->bindValue(":hash", hash);
+    findComicInfo->exec();
 
-    if (findComicInfo.next()) {
-        comicInfo = getComicInfoFromQuery(findComicInfo);
+    if (findComicInfo->next()) {
+        comicInfo = getComicInfoFromQuery(*findComicInfo);
     } else
         comicInfo.existOnDb = false;
 
@@ -95,6 +95,8 @@ public:
     static Folder loadFolder(qulonglong id, QSqlDatabase &db);
     static Folder loadFolder(const QString &folderName, qulonglong parentId, QSqlDatabase &db);
     static ComicDB loadComic(qulonglong id, QSqlDatabase &db, bool &found);
+    // comics with the given ids, in any order
+    static QList<ComicDB> loadComics(const QList<qulonglong> &ids, QSqlDatabase &db);
     static ComicDB loadComic(QString cname, QString cpath, QString chash, QSqlDatabase &database);
     static ComicInfo loadComicInfo(QString hash, QSqlDatabase &db);
     static ComicInfo getComicInfoFromQuery(QSqlQuery &query, const QString &idKey = "id");
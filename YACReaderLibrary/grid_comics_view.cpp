@@ -13,6 +13,7 @@
 #include "yacreader_comics_selection_helper.h"
 #include "yacreader_comic_info_helper.h"
 #include "current_comic_view_helper.h"
+#include "cover_image_provider.h"
 
 GridComicsView::GridComicsView(QWidget *parent)
     : ComicsView(parent), filterEnabled(false)
@@ -137,6 +138,9 @@ GridComicsView::GridComicsView(QWidget *parent)
 
     updateCoversSizeInContext(YACREADER_MIN_COVER_WIDTH, ctxt);
 
+    // the engine takes ownership of the provider
+    view->engine()->addImageProvider("cover", new YACReader::CoverImageProvider());
+
     view->setSource(QUrl("qrc:/qml/GridComicsView.qml"));
 
     auto rootObject = dynamic_cast<QObject *>(view->rootObject());
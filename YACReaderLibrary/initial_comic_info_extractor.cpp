@@ -11,7 +11,7 @@ using namespace YACReader;
 bool InitialComicInfoExtractor::crash = false;
 
 InitialComicInfoExtractor::InitialComicInfoExtractor(QString fileSource, QString target, int coverPage, bool getXMLMetadata)
-    : _fileSource(fileSource), _target(target), _numPages(0), _coverPage(coverPage), getXMLMetadata(getXMLMetadata), _xmlInfoData()
+    : _fileSource(fileSource), _target(target), _numPages(0), _coverPage(coverPage), getXMLMetadata(getXMLMetadata), _xmlInfoData(), _writeCoverOnExtract(true)
 {
 }
 
@@ -116,7 +116,7 @@ void InitialComicInfoExtractor::extract()
         QLOG_WARN() << "Extracting cover: empty comic " << _fileSource;
         _cover.load(":/images/notCover.png");
         if (_target != "") {
-            _cover.save(_target);
+            storeCover(_cover, -1);
         }
     } else {
         if (_coverPage > _numPages) {
@@ -163,5 +163,14 @@ void InitialComicInfoExtractor::saveCover(const QString &path, const QImage &cov
             scaled = cover.scaledToWidth(480, Qt::SmoothTransformation);
         }
     }
-    scaled.save(_target, 0, 75);
+    storeCover(scaled, 75);
+}
+
+void InitialComicInfoExtractor::storeCover(const QImage &cover, int quality)
+{
+    _coverData = CoverStore::encode(cover, quality);
+
+    if (_writeCoverOnExtract) {
+        CoverStore::writeFile(_target, _coverData);
+    }
 }
@@ -3,6 +3,8 @@
 
 #include <QtGui>
 
+#include "cover_store.h"
+
 namespace YACReader {
 class InitialComicInfoExtractor : public QObject
 {
@@ -22,7 +24,10 @@ private:
     int getXMLMetadata;
     static bool crash;
     QByteArray _xmlInfoData;
+    bool _writeCoverOnExtract;
+    CoverStore::EncodedCover _coverData;
     void saveCover(const QString &path, const QImage &cover);
+    void storeCover(const QImage &cover, int quality);
 
 public slots:
     void extract();
@@ -30,6 +35,10 @@ public slots:
     QPixmap getCover() { return QPixmap::fromImage(_cover); }
     QPair<int, int> getOriginalCoverSize() { return _coverSize; }
     QByteArray getXMLInfoRawData();
+    // when disabled, extract() doesn't touch the target and keeps the encoded cover in memory (see getCoverData)
+    void setWriteCoverOnExtract(bool write) { _writeCoverOnExtract = write; }
+    // all the sizes of the cover (see CoverStore)
+    CoverStore::EncodedCover getCoverData() { return _coverData; }
 signals:
     void openingError(QProcess::ProcessError error);
 };
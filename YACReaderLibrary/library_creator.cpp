@@ -17,6 +17,8 @@
 #include "comic.h"
 #include "pdf_comic.h"
 #include "yacreader_global.h"
+#include "concurrent_queue.h"
+#include "cover_store.h"
 
 #include "QsLog.h"
 
@@ -25,13 +27,40 @@
 using namespace std;
 using namespace YACReader;
 
+struct LibraryCreator::ScanItem {
+    enum Kind { NewComic,
+                Removal };
+    Kind kind;
+
+    // NewComic, found by the directory walk
+    QString relativePath;
+    QFileInfo fileInfo;
+    QList<Folder> folders; // copy of _currentPathFolders when the comic was found
+
+    // NewComic, filled by a worker
+    bool ready = false; // guarded by _scanMutex
+    QString hash;
+    bool extracted = false;
+    int coverPage = 1;
+    int numPages = 0;
+    QPair<int, int> originalCoverSize = { 0, 0 };
+    QByteArray xmlInfoData;
+    CoverStore::EncodedCover coverData;
+
+    // Removal
+    bool isDir = false;
+    qulonglong id = 0;
+};
+
 //--------------------------------------------------------------------------------
 LibraryCreator::LibraryCreator(QSettings *settings)
-    : creation(false), partialUpdate(false), settings(settings)
+    : _scanWorkers(1), _importXMLMetadata(false), creation(false), partialUpdate(false), settings(settings)
 {
     _nameFilter << Comic::comicExtensions;
 }
 
+LibraryCreator::~LibraryCreator() = default;
+
 void LibraryCreator::createLibrary(const QString &source, const QString &target)
 {
     creation = true;
@@ -130,6 +159,10 @@ void LibraryCreator::run()
         // se crean los directorios .yacreaderlibrary y .yacreaderlibrary/covers
         QDir dir;
         dir.mkpath(_target + "/covers");
+        // shared with the views of the library, they find the new covers in its index (listed again, the folder could
+        // have had a library before)
+        _covers = CoverStore::forLibrary(_target);
+        _covers->loadIndex();
 
         // se crea la base de datos .yacreaderlibrary/library.ydb
         {
@@ -146,9 +179,13 @@ void LibraryCreator::run()
             /*QSqlQuery pragma("PRAGMA foreign_keys = ON",_database);*/
             _database.transaction();
             // se crea la librería
+            startPipeline();
             create(QDir(_source));
+            finishPipeline();
 
             DBHelper::updateChildrenInfo(_database);
+            // built at once after adding all the comics, it is faster than updating it for every comic
+            DataBaseManagement::createSearchIndex(_database);
 
             _database.commit();
             _database.close();
@@ -179,11 +216,33 @@ void LibraryCreator::run()
             pragma.exec();
             _database.transaction();
 
+            // libraries created before the search index existed
+            if (!DataBaseManagement::hasSearchIndex(_database)) {
+                DataBaseManagement::createSearchIndex(_database);
+            }
+
+            _covers = CoverStore::forLibrary(_target);
+            // covers stored by older versions
+            int migratedCovers = _covers->migrate();
+            if (migratedCovers > 0) {
+                QLOG_INFO() << "Covers moved to the sharded covers folder:" << migratedCovers;
+            }
+            // covers could have been changed outside the app, the index is listed again when the whole library is updated
+            if (!partialUpdate) {
+                _covers->loadIndex();
+            }
+
+            startPipeline();
             if (partialUpdate) {
                 update(QDir(_sourceFolder));
             } else {
                 update(QDir(_source));
             }
+            finishPipeline();
+
+            if (!partialUpdate) {
+                createMissingCoverSizes();
+            }
 
             if (partialUpdate) {
                 auto folder = DBHelper::updateChildrenInfo(folderDestinationModelIndex.data(FolderModel::IdRole).toULongLong(), _database);
@@ -223,17 +282,26 @@ void LibraryCreator::stop()
 }
 
 // retorna el id del ultimo de los folders
-qulonglong LibraryCreator::insertFolders()
+qulonglong LibraryCreator::insertFolders(QList<Folder> &folders)
 {
     auto _database = QSqlDatabase::database(_databaseConnection);
     QList<Folder>::iterator i;
     int currentId = 0;
     Folder currentParent;
-    for (i = _currentPathFolders.begin(); i != _currentPathFolders.end(); ++i) {
+    for (i = folders.begin(); i != folders.end(); ++i) {
         if (!(i->knownId)) {
             i->setFather(currentId);
             i->setManga(currentParent.isManga());
-            currentId = DBHelper::insert(&(*i), _database); // insertFolder(currentId,*i);
+            // the pipeline works on copies of the current path, so the folders it has already inserted need to be remembered
+            auto insertedFolder = _insertedFolderIds.constFind(i->path);
+            if (insertedFolder != _insertedFolderIds.constEnd()) {
+                currentId = insertedFolder.value();
+            } else {
+                currentId = DBHelper::insert(&(*i), _database); // insertFolder(currentId,*i);
+                if (_scanQueue) {
+                    _insertedFolderIds.insert(i->path, currentId);
+                }
+            }
             i->setId(currentId);
         } else {
             currentId = i->id;
@@ -274,49 +342,242 @@ void LibraryCreator::create(QDir dir)
             _currentPathFolders.pop_back();
         } else {
             QLOG_TRACE() << "Parsing file" << fileInfo.filePath();
-            insertComic(relativePath, fileInfo);
+            processComic(relativePath, fileInfo);
         }
     }
 }
 
 bool LibraryCreator::checkCover(const QString &hash)
 {
-    return QFile::exists(_target + "/covers/" + hash + ".jpg");
+    return _covers->contains(hash);
 }
 
-void LibraryCreator::insertComic(const QString &relativePath, const QFileInfo &fileInfo)
+QString LibraryCreator::computeHash(const QFileInfo &fileInfo)
 {
-    auto _database = QSqlDatabase::database(_databaseConnection);
-    // Se calcula el hash del cómic
-
     QCryptographicHash crypto(QCryptographicHash::Sha1);
     QFile file(fileInfo.absoluteFilePath());
     file.open(QFile::ReadOnly);
     crypto.addData(file.read(524288));
     file.close();
     // hash Sha1 del primer 0.5MB + filesize
-    QString hash = QString(crypto.result().toHex().constData()) + QString::number(fileInfo.size());
-    ComicDB comic = DBHelper::loadComic(fileInfo.fileName(), relativePath, hash, _database);
+    return QString(crypto.result().toHex().constData()) + QString::number(fileInfo.size());
+}
+
+void LibraryCreator::processComic(const QString &relativePath, const QFileInfo &fileInfo)
+{
+    if (!_scanQueue) {
+        insertComic(relativePath, fileInfo);
+        return;
+    }
+
+    auto item = std::make_shared<ScanItem>();
+    item->kind = ScanItem::NewComic;
+    item->relativePath = relativePath;
+    item->fileInfo = fileInfo;
+    item->folders = _currentPathFolders;
+    _pendingItems.push_back(item);
+
+    _scanQueue->enqueue([this, item] {
+        prepareComic(*item);
+        {
+            std::lock_guard<std::mutex> lock(_scanMutex);
+            item->ready = true;
+        }
+        _scanItemReady.notify_all();
+    });
+
+    writePendingItems(false);
+}
+
+void LibraryCreator::removeItem(LibraryItem *item)
+{
+    if (!_scanQueue) {
+        auto _database = QSqlDatabase::database(_databaseConnection);
+        DBHelper::removeFromDB(item, _database);
+        return;
+    }
+
+    // removals are queued too, so the DB sees the same sequence of changes as a sequential scan
+    auto scanItem = std::make_shared<ScanItem>();
+    scanItem->kind = ScanItem::Removal;
+    scanItem->ready = true;
+    scanItem->isDir = item->isDir();
+    scanItem->id = item->id;
+    _pendingItems.push_back(scanItem);
+}
+
+void LibraryCreator::startPipeline()
+{
+    _insertedFolderIds.clear();
+    _knownCoverPages.clear();
+
+    _importXMLMetadata = settings->value(IMPORT_COMIC_INFO_XML_METADATA, false).toBool();
+
+    _scanWorkers = settings->value(NUMBER_OF_LIBRARY_SCAN_WORKERS, QThread::idealThreadCount()).toInt();
+    if (_scanWorkers <= 1) {
+        return;
+    }
+
+    // workers can't use the DB connection, they decide which covers need to be extracted using this snapshot
+    auto _database = QSqlDatabase::database(_databaseConnection);
+    QSqlQuery query("SELECT hash, coverPage FROM comic_info", _database);
+    while (query.next()) {
+        _knownCoverPages.insert(query.value(0).toString(), query.value(1).toInt());
+    }
+
+    QLOG_INFO() << "Scanning with" << _scanWorkers << "workers";
+    _scanQueue = std::make_unique<ConcurrentQueue>(_scanWorkers);
+}
+
+void LibraryCreator::finishPipeline()
+{
+    if (!_scanQueue) {
+        return;
+    }
+
+    if (stopRunning) {
+        _scanQueue->cancelPending();
+    } else {
+        writePendingItems(true);
+    }
+
+    // joins the workers, running jobs are allowed to finish
+    _scanQueue.reset();
+    _pendingItems.clear();
+    _insertedFolderIds.clear();
+    _knownCoverPages.clear();
+}
+
+// covers stored before the smaller sizes existed get them in the next full update
+void LibraryCreator::createMissingCoverSizes()
+{
+    auto hashes = _covers->incompleteCovers();
+    if (hashes.isEmpty() || stopRunning) {
+        return;
+    }
+
+    QLOG_INFO() << "Creating the missing sizes of" << hashes.size() << "covers";
+
+    ConcurrentQueue queue(std::max(1, _scanWorkers));
+    for (const auto &hash : hashes) {
+        queue.enqueue([this, hash] {
+            if (!stopRunning) {
+                _covers->createSizes(hash);
+            }
+        });
+    }
+    queue.waitAll();
+}
+
+// runs in a worker thread, it must not use the DB
+void LibraryCreator::prepareComic(ScanItem &item)
+{
+    item.hash = computeHash(item.fileInfo);
+
+    auto knownCoverPage = _knownCoverPages.constFind(item.hash);
+    if (knownCoverPage != _knownCoverPages.constEnd() && checkCover(item.hash)) {
+        // covers stored before the smaller sizes existed
+        if (!_covers->containsAllSizes(item.hash)) {
+            _covers->createSizes(item.hash);
+        }
+        return;
+    }
+
+    item.coverPage = knownCoverPage != _knownCoverPages.constEnd() ? knownCoverPage.value() : 1;
+
+    YACReader::InitialComicInfoExtractor ie(QDir::cleanPath(item.fileInfo.absoluteFilePath()), _covers->filePath(item.hash), item.coverPage, _importXMLMetadata);
+    ie.setWriteCoverOnExtract(false);
+    ie.extract();
+
+    item.extracted = true;
+    item.numPages = ie.getNumPages();
+    item.originalCoverSize = ie.getOriginalCoverSize();
+    item.xmlInfoData = ie.getXMLInfoRawData();
+    item.coverData = ie.getCoverData();
+}
+
+// writes the ready items in the order they were queued, without wait it only blocks when too many items are pending
+void LibraryCreator::writePendingItems(bool wait)
+{
+    const auto maxPendingItems = static_cast<std::size_t>(4 * _scanWorkers);
+
+    while (!_pendingItems.empty() && !stopRunning) {
+        auto item = _pendingItems.front();
+        {
+            std::unique_lock<std::mutex> lock(_scanMutex);
+            if (!item->ready) {
+                if (!wait && _pendingItems.size() < maxPendingItems) {
+                    return;
+                }
+                _scanItemReady.wait(lock, [&item] { return item->ready; });
+            }
+        }
+        _pendingItems.pop_front();
+        writeItem(*item);
+    }
+}
+
+void LibraryCreator::writeItem(ScanItem &item)
+{
+    auto _database = QSqlDatabase::database(_databaseConnection);
+
+    if (item.kind == ScanItem::Removal) {
+        if (item.isDir) {
+            Folder folder;
+            folder.id = item.id;
+            DBHelper::removeFromDB(&folder, _database);
+        } else {
+            ComicDB comic;
+            comic.id = item.id;
+            DBHelper::removeFromDB(&comic, _database);
+        }
+        return;
+    }
+
+    writeComic(item, item.folders);
+}
+
+// inserts a comic found by the scan, the comics extracted by a worker reuse its results when they match what the DB says
+void LibraryCreator::writeComic(ScanItem &item, QList<Folder> &folders)
+{
+    auto _database = QSqlDatabase::database(_databaseConnection);
+
+    ComicDB comic = DBHelper::loadComic(item.fileInfo.fileName(), item.relativePath, item.hash, _database);
     int numPages = 0;
     QPair<int, int> originalCoverSize = { 0, 0 };
-    bool exists = checkCover(hash);
-
-    YACReader::InitialComicInfoExtractor ie(QDir::cleanPath(fileInfo.absoluteFilePath()), _target + "/covers/" + hash + ".jpg", comic.info.coverPage.toInt(), settings->value(IMPORT_COMIC_INFO_XML_METADATA, false).toBool());
+    QByteArray xmlInfoData;
+    bool exists = checkCover(item.hash);
 
     if (!(comic.hasCover() && exists)) {
-        ie.extract();
-        numPages = ie.getNumPages();
-        originalCoverSize = ie.getOriginalCoverSize();
+        if (item.extracted && item.coverPage == comic.info.coverPage.toInt()) {
+            if (!item.coverData.isEmpty() && !_covers->write(item.hash, item.coverData)) {
+                QLOG_WARN() << "Unable to write cover" << _covers->filePath(item.hash);
+            }
+            numPages = item.numPages;
+            originalCoverSize = item.originalCoverSize;
+            xmlInfoData = item.xmlInfoData;
+        } else {
+            YACReader::InitialComicInfoExtractor ie(QDir::cleanPath(item.fileInfo.absoluteFilePath()), _covers->filePath(item.hash), comic.info.coverPage.toInt(), _importXMLMetadata);
+            ie.setWriteCoverOnExtract(false);
+            ie.extract();
+            if (!ie.getCoverData().isEmpty()) {
+                _covers->write(item.hash, ie.getCoverData());
+            }
+            numPages = ie.getNumPages();
+            originalCoverSize = ie.getOriginalCoverSize();
+            xmlInfoData = ie.getXMLInfoRawData();
+        }
+
         if (numPages > 0) {
-            emit(comicAdded(relativePath, _target + "/covers/" + hash + ".jpg"));
+            emit(comicAdded(item.relativePath, _covers->filePath(item.hash, CoverStore::Grid)));
         }
     }
 
     if (numPages > 0 || exists) {
-        // en este punto sabemos que todos los folders que hay en _currentPath, deberían estar añadidos a la base de datos
-        insertFolders();
+        // en este punto sabemos que todos los folders que hay en folders, deberían estar añadidos a la base de datos
+        insertFolders(folders);
 
-        bool parsed = YACReader::parseXMLIntoInfo(ie.getXMLInfoRawData(), comic.info);
+        bool parsed = YACReader::parseXMLIntoInfo(xmlInfoData, comic.info);
 
         comic.info.numPages = numPages;
         if (originalCoverSize.second > 0) {
@@ -324,13 +585,26 @@ void LibraryCreator::insertComic(const QString &relativePath, const QFileInfo &f
             comic.info.coverSizeRatio = static_cast<float>(originalCoverSize.first) / originalCoverSize.second;
         }
 
-        comic.parentId = _currentPathFolders.last().id;
-        comic.info.manga = _currentPathFolders.last().isManga();
+        comic.parentId = folders.last().id;
+        comic.info.manga = folders.last().isManga();
 
         DBHelper::insert(&comic, _database, parsed);
     }
 }
 
+void LibraryCreator::insertComic(const QString &relativePath, const QFileInfo &fileInfo)
+{
+    ScanItem item;
+    item.kind = ScanItem::NewComic;
+    item.relativePath = relativePath;
+    item.fileInfo = fileInfo;
+    // Se calcula el hash del cómic
+    item.hash = computeHash(fileInfo);
+
+    // the folders are inserted in _currentPathFolders, so the next comics of the folder reuse their ids
+    writeComic(item, _currentPathFolders);
+}
+
 void LibraryCreator::update(QDir dirS)
 {
     auto _database = QSqlDatabase::database(_databaseConnection);
@@ -392,7 +666,7 @@ void LibraryCreator::update(QDir dirS)
                     qDeleteAll(listD);
                     return;
                 }
-                DBHelper::removeFromDB(listD.at(j), (_database));
+                removeItem(listD.at(j));
             }
             updated = true;
         }
@@ -436,7 +710,7 @@ void LibraryCreator::update(QDir dirS)
 
                     QString path = QDir::cleanPath(fileInfoS.absoluteFilePath()).remove(_source);
 #endif
-                    insertComic(path, fileInfoS);
+                    processComic(path, fileInfoS);
                 }
             }
             updated = true;
@@ -481,7 +755,7 @@ void LibraryCreator::update(QDir dirS)
                 {
                     if (nameS != "/.yacreaderlibrary") {
                         // QLOG_WARN() << "dir source > dest" << nameS << nameD;
-                        DBHelper::removeFromDB(fileInfoD, _database);
+                        removeItem(fileInfoD);
                         j++;
                     } else
                         i++; // skip library directory
@@ -510,7 +784,7 @@ void LibraryCreator::update(QDir dirS)
                     i++;
                 } else if (fileInfoD->isDir()) // delete this folder from library
                 {
-                    DBHelper::removeFromDB(fileInfoD, _database);
+                    removeItem(fileInfoD);
                     j++;
                 } else // both are files  //BUG on windows (no case sensitive)
                 {
@@ -529,12 +803,12 @@ void LibraryCreator::update(QDir dirS)
 #else
                         QString path = QDir::cleanPath(fileInfoS.absoluteFilePath()).remove(_source);
 #endif
-                        insertComic(path, fileInfoS);
+                        processComic(path, fileInfoS);
                         i++;
                     } else {
                         if (comparation > 0) // delete thumbnail
                         {
-                            DBHelper::removeFromDB(fileInfoD, _database);
+                            removeItem(fileInfoD);
                             j++;
                         } else // same file
                         {
@@ -15,14 +15,25 @@
 #include <QSqlDatabase>
 #include <QModelIndex>
 
+#include <condition_variable>
+#include <deque>
+#include <memory>
+#include <mutex>
+
 #include "folder.h"
 #include "comic_db.h"
 
+namespace YACReader {
+class ConcurrentQueue;
+class CoverStore;
+}
+
 class LibraryCreator : public QThread
 {
     Q_OBJECT
 public:
     LibraryCreator(QSettings *settings);
+    ~LibraryCreator() override;
     void createLibrary(const QString &source, const QString &target);
     void updateLibrary(const QString &source, const QString &target);
     void updateFolder(const QString &source, const QString &target, const QString &folder, const QModelIndex &dest);
@@ -40,13 +51,36 @@ private:
     QStringList _nameFilter;
     QString _databaseConnection;
     QList<Folder> _currentPathFolders; // lista de folders en el orden en el que están siendo explorados, el último es el folder actual
+    std::shared_ptr<YACReader::CoverStore> _covers;
     // recursive method
     void create(QDir currentDirectory);
     void update(QDir currentDirectory);
     void run() override;
-    qulonglong insertFolders(); // devuelve el id del último folder añadido (último en la ruta)
     bool checkCover(const QString &hash);
+    static QString computeHash(const QFileInfo &fileInfo);
+    void processComic(const QString &relativePath, const QFileInfo &fileInfo);
+    void removeItem(LibraryItem *item);
     void insertComic(const QString &relativePath, const QFileInfo &fileInfo);
+
+    // parallel scan pipeline: the directory walk queues comics, hashing and cover extraction run
+    // on a pool of workers and the results are written to the DB in the same order as the walk found them
+    struct ScanItem;
+    int _scanWorkers;
+    bool _importXMLMetadata;
+    std::unique_ptr<YACReader::ConcurrentQueue> _scanQueue;
+    std::deque<std::shared_ptr<ScanItem>> _pendingItems;
+    std::mutex _scanMutex;
+    std::condition_variable _scanItemReady;
+    QHash<QString, int> _knownCoverPages; // hash -> cover page of the comics already in the DB, read only while the pipeline runs
+    QHash<QString, qulonglong> _insertedFolderIds; // path -> id of the folders inserted by the pipeline
+    void startPipeline();
+    void finishPipeline();
+    void prepareComic(ScanItem &item);
+    void writePendingItems(bool wait);
+    void writeItem(ScanItem &item);
+    void writeComic(ScanItem &item, QList<Folder> &folders);
+    void createMissingCoverSizes();
+    qulonglong insertFolders(QList<Folder> &folders); // devuelve el id del último folder añadido (último en la ruta)
     // qulonglong insertFolder(qulonglong parentId,const Folder & folder);
     // qulonglong insertComic(const Comic & comic);
     bool stopRunning;
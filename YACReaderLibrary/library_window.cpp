@@ -22,6 +22,7 @@
 #include <future>
 
 #include "data_base_management.h"
+#include "db_connection_pool.h"
 #include "yacreader_global.h"
 #include "no_libraries_widget.h"
 #include "import_widget.h"
@@ -44,6 +45,7 @@
 #include "help_about_dialog.h"
 #include "server_config_dialog.h"
 #include "comic_model.h"
+#include "cover_store.h"
 #include "yacreader_tool_bar_stretch.h"
 #include "yacreader_table_view.h"
 
@@ -1229,7 +1231,9 @@ void LibraryWindow::createConnections()
 #else
     connect(searchEdit, &YACReaderSearchLineEdit::filterChanged, this, &LibraryWindow::setSearchFilter);
 #endif
+    qRegisterMetaType<ComicItemList *>("ComicItemList *");
     connect(&comicQueryResultProcessor, &ComicQueryResultProcessor::newData, this, &LibraryWindow::setComicSearchFilterData);
+    connect(&comicQueryResultProcessor, &ComicQueryResultProcessor::moreData, this, &LibraryWindow::appendComicSearchFilterData);
     qRegisterMetaType<FolderItem *>("FolderItem *");
     qRegisterMetaType<QMap<unsigned long long int, FolderItem *> *>("QMap<unsigned long long int, FolderItem *> *");
     connect(folderQueryResultProcessor.get(), &FolderQueryResultProcessor::newData, this, &LibraryWindow::setFolderSearchFilterData);
@@ -1993,9 +1997,10 @@ void LibraryWindow::saveSelectedCoversTo()
     QFileDialog saveDialog;
     QString folderPath = saveDialog.getExistingDirectory(this, tr("Save covers"), QStandardPaths::writableLocation(QStandardPaths::DesktopLocation));
     if (!folderPath.isEmpty()) {
+        auto covers = YACReader::CoverStore::forLibrary(foldersModel->getDatabase());
         QModelIndexList comics = getSelectedComics();
         foreach (QModelIndex comic, comics) {
-            QString origin = comic.data(ComicModel::CoverPathRole).toString().remove("file:///").remove("file:");
+            QString origin = covers->coverPath(comic.data(ComicModel::HashRole).toString());
             QString destination = QDir(folderPath).filePath(comic.data(ComicModel::FileNameRole).toString() + ".jpg");
 
             QLOG_DEBUG() << "From : " << origin;
@@ -2016,6 +2021,8 @@ void LibraryWindow::checkMaxNumLibraries()
 
 void LibraryWindow::selectSubfolder(const QModelIndex &mi, int child)
 {
+    if (foldersModel->canFetchMore(mi))
+        foldersModel->fetchMore(mi);
     QModelIndex dest = foldersModel->index(child, 0, mi);
     foldersView->setCurrentIndex(dest);
     navigationController->selectedFolder(dest);
@@ -2197,6 +2204,8 @@ void LibraryWindow::deleteCurrentLibrary()
     // selectedLibrary->setCurrentIndex(0);
     path = path + "/.yacreaderlibrary";
 
+    DBConnectionPool::invalidate(path);
+
     QDir d(path);
     d.removeRecursively();
     if (libraries.isEmpty()) // no more libraries available.
@@ -2416,14 +2425,14 @@ void LibraryWindow::setSearchFilter(QString filter)
 {
     if (!filter.isEmpty()) {
         folderQueryResultProcessor->createModelData(filter, true);
-        comicQueryResultProcessor.createModelData(filter, foldersModel->getDatabase());
+        comicQueryResultProcessor.createModelData(filter, foldersModel->getDatabase(), settings->value(SEARCH_RESULTS_LIMIT, DEFAULT_SEARCH_RESULTS_LIMIT).toInt());
     } else if (status == LibraryWindow::Searching) { // if no searching, then ignore this
         clearSearchFilter();
         navigationController->loadPreviousStatus();
     }
 }
 
-void LibraryWindow::setComicSearchFilterData(QList<ComicItem *> *data, const QString &databasePath)
+void LibraryWindow::setComicSearchFilterData(ComicItemList *data, const QString &databasePath)
 {
     status = LibraryWindow::Searching;
 
@@ -2440,14 +2449,33 @@ void LibraryWindow::setComicSearchFilterData(QList<ComicItem *> *data, const QSt
     }
 }
 
+void LibraryWindow::appendComicSearchFilterData(ComicItemList *data, const QString &databasePath)
+{
+    // the search could have been cleared or the library changed while the results were on their way
+    if (status != LibraryWindow::Searching || foldersModel->getDatabase() != databasePath) {
+        delete data;
+        return;
+    }
+
+    bool wasEmpty = comicsModel->rowCount() == 0;
+    comicsModel->appendModelData(data);
+
+    if (wasEmpty && comicsModel->rowCount() > 0) {
+        contentViewsManager->showComicsView();
+        disableComicsActions(false);
+    }
+}
+
 void LibraryWindow::setFolderSearchFilterData(QMap<unsigned long long, FolderItem *> *filteredItems, FolderItem *root)
 {
+    foldersModel->fetchFolders(root);
     foldersModelProxy->setFilterData(filteredItems, root);
     foldersView->expandAll();
 }
 
 void LibraryWindow::clearSearchFilter()
 {
+    comicQueryResultProcessor.cancel();
     foldersModelProxy->clear();
     contentViewsManager->comicsView->enableFilterMode(false);
     foldersView->collapseAll();
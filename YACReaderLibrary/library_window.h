@@ -358,7 +358,8 @@ public slots:
     void toNormal();
     void toFullScreen();
     void setSearchFilter(QString filter);
-    void setComicSearchFilterData(QList<ComicItem *> *, const QString &);
+    void setComicSearchFilterData(ComicItemList *, const QString &);
+    void appendComicSearchFilterData(ComicItemList *, const QString &);
     void setFolderSearchFilterData(QMap<unsigned long long int, FolderItem *> *filteredItems, FolderItem *root);
     void clearSearchFilter();
     void showProperties();
@@ -239,6 +239,8 @@ int main(int argc, char **argv)
 
     QLOG_INFO() << "YACReaderLibrary starting";
 
+    YACReaderLibraries::watchSettings();
+
 #ifdef SERVER_RELEASE
     QSettings *settings = new QSettings(YACReader::getSettingsPath() + "/YACReaderLibrary.ini", QSettings::IniFormat);
     settings->beginGroup("libraryConfig");
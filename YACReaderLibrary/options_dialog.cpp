@@ -86,6 +86,39 @@ OptionsDialog::OptionsDialog(QWidget *parent)
     comicInfoXMLBoxLayout->addWidget(comicInfoXMLCheckbox);
     comicInfoXMLBox->setLayout(comicInfoXMLBoxLayout);
 
+    auto libraryScanBox = new QGroupBox(tr("Library scan"));
+
+    auto scanWorkersLabel = new QLabel(tr("Number of threads used to process comics (1 = sequential)"));
+    scanWorkersSpinBox = new QSpinBox();
+    scanWorkersSpinBox->setRange(1, 64);
+    connect(scanWorkersSpinBox, QOverload<int>::of(&QSpinBox::valueChanged), this,
+            [=](int value) {
+                settings->setValue(NUMBER_OF_LIBRARY_SCAN_WORKERS, value);
+            });
+
+    auto libraryScanBoxLayout = new QHBoxLayout();
+    libraryScanBoxLayout->addWidget(scanWorkersLabel);
+    libraryScanBoxLayout->addStretch();
+    libraryScanBoxLayout->addWidget(scanWorkersSpinBox);
+    libraryScanBox->setLayout(libraryScanBoxLayout);
+
+    auto searchBox = new QGroupBox(tr("Search"));
+
+    auto searchResultsLimitLabel = new QLabel(tr("Maximum number of comics found"));
+    searchResultsLimitSpinBox = new QSpinBox();
+    searchResultsLimitSpinBox->setRange(100, 1000000);
+    searchResultsLimitSpinBox->setSingleStep(500);
+    connect(searchResultsLimitSpinBox, QOverload<int>::of(&QSpinBox::valueChanged), this,
+            [=](int value) {
+                settings->setValue(SEARCH_RESULTS_LIMIT, value);
+            });
+
+    auto searchBoxLayout = new QHBoxLayout();
+    searchBoxLayout->addWidget(searchResultsLimitLabel);
+    searchBoxLayout->addStretch();
+    searchBoxLayout->addWidget(searchResultsLimitSpinBox);
+    searchBox->setLayout(searchBoxLayout);
+
     // grid view background config
     useBackgroundImageCheck = new QCheckBox(tr("Enable background image"));
 
@@ -152,6 +185,8 @@ OptionsDialog::OptionsDialog(QWidget *parent)
     generalLayout->addWidget(shortcutsBox);
     generalLayout->addWidget(apiKeyBox);
     generalLayout->addWidget(comicInfoXMLBox);
+    generalLayout->addWidget(libraryScanBox);
+    generalLayout->addWidget(searchBox);
     generalLayout->addStretch();
 
     tabWidget->addTab(generalW, tr("General"));
@@ -186,6 +221,8 @@ void OptionsDialog::restoreOptions(QSettings *settings)
     startToTrayCheckbox->setEnabled(trayIconCheckbox->isChecked());
 
     comicInfoXMLCheckbox->setChecked(settings->value(IMPORT_COMIC_INFO_XML_METADATA, false).toBool());
+    scanWorkersSpinBox->setValue(settings->value(NUMBER_OF_LIBRARY_SCAN_WORKERS, QThread::idealThreadCount()).toInt());
+    searchResultsLimitSpinBox->setValue(settings->value(SEARCH_RESULTS_LIMIT, DEFAULT_SEARCH_RESULTS_LIMIT).toInt());
 
     bool useBackgroundImage = settings->value(USE_BACKGROUND_IMAGE_IN_GRID_VIEW, true).toBool();
 
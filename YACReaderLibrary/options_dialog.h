@@ -38,6 +38,8 @@ private:
     QCheckBox *trayIconCheckbox;
     QCheckBox *startToTrayCheckbox;
     QCheckBox *comicInfoXMLCheckbox;
+    QSpinBox *scanWorkersSpinBox;
+    QSpinBox *searchResultsLimitSpinBox;
 };
 
 #endif
@@ -2,6 +2,7 @@
 
 #include "data_base_management.h"
 #include "initial_comic_info_extractor.h"
+#include "cover_store.h"
 #include "yacreader_field_edit.h"
 #include "yacreader_field_plain_text_edit.h"
 #include "db_helper.h"
@@ -768,8 +769,15 @@ void PropertiesDialog::save()
 
     if (sequentialEditing) {
         if (coverChanged) {
-            InitialComicInfoExtractor ie(basePath + comics[currentComicIndex].path, basePath + "/.yacreaderlibrary/covers/" + comics[currentComicIndex].info.hash + ".jpg", comics[currentComicIndex].info.coverPage.toInt());
+            // written through the store shared by the views, so its index knows about the new cover
+            auto covers = CoverStore::forLibrary(basePath + "/.yacreaderlibrary");
+            const auto &hash = comics[currentComicIndex].info.hash;
+            InitialComicInfoExtractor ie(basePath + comics[currentComicIndex].path, covers->filePath(hash), comics[currentComicIndex].info.coverPage.toInt());
+            ie.setWriteCoverOnExtract(false);
             ie.extract();
+            if (!ie.getCoverData().isEmpty()) {
+                covers->write(hash, ie.getCoverData());
+            }
 
             if (ie.getOriginalCoverSize().second > 0) {
                 comics[currentComicIndex].info.originalCoverSize = QString("%1x%2").arg(ie.getOriginalCoverSize().first).arg(ie.getOriginalCoverSize().second);
@@ -274,12 +274,12 @@ SplitView {
                     width: coverWidth
                     height: coverHeight
                     anchors {horizontalCenter: parent.horizontalCenter; top: realCell.top; topMargin: 0}
-                    source: cover_path
+                    source: cover_image
+                    sourceSize: Qt.size(coverWidth, coverHeight) // decoded at the size of the cell
                     fillMode: Image.PreserveAspectCrop
                     smooth: true
-                    mipmap: true
                     asynchronous : true
-                    cache: false //TODO clear cache only when it is needed
+                    cache: false // covers are cached by the cover image provider
 
                 }
 
@@ -23,7 +23,7 @@ ComicController::ComicController() { }
 void ComicController::service(HttpRequest &request, HttpResponse &response)
 {
     HttpSession session = Static::sessionStore->getSession(request, response, false);
-    YACReaderHttpSession *ySession = Static::yacreaderSessionStore->getYACReaderSessionHttpSession(session.getId());
+    auto ySession = Static::yacreaderSessionStore->getYACReaderSessionHttpSession(session.getId());
 
     QString path = QUrl::fromPercentEncoding(request.getPath()).toUtf8();
     QStringList pathElements = path.split('/');
@@ -52,26 +52,10 @@ void ComicController::service(HttpRequest &request, HttpResponse &response)
     if (!remoteComic)
         ySession->setDownloadedComic(comic.info.hash);
 
-    Comic *comicFile = FactoryComic::newComic(libraries.getPath(libraryId) + comic.path);
-
-    if (comicFile != nullptr) {
-        QThread *thread = nullptr;
-
-        thread = new QThread();
-
-        comicFile->moveToThread(thread);
-
-        connect(comicFile, QOverload<>::of(&Comic::errorOpening), thread, &QThread::quit);
-        connect(comicFile, QOverload<QString>::of(&Comic::errorOpening), thread, &QThread::quit);
-        connect(comicFile, &Comic::imagesLoaded, thread, &QThread::quit);
-        connect(thread, &QThread::started, comicFile, &Comic::process);
-        connect(thread, &QThread::finished, thread, &QObject::deleteLater);
-
-        comicFile->load(libraries.getPath(libraryId) + comic.path);
-
-        if (thread != nullptr)
-            thread->start();
+    // comics already open in other sessions are shared, they are only extracted once
+    auto comicFile = Static::yacreaderSessionStore->openComic(comic.info.hash, libraries.getPath(libraryId) + comic.path);
 
+    if (!comicFile.isNull()) {
         if (remoteComic) {
             QLOG_TRACE() << "remote comic requested";
             ySession->setCurrentRemoteComic(comic.id, comicFile);
@@ -1,9 +1,12 @@
+#include <QFileInfo>
 #include <QPainter>
 
 #include "covercontroller.h"
 #include "db_helper.h" //get libraries
 #include "yacreader_libraries.h"
+#include "cover_store.h"
 #include "yacreader_http_session.h"
+#include "yacreader_http_response_helper.h"
 
 #include "template.h"
 #include "../static.h"
@@ -17,7 +20,7 @@ CoverController::CoverController() { }
 void CoverController::service(HttpRequest &request, HttpResponse &response)
 {
     HttpSession session = Static::sessionStore->getSession(request, response, false);
-    YACReaderHttpSession *ySession = Static::yacreaderSessionStore->getYACReaderSessionHttpSession(session.getId());
+    auto ySession = Static::yacreaderSessionStore->getYACReaderSessionHttpSession(session.getId());
 
     response.setHeader("Content-Type", "image/jpeg");
     response.setHeader("Connection", "close");
@@ -50,7 +53,24 @@ void CoverController::service(HttpRequest &request, HttpResponse &response)
     //	file.close();
     //}
 
-    QImage img(libraries.getPath(libraryName) + "/.yacreaderlibrary/covers/" + fileName);
+    // <hash>.jpg, v1 covers are composed at 160x240 at most so the grid size is enough
+    QString hash = fileName.left(fileName.lastIndexOf('.'));
+    QString coverPath = YACReader::CoverStore::forLibrary(libraries.getPath(libraryName) + "/.yacreaderlibrary")->coverPath(hash, YACReader::CoverStore::Grid);
+
+    // v1 clients get the cover composed to fit their screen, it still can be skipped if their copy is current
+    auto eTag = YACReaderHttpResponseHelper::fileETag(coverPath);
+    if (!eTag.isEmpty()) {
+        eTag.insert(eTag.size() - 1, QByteArray(folderCover ? "-f" : "") + ySession->getDisplayType().toLatin1());
+    }
+    auto lastModified = QFileInfo(coverPath).lastModified();
+    YACReaderHttpResponseHelper::setCacheHeaders(response, eTag, lastModified, "no-cache");
+
+    if (YACReaderHttpResponseHelper::isNotModified(request, eTag, lastModified)) {
+        YACReaderHttpResponseHelper::writeNotModified(response);
+        return;
+    }
+
+    QImage img(coverPath);
     if (!img.isNull()) {
 
         int width = 80, height = 120;
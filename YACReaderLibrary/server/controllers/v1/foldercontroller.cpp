@@ -33,7 +33,7 @@ void FolderController::service(HttpRequest &request, HttpResponse &response)
     bool showlessInfoPerFolder = settings->value(REMOTE_BROWSE_PERFORMANCE_WORKAROUND, false).toBool();
 
     HttpSession session = Static::sessionStore->getSession(request, response, false);
-    YACReaderHttpSession *ySession = Static::yacreaderSessionStore->getYACReaderSessionHttpSession(session.getId());
+    auto ySession = Static::yacreaderSessionStore->getYACReaderSessionHttpSession(session.getId());
 
     response.setHeader("Content-Type", "text/html; charset=utf-8");
     response.setHeader("Connection", "close");
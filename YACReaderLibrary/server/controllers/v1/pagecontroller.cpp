@@ -7,8 +7,6 @@
 #include "yacreader_http_session.h"
 
 #include <QDataStream>
-#include <QPointer>
-
 #include <QsLog.h>
 
 using stefanfrings::HttpRequest;
@@ -20,7 +18,7 @@ PageController::PageController() { }
 void PageController::service(HttpRequest &request, HttpResponse &response)
 {
     HttpSession session = Static::sessionStore->getSession(request, response, false);
-    YACReaderHttpSession *ySession = Static::yacreaderSessionStore->getYACReaderSessionHttpSession(session.getId());
+    auto ySession = Static::yacreaderSessionStore->getYACReaderSessionHttpSession(session.getId());
 
     QString path = QUrl::fromPercentEncoding(request.getPath()).toUtf8();
     bool remote = path.endsWith("remote");
@@ -34,7 +32,7 @@ void PageController::service(HttpRequest &request, HttpResponse &response)
 
     // qDebug("lib name : %s",pathElements.at(2).data());
 
-    Comic *comicFile;
+    QSharedPointer<Comic> comicFile;
     qulonglong currentComicId;
     if (remote) {
         QLOG_TRACE() << "se recupera comic remoto para servir páginas";
@@ -46,8 +44,10 @@ void PageController::service(HttpRequest &request, HttpResponse &response)
         currentComicId = ySession->getCurrentComicId();
     }
 
-    if (currentComicId != 0 && !QPointer<Comic>(comicFile).isNull()) {
+    if (currentComicId != 0 && !comicFile.isNull()) {
         if (comicId == currentComicId && page < comicFile->numPages()) {
+            // PDF pages are rendered on demand
+            comicFile->requestPage(page);
             if (comicFile->pageIsLoaded(page)) {
                 // qDebug("PageController: La página estaba cargada -> %s ",path.data());
                 response.setHeader("Content-Type", "image/jpeg");
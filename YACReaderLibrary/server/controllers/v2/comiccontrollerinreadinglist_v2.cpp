@@ -25,9 +25,9 @@ void ComicControllerInReadingListV2::service(HttpRequest &request, HttpResponse
 {
 
     QByteArray token = request.getHeader("x-request-id");
-    YACReaderHttpSession *ySession = Static::yacreaderSessionStore->getYACReaderSessionHttpSession(token);
+    auto ySession = Static::yacreaderSessionStore->getYACReaderSessionHttpSession(token);
 
-    if (ySession == nullptr) {
+    if (ySession.isNull()) {
         response.setStatus(404, "not found");
         response.write("404 not found", true);
         return;
@@ -44,26 +44,10 @@ void ComicControllerInReadingListV2::service(HttpRequest &request, HttpResponse
 
     ComicDB comic = DBHelper::getComicInfo(libraryId, comicId);
 
-    Comic *comicFile = FactoryComic::newComic(libraries.getPath(libraryId) + comic.path);
-
-    if (comicFile != nullptr) {
-        QThread *thread = nullptr;
-
-        thread = new QThread();
-
-        comicFile->moveToThread(thread);
-
-        connect(comicFile, QOverload<>::of(&Comic::errorOpening), thread, &QThread::quit);
-        connect(comicFile, QOverload<QString>::of(&Comic::errorOpening), thread, &QThread::quit);
-        connect(comicFile, &Comic::imagesLoaded, thread, &QThread::quit);
-        connect(thread, &QThread::started, comicFile, &Comic::process);
-        connect(thread, &QThread::finished, thread, &QObject::deleteLater);
-
-        comicFile->load(libraries.getPath(libraryId) + comic.path);
-
-        if (thread != nullptr)
-            thread->start();
+    // comics already open in other sessions are shared, they are only extracted once
+    auto comicFile = Static::yacreaderSessionStore->openComic(comic.info.hash, libraries.getPath(libraryId) + comic.path);
 
+    if (!comicFile.isNull()) {
         QLOG_TRACE() << "remote comic requested";
         ySession->setCurrentRemoteComic(comic.id, comicFile);
 
@@ -1,11 +1,15 @@
 #include "covercontroller_v2.h"
 #include "db_helper.h" //get libraries
 #include "yacreader_libraries.h"
+#include "cover_store.h"
 #include "yacreader_http_session.h"
+#include "yacreader_http_response_helper.h"
 
 #include "template.h"
 #include "../static.h"
 
+#include <QFileInfo>
+
 using stefanfrings::HttpRequest;
 using stefanfrings::HttpResponse;
 
@@ -22,14 +26,28 @@ void CoverControllerV2::service(HttpRequest &request, HttpResponse &response)
     QString libraryName = DBHelper::getLibraryName(pathElements.at(3).toInt());
     QString fileName = pathElements.at(5);
 
-    QImage img(libraries.getPath(libraryName) + "/.yacreaderlibrary/covers/" + fileName);
-    if (!img.isNull()) {
-        QByteArray ba;
-        QBuffer buffer(&ba);
-        buffer.open(QIODevice::WriteOnly);
-        img.save(&buffer, "JPG");
-        response.write(ba, true);
-    } else {
+    // <hash>.jpg
+    QString hash = fileName.left(fileName.lastIndexOf('.'));
+    QString coverPath = YACReader::CoverStore::forLibrary(libraries.getPath(libraryName) + "/.yacreaderlibrary")->coverPath(hash);
+    QFileInfo coverInfo(coverPath);
+    if (!coverInfo.isFile()) {
+        response.setStatus(404, "not found");
+        response.write("404 not found", true);
+        return;
+    }
+
+    // covers are stored as JPEG already, they are sent as they are
+    auto eTag = YACReaderHttpResponseHelper::fileETag(coverPath);
+    auto lastModified = coverInfo.lastModified();
+    // a cover can be replaced (e.g. the user chooses a different cover page), so clients must revalidate
+    YACReaderHttpResponseHelper::setCacheHeaders(response, eTag, lastModified, "no-cache");
+
+    if (YACReaderHttpResponseHelper::isNotModified(request, eTag, lastModified)) {
+        YACReaderHttpResponseHelper::writeNotModified(response);
+        return;
+    }
+
+    if (!YACReaderHttpResponseHelper::writeFile(response, coverPath)) {
         response.setStatus(404, "not found");
         response.write("404 not found", true);
     }
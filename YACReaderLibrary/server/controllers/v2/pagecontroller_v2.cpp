@@ -5,9 +5,9 @@
 #include "comic.h"
 #include "comiccontroller.h"
 #include "yacreader_http_session.h"
+#include "yacreader_http_response_helper.h"
 
-#include <QDataStream>
-#include <QPointer>
+#include <limits>
 
 #include <QsLog.h>
 
@@ -19,9 +19,9 @@ PageControllerV2::PageControllerV2() { }
 void PageControllerV2::service(HttpRequest &request, HttpResponse &response)
 {
     QByteArray token = request.getHeader("x-request-id");
-    YACReaderHttpSession *ySession = Static::yacreaderSessionStore->getYACReaderSessionHttpSession(token);
+    auto ySession = Static::yacreaderSessionStore->getYACReaderSessionHttpSession(token);
 
-    if (ySession == nullptr) {
+    if (ySession.isNull()) {
         response.setStatus(424, "no session for this comic");
         response.write("424 no session for this comic", true);
         return;
@@ -34,7 +34,7 @@ void PageControllerV2::service(HttpRequest &request, HttpResponse &response)
     qulonglong comicId = pathElements.at(5).toULongLong();
     unsigned int page = pathElements.at(7).toUInt();
 
-    Comic *comicFile;
+    QSharedPointer<Comic> comicFile;
     qulonglong currentComicId;
     if (remote) {
         QLOG_TRACE() << "se recupera comic remoto para servir páginas";
@@ -46,7 +46,7 @@ void PageControllerV2::service(HttpRequest &request, HttpResponse &response)
         currentComicId = ySession->getCurrentComicId();
     }
 
-    if (comicFile == nullptr) {
+    if (comicFile.isNull()) {
         response.setStatus(404, "not found");
         response.write("404 not found", true);
         return;
@@ -64,38 +64,44 @@ void PageControllerV2::service(HttpRequest &request, HttpResponse &response)
         return;
     }
 
-    if (currentComicId != 0 && !QPointer<Comic>(comicFile).isNull()) {
-        if (comicFile->numPages() == 0) {
-            response.setStatus(412, "opening file");
-            response.write("412 opening file", true);
-        } else {
-            if (comicId == currentComicId && page < comicFile->numPages()) {
-                if (comicFile->pageIsLoaded(page)) {
-                    response.setHeader("Content-Type", "image/jpeg");
-                    response.setHeader("Transfer-Encoding", "chunked");
-                    QByteArray pageData = comicFile->getRawPage(page);
-                    QDataStream data(pageData);
-                    std::vector<char> buffer(100000);
-                    while (!data.atEnd()) {
-                        int len = data.readRawData(&buffer[0], buffer.size());
-                        response.write(QByteArray(&buffer[0], len));
-                    }
-                    response.write(QByteArray(), true);
-                } else {
-                    response.setStatus(412, "loading page");
-                    response.write("412 loading page", true);
-                }
-            } else {
-                if (comicId != currentComicId) {
-                    // delete comicFile;
-                    if (remote)
-                        ySession->dismissCurrentRemoteComic();
-                    else
-                        ySession->dismissCurrentComic();
-                }
+    if (currentComicId != 0 && !comicFile.isNull()) {
+        if (comicId == currentComicId) {
+            // PDF pages are rendered on demand, optionally at the size the client displays them at
+            int width = request.getParameter("width").toInt();
+            int height = request.getParameter("height").toInt();
+            if (width > 0 || height > 0) {
+                comicFile->setPageTargetSize(QSize(width > 0 ? width : std::numeric_limits<int>::max(), height > 0 ? height : std::numeric_limits<int>::max()));
+            }
+            comicFile->requestPage(page);
+            // the page is sent as soon as it is available, clients only retry if it takes too long
+            if (comicFile->waitForPage(page, pageWaitTimeout)) {
+                // shares the page buffer, it is written without copying it
+                QByteArray pageData = comicFile->getRawPage(page);
+                QByteArray eTag = '"' + QByteArray::number(comicId) + '-' + QByteArray::number(page) + '-' + QByteArray::number(pageData.size(), 16) + '"';
+                response.setHeader("Content-Type", YACReaderHttpResponseHelper::imageContentType(pageData));
+                response.setHeader("ETag", eTag);
+                YACReaderHttpResponseHelper::writeData(request, response, pageData, eTag);
+            } else if (comicFile->hasBeenAnErrorOpening() || (comicFile->numPages() > 0 && page >= comicFile->numPages())) {
                 response.setStatus(404, "not found");
                 response.write("404 not found", true);
+            } else if (comicFile->numPages() == 0) {
+                response.setStatus(412, "opening file");
+                response.setHeader("Retry-After", "1");
+                response.write("412 opening file", true);
+            } else {
+                response.setStatus(412, "loading page");
+                response.setHeader("Retry-After", "1");
+                response.write("412 loading page", true);
             }
+        } else {
+            // delete comicFile;
+            if (remote)
+                ySession->dismissCurrentRemoteComic();
+            else
+                ySession->dismissCurrentComic();
+
+            response.setStatus(404, "not found");
+            response.write("404 not found", true);
         }
     } else {
         response.setStatus(404, "not found");
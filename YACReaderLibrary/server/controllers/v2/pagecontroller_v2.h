@@ -15,6 +15,11 @@ public:
 
     /** Generates the response */
     void service(stefanfrings::HttpRequest &request, stefanfrings::HttpResponse &response) override;
+
+private:
+    // maximum time (ms) a request waits for a page that is still loading, it blocks a server thread so it is kept
+    // short, clients retry the 412 responses
+    static constexpr int pageWaitTimeout = 2000;
 };
 
 #endif // PAGECONTROLLER_H
@@ -4,6 +4,7 @@
 #include "yacreader_global.h"
 #include "db_helper.h"
 #include "yacreader_libraries.h"
+#include "db_connection_pool.h"
 #include "QsLog.h"
 
 #include <QSysInfo>
@@ -35,6 +36,8 @@ void StatusPageController::service(HttpRequest &request, HttpResponse &response)
                     "<p>Server {server.version}<p>\n"
                     "<p>OS:\t{os.name} {os.version}</p>\n"
                     "<p>Port:\t{os.port}</p>\n"
+                    "<p>DB connections:\t{db.connectionHits} reused, {db.connectionMisses} opened</p>\n"
+                    "<p>DB statements:\t{db.statementHits} reused, {db.statementMisses} prepared</p>\n"
                     "<table>\n"
                     "<thead>\n"
                     "<tr>\n"
@@ -66,6 +69,12 @@ void StatusPageController::service(HttpRequest &request, HttpResponse &response)
     StatusPage.setVariable("server.version", SERVER_VERSION_NUMBER);
     StatusPage.setVariable("yr.version", VERSION);
 
+    auto dbStats = DBConnectionPool::stats();
+    StatusPage.setVariable("db.connectionHits", QString::number(dbStats.connectionHits));
+    StatusPage.setVariable("db.connectionMisses", QString::number(dbStats.connectionMisses));
+    StatusPage.setVariable("db.statementHits", QString::number(dbStats.statementHits));
+    StatusPage.setVariable("db.statementMisses", QString::number(dbStats.statementMisses));
+
     // Get library info
     YACReaderLibraries libraries = DBHelper::getLibraries();
     QList<QString> library_names = libraries.getNames();
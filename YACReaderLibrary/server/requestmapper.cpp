@@ -67,10 +67,13 @@ void RequestMapper::loadSessionV1(HttpRequest &request, HttpResponse &response)
     QMutexLocker locker(&mutex);
 
     HttpSession session = Static::sessionStore->getSession(request, response);
-    if (session.contains("ySession")) // session is already alive check if it is needed to update comics
-    {
-        auto ySession = Static::yacreaderSessionStore->getYACReaderSessionHttpSession(session.getId());
+    QSharedPointer<YACReaderHttpSession> ySession;
+    if (session.contains("ySession")) {
+        ySession = Static::yacreaderSessionStore->getYACReaderSessionHttpSession(session.getId());
+    }
 
+    if (!ySession.isNull()) // session is already alive check if it is needed to update comics
+    {
         QString postData = QString::fromUtf8(request.getBody());
 
         if (postData.contains("currentPage"))
@@ -95,7 +98,8 @@ void RequestMapper::loadSessionV1(HttpRequest &request, HttpResponse &response)
             }
         }
     } else {
-        auto ySession = new YACReaderHttpSession(this);
+        // new session, or the previous one expired
+        ySession.reset(new YACReaderHttpSession());
 
         Static::yacreaderSessionStore->addYACReaderHttpSession(session.getId(), ySession);
 
@@ -144,9 +148,9 @@ void RequestMapper::loadSessionV2(HttpRequest &request, HttpResponse & /* respon
 
     auto yRecoveredSession = Static::yacreaderSessionStore->getYACReaderSessionHttpSession(token);
 
-    if (yRecoveredSession == nullptr) // session is already alive check if it is needed to update comics
+    if (yRecoveredSession.isNull()) // session is already alive check if it is needed to update comics
     {
-        auto ySession = new YACReaderHttpSession(this);
+        QSharedPointer<YACReaderHttpSession> ySession(new YACReaderHttpSession());
 
         Static::yacreaderSessionStore->addYACReaderHttpSession(token, ySession);
     }
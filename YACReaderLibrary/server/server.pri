@@ -14,7 +14,9 @@ HEADERS += \
     $$PWD/yacreader_http_server.h \
     $$PWD/yacreader_http_session.h \
     $$PWD/yacreader_http_session_store.h \
+    $$PWD/yacreader_open_comics_cache.h \
     $$PWD/yacreader_server_data_helper.h \
+    $$PWD/yacreader_http_response_helper.h \
     $$PWD/controllers/versioncontroller.h \
     #v1
     $$PWD/controllers/v1/comiccontroller.h \
@@ -58,7 +60,9 @@ SOURCES += \
     $$PWD/yacreader_http_server.cpp \
     $$PWD/yacreader_http_session.cpp \
     $$PWD/yacreader_http_session_store.cpp \
+    $$PWD/yacreader_open_comics_cache.cpp \
     $$PWD/yacreader_server_data_helper.cpp \
+    $$PWD/yacreader_http_response_helper.cpp \
     $$PWD/controllers/versioncontroller.cpp \
     #v1
     $$PWD/controllers/v1/comiccontroller.cpp \
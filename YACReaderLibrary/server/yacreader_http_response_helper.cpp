@@ -0,0 +1,223 @@
+#include "yacreader_http_response_helper.h"
+
+#include <QFile>
+#include <QFileInfo>
+#include <QLocale>
+
+#include "QsLog.h"
+
+using stefanfrings::HttpRequest;
+using stefanfrings::HttpResponse;
+
+namespace {
+const char *httpDateFormat = "ddd, dd MMM yyyy hh:mm:ss 'GMT'";
+
+QDateTime parseHttpDate(const QByteArray &value)
+{
+    auto dateTime = QLocale::c().toDateTime(QString::fromLatin1(value.trimmed()), httpDateFormat);
+    dateTime.setTimeSpec(Qt::UTC);
+    return dateTime;
+}
+
+// parses a single "bytes=first-last" range (RFC 7233), returns false if the header must be ignored
+bool parseByteRange(const QByteArray &value, qint64 size, qint64 &first, qint64 &last, bool &satisfiable)
+{
+    auto range = value.trimmed();
+    if (!range.startsWith("bytes=")) {
+        return false;
+    }
+    range = range.mid(6).trimmed();
+    if (range.contains(',')) {
+        // multiple ranges aren't worth a multipart/byteranges response, the whole body is sent instead
+        return false;
+    }
+
+    auto dash = range.indexOf('-');
+    if (dash == -1) {
+        return false;
+    }
+
+    bool ok = true;
+    auto firstPart = range.left(dash).trimmed();
+    auto lastPart = range.mid(dash + 1).trimmed();
+    if (firstPart.isEmpty()) {
+        // suffix range, the last N bytes
+        auto suffix = lastPart.toLongLong(&ok);
+        if (!ok || suffix < 0) {
+            return false;
+        }
+        satisfiable = suffix > 0 && size > 0;
+        first = qMax<qint64>(0, size - suffix);
+        last = size - 1;
+        return true;
+    }
+
+    first = firstPart.toLongLong(&ok);
+    if (!ok || first < 0) {
+        return false;
+    }
+    if (lastPart.isEmpty()) {
+        last = size - 1;
+    } else {
+        last = lastPart.toLongLong(&ok);
+        if (!ok || last < first) {
+            return false;
+        }
+        last = qMin(last, size - 1);
+    }
+
+    satisfiable = first < size;
+    return true;
+}
+}
+
+QByteArray YACReaderHttpResponseHelper::fileETag(const QString &path)
+{
+    QFileInfo info(path);
+    if (!info.exists()) {
+        return QByteArray();
+    }
+
+    return '"' + QByteArray::number(info.size(), 16) + '-' + QByteArray::number(info.lastModified().toMSecsSinceEpoch(), 16) + '"';
+}
+
+QByteArray YACReaderHttpResponseHelper::httpDate(const QDateTime &dateTime)
+{
+    return QLocale::c().toString(dateTime.toUTC(), httpDateFormat).toLatin1();
+}
+
+void YACReaderHttpResponseHelper::setCacheHeaders(HttpResponse &response, const QByteArray &eTag, const QDateTime &lastModified, const QByteArray &cacheControl)
+{
+    if (!eTag.isEmpty()) {
+        response.setHeader("ETag", eTag);
+    }
+    if (lastModified.isValid()) {
+        response.setHeader("Last-Modified", httpDate(lastModified));
+    }
+    response.setHeader("Cache-Control", cacheControl);
+}
+
+bool YACReaderHttpResponseHelper::isNotModified(HttpRequest &request, const QByteArray &eTag, const QDateTime &lastModified)
+{
+    auto ifNoneMatch = request.getHeader("If-None-Match");
+    if (!ifNoneMatch.isEmpty()) {
+        if (eTag.isEmpty()) {
+            return false;
+        }
+
+        const auto candidates = ifNoneMatch.split(',');
+        for (auto candidate : candidates) {
+            candidate = candidate.trimmed();
+            if (candidate.startsWith("W/")) {
+                candidate = candidate.mid(2);
+            }
+            if (candidate == "*" || candidate == eTag) {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    auto ifModifiedSince = request.getHeader("If-Modified-Since");
+    if (!ifModifiedSince.isEmpty() && lastModified.isValid()) {
+        auto since = parseHttpDate(ifModifiedSince);
+        // HTTP dates have a resolution of one second
+        return since.isValid() && lastModified.toSecsSinceEpoch() <= since.toSecsSinceEpoch();
+    }
+
+    return false;
+}
+
+void YACReaderHttpResponseHelper::writeNotModified(HttpResponse &response)
+{
+    // a 304 doesn't describe a body, the cached response keeps its own type and length
+    response.getHeaders().remove("Content-Type");
+    response.getHeaders().remove("Content-Length");
+    response.setStatus(304, "Not Modified");
+    response.write(QByteArray(), true);
+}
+
+bool YACReaderHttpResponseHelper::writeFile(HttpResponse &response, const QString &path)
+{
+    QFile file(path);
+    if (!file.open(QIODevice::ReadOnly)) {
+        return false;
+    }
+
+    auto size = file.size();
+    uchar *mapped = size > 0 ? file.map(0, size) : nullptr;
+    if (mapped != nullptr) {
+        // the mapping stays valid until the file is closed, after write() returns
+        response.write(QByteArray::fromRawData(reinterpret_cast<const char *>(mapped), size), true);
+        file.unmap(mapped);
+    } else {
+        QByteArray data = file.readAll();
+        if (file.error() != QFileDevice::NoError) {
+            QLOG_WARN() << "Unable to read" << path << file.errorString();
+            return false;
+        }
+        response.write(data, true);
+    }
+
+    return true;
+}
+
+QByteArray YACReaderHttpResponseHelper::imageContentType(const QByteArray &data)
+{
+    if (data.startsWith("\xFF\xD8\xFF")) {
+        return "image/jpeg";
+    }
+    if (data.startsWith("\x89PNG\r\n\x1A\n")) {
+        return "image/png";
+    }
+    if (data.startsWith("GIF87a") || data.startsWith("GIF89a")) {
+        return "image/gif";
+    }
+    if (data.startsWith("RIFF") && data.mid(8, 4) == "WEBP") {
+        return "image/webp";
+    }
+    if (data.startsWith("BM")) {
+        return "image/bmp";
+    }
+    if (data.startsWith(QByteArray("II*\0", 4)) || data.startsWith(QByteArray("MM\0*", 4))) {
+        return "image/tiff";
+    }
+    if (data.mid(4, 8) == "ftypavif") {
+        return "image/avif";
+    }
+    if (data.startsWith("\xFF\x0A") || data.startsWith(QByteArray("\0\0\0\x0CJXL \r\n\x87\n", 12))) {
+        return "image/jxl";
+    }
+
+    return "application/octet-stream";
+}
+
+void YACReaderHttpResponseHelper::writeData(HttpRequest &request, HttpResponse &response, const QByteArray &data, const QByteArray &eTag)
+{
+    qint64 size = data.size();
+    response.setHeader("Accept-Ranges", "bytes");
+
+    auto rangeHeader = request.getHeader("Range");
+    auto ifRange = request.getHeader("If-Range").trimmed();
+    bool rangeAllowed = ifRange.isEmpty() || (!eTag.isEmpty() && ifRange == eTag);
+
+    qint64 first = 0, last = size - 1;
+    bool satisfiable = true;
+    if (rangeHeader.isEmpty() || !rangeAllowed || !parseByteRange(rangeHeader, size, first, last, satisfiable)) {
+        response.write(data, true);
+        return;
+    }
+
+    if (!satisfiable) {
+        response.getHeaders().remove("Content-Type");
+        response.setHeader("Content-Range", "bytes */" + QByteArray::number(size));
+        response.setStatus(416, "Range Not Satisfiable");
+        response.write(QByteArray(), true);
+        return;
+    }
+
+    response.setStatus(206, "Partial Content");
+    response.setHeader("Content-Range", "bytes " + QByteArray::number(first) + '-' + QByteArray::number(last) + '/' + QByteArray::number(size));
+    // `data` outlives the write, the range is sent without copying it
+    response.write(QByteArray::fromRawData(data.constData() + first, last - first + 1), true);
+}
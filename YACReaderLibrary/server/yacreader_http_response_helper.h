@@ -0,0 +1,41 @@
+#ifndef YACREADER_HTTP_RESPONSE_HELPER_H
+#define YACREADER_HTTP_RESPONSE_HELPER_H
+
+#include <QByteArray>
+#include <QDateTime>
+#include <QString>
+
+#include "httprequest.h"
+#include "httpresponse.h"
+
+class YACReaderHttpResponseHelper
+{
+public:
+    // strong validator built from the size and the modification time of `path`, empty if the file doesn't exist
+    static QByteArray fileETag(const QString &path);
+    static QByteArray httpDate(const QDateTime &dateTime);
+
+    // sets ETag, Last-Modified and Cache-Control
+    static void setCacheHeaders(stefanfrings::HttpResponse &response, const QByteArray &eTag, const QDateTime &lastModified, const QByteArray &cacheControl);
+
+    // true if the client copy is still valid (If-None-Match has priority over If-Modified-Since, RFC 7232)
+    static bool isNotModified(stefanfrings::HttpRequest &request, const QByteArray &eTag, const QDateTime &lastModified);
+    static void writeNotModified(stefanfrings::HttpResponse &response);
+
+    // writes the whole file as the response body, memory-mapped when possible so the bytes are
+    // copied only once, into the socket buffer
+    static bool writeFile(stefanfrings::HttpResponse &response, const QString &path);
+
+    // content type of an image from its first bytes, application/octet-stream if it isn't recognized
+    static QByteArray imageContentType(const QByteArray &data);
+
+    // Writes `data` as the response body with its Content-Length. A single byte range requested with
+    // "Range: bytes=..." is answered with 206 Partial Content (or 416 if it can't be satisfied), unless
+    // If-Range doesn't match `eTag`. The body is written straight from the `data` buffer.
+    static void writeData(stefanfrings::HttpRequest &request, stefanfrings::HttpResponse &response, const QByteArray &data, const QByteArray &eTag = QByteArray());
+
+private:
+    YACReaderHttpResponseHelper();
+};
+
+#endif // YACREADER_HTTP_RESPONSE_HELPER_H
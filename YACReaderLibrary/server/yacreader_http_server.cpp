@@ -64,10 +64,13 @@ void YACReaderHttpServer::start(quint16 port)
 
     if (sessionSettings->value("expirationTime").isNull())
         sessionSettings->setValue("expirationTime", 864000000);
+    // memory (MB) the comics open in all the sessions can use
+    if (sessionSettings->value("comicsMemoryBudget").isNull())
+        sessionSettings->setValue("comicsMemoryBudget", 1024);
 
     Static::sessionStore = new HttpSessionStore(sessionSettings, app);
 
-    Static::yacreaderSessionStore = new YACReaderHttpSessionStore(Static::sessionStore, app);
+    Static::yacreaderSessionStore = new YACReaderHttpSessionStore(Static::sessionStore, sessionSettings, app);
 
     // Configure static file controller
     auto fileSettings = new QSettings(configFileName, QSettings::IniFormat, app);
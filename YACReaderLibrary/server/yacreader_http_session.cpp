@@ -1,17 +1,14 @@
 #include "yacreader_http_session.h"
 
 YACReaderHttpSession::YACReaderHttpSession(QObject *parent)
-    : QObject(parent), comicId(0), remoteComicId(0), comic(nullptr), remoteComic(nullptr)
+    : QObject(parent), comicId(0), remoteComicId(0)
 {
 }
 
 YACReaderHttpSession::~YACReaderHttpSession()
 {
-    if (comic != nullptr)
-        delete comic;
-
-    if (remoteComic != nullptr)
-        delete remoteComic;
+    dismissCurrentComic();
+    dismissCurrentRemoteComic();
 }
 
 bool YACReaderHttpSession::isComicOnDevice(const QString &hash)
@@ -57,53 +54,72 @@ void YACReaderHttpSession::clearComics()
 // current comic (import)
 qulonglong YACReaderHttpSession::getCurrentComicId()
 {
+    QMutexLocker locker(&comicsMutex);
     return comicId;
 }
 
-Comic *YACReaderHttpSession::getCurrentComic()
+QSharedPointer<Comic> YACReaderHttpSession::getCurrentComic()
 {
+    QMutexLocker locker(&comicsMutex);
     return comic;
 }
 
 void YACReaderHttpSession::dismissCurrentComic()
 {
-    if (comic != nullptr) {
-        comic->deleteLater();
-        comic = nullptr;
+    // released out of the lock, the comic is closed right away unless another session or request is still using it
+    QSharedPointer<Comic> dismissed;
+    {
+        QMutexLocker locker(&comicsMutex);
+        dismissed.swap(comic);
     }
 }
 
-void YACReaderHttpSession::setCurrentComic(qulonglong id, Comic *comic)
+void YACReaderHttpSession::setCurrentComic(qulonglong id, const QSharedPointer<Comic> &comic)
 {
-    dismissCurrentComic();
-    comicId = id;
-    this->comic = comic;
+    QSharedPointer<Comic> dismissed = comic;
+    {
+        QMutexLocker locker(&comicsMutex);
+        comicId = id;
+        dismissed.swap(this->comic);
+    }
 }
 
 // current comic (read)
 qulonglong YACReaderHttpSession::getCurrentRemoteComicId()
 {
+    QMutexLocker locker(&comicsMutex);
     return remoteComicId;
 }
 
-Comic *YACReaderHttpSession::getCurrentRemoteComic()
+QSharedPointer<Comic> YACReaderHttpSession::getCurrentRemoteComic()
 {
+    QMutexLocker locker(&comicsMutex);
     return remoteComic;
 }
 
 void YACReaderHttpSession::dismissCurrentRemoteComic()
 {
-    if (remoteComic != nullptr) {
-        remoteComic->deleteLater();
-        remoteComic = nullptr;
+    QSharedPointer<Comic> dismissed;
+    {
+        QMutexLocker locker(&comicsMutex);
+        dismissed.swap(remoteComic);
     }
 }
 
-void YACReaderHttpSession::setCurrentRemoteComic(qulonglong id, Comic *comic)
+void YACReaderHttpSession::setCurrentRemoteComic(qulonglong id, const QSharedPointer<Comic> &comic)
 {
-    dismissCurrentRemoteComic();
-    remoteComicId = id;
-    remoteComic = comic;
+    QSharedPointer<Comic> dismissed = comic;
+    {
+        QMutexLocker locker(&comicsMutex);
+        remoteComicId = id;
+        dismissed.swap(remoteComic);
+    }
+}
+
+int YACReaderHttpSession::openComics()
+{
+    QMutexLocker locker(&comicsMutex);
+    return (comic.isNull() ? 0 : 1) + (remoteComic.isNull() ? 0 : 1);
 }
 
 QString YACReaderHttpSession::getDeviceType()
@@ -1,7 +1,9 @@
 #ifndef YACREADERHTTPSESSION_H
 #define YACREADERHTTPSESSION_H
 
+#include <QMutex>
 #include <QObject>
+#include <QSharedPointer>
 
 #include "comic.h"
 
@@ -23,15 +25,18 @@ public:
 
     // current comic (import)
     qulonglong getCurrentComicId();
-    Comic *getCurrentComic();
+    QSharedPointer<Comic> getCurrentComic();
     void dismissCurrentComic();
-    void setCurrentComic(qulonglong id, Comic *comic);
+    void setCurrentComic(qulonglong id, const QSharedPointer<Comic> &comic);
 
     // current comic (read)
     qulonglong getCurrentRemoteComicId();
-    Comic *getCurrentRemoteComic();
+    QSharedPointer<Comic> getCurrentRemoteComic();
     void dismissCurrentRemoteComic();
-    void setCurrentRemoteComic(qulonglong id, Comic *comic);
+    void setCurrentRemoteComic(qulonglong id, const QSharedPointer<Comic> &comic);
+
+    // open comics (0-2)
+    int openComics();
 
     // device identification
     QString getDeviceType();
@@ -59,10 +64,13 @@ private:
     QString device;
     QString display;
 
+    // comics are shared with other sessions and requests, they can be dismissed at any time by other
+    // requests or the session store
+    QMutex comicsMutex;
     qulonglong comicId;
     qulonglong remoteComicId;
-    Comic *comic;
-    Comic *remoteComic;
+    QSharedPointer<Comic> comic;
+    QSharedPointer<Comic> remoteComic;
 
     QStack<QPair<qulonglong, quint32>> navigationPath; /* folder_id, page_number */
 };
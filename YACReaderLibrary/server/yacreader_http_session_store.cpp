@@ -4,44 +4,141 @@
 
 #include "httpsessionstore.h"
 
+#include "QsLog.h"
+
+#include <algorithm>
+
 using stefanfrings::HttpSessionStore;
 
-YACReaderHttpSessionStore::YACReaderHttpSessionStore(HttpSessionStore *sessionStore, QObject *parent)
-    : QObject(parent), sessionStore(sessionStore)
+YACReaderHttpSessionStore::YACReaderHttpSessionStore(HttpSessionStore *sessionStore, QSettings *settings, QObject *parent)
+    : QObject(parent), sessionStore(sessionStore), expiredSessions(0), evictedComics(0)
 {
-    // sessions are no longer http sessions in v2, we need another mechanism for cleaning
+    // sessions are no longer http sessions in v2 (they are identified by a token), they expire on their own
+    // after the same idle time used for http sessions
+    expirationTime = settings->value("expirationTime", 864000000).toLongLong();
+    comicsMemoryBudget = settings->value("comicsMemoryBudget", 1024).toLongLong() * 1024 * 1024;
+
+    clock.start();
 
-    // connect(&cleanupTimer,SIGNAL(timeout()),this,SLOT(sessionTimerEvent()));
-    // cleanupTimer.start(60000);
+    connect(&cleanupTimer, &QTimer::timeout, this, &YACReaderHttpSessionStore::sessionTimerEvent);
+    cleanupTimer.start(cleanupInterval);
 }
 
-void YACReaderHttpSessionStore::addYACReaderHttpSession(const QByteArray &httpSessionId, YACReaderHttpSession *yacreaderHttpSession)
+void YACReaderHttpSessionStore::addYACReaderHttpSession(const QByteArray &httpSessionId, const QSharedPointer<YACReaderHttpSession> &yacreaderHttpSession)
 {
     QMutexLocker locker(&mutex);
 
-    sessions.insert(httpSessionId, yacreaderHttpSession);
+    sessions.insert(httpSessionId, { yacreaderHttpSession, clock.elapsed() });
 }
 
-YACReaderHttpSession *YACReaderHttpSessionStore::getYACReaderSessionHttpSession(const QByteArray &httpSessionId)
+QSharedPointer<YACReaderHttpSession> YACReaderHttpSessionStore::getYACReaderSessionHttpSession(const QByteArray &httpSessionId)
 {
     QMutexLocker locker(&mutex);
 
-    return sessions.value(httpSessionId, nullptr);
+    auto entry = sessions.find(httpSessionId);
+    if (entry == sessions.end()) {
+        return QSharedPointer<YACReaderHttpSession>();
+    }
+
+    entry->lastAccess = clock.elapsed();
+    return entry->session;
 }
 
-void YACReaderHttpSessionStore::sessionTimerEvent()
+QSharedPointer<Comic> YACReaderHttpSessionStore::openComic(const QString &hash, const QString &path)
 {
-    // sessions are no longer http sessions in v2, we are using a token, so sessionStore->getSession(id).isNull() is always true.
-    /*QMutexLocker locker(&mutex);
-    for(const QByteArray &id : sessions.keys())
+    return openComics.open(hash, path);
+}
+
+YACReaderHttpSessionStore::Metrics YACReaderHttpSessionStore::metrics()
+{
+    Metrics metrics {};
+    metrics.openComics = openComics.count();
+    metrics.comicsMemoryUsage = openComics.memoryUsage();
+
+    QMutexLocker locker(&mutex);
+    metrics.sessions = sessions.size();
+    metrics.expiredSessions = expiredSessions;
+    metrics.evictedComics = evictedComics;
+
+    return metrics;
+}
+
+void YACReaderHttpSessionStore::removeExpiredSessions()
+{
+    // sessions are deleted when the requests still using them finish
+    QList<QSharedPointer<YACReaderHttpSession>> expired;
     {
-        if(sessionStore->getSession(id).isNull())
-        {
-            YACReaderHttpSession *session = sessions.value(id, nullptr);
-            if(session != nullptr)
-                delete session;
+        QMutexLocker locker(&mutex);
 
-            sessions.remove(id);
+        qint64 now = clock.elapsed();
+        for (auto entry = sessions.begin(); entry != sessions.end();) {
+            if (now - entry->lastAccess > expirationTime) {
+                expired.append(entry->session);
+                entry = sessions.erase(entry);
+            } else {
+                ++entry;
+            }
         }
-    }*/
+        expiredSessions += expired.size();
+    }
+
+    if (!expired.isEmpty()) {
+        QLOG_INFO() << "Sessions expired:" << expired.size();
+    }
+}
+
+void YACReaderHttpSessionStore::enforceMemoryBudget()
+{
+    qint64 usage = openComics.memoryUsage();
+    if (usage <= comicsMemoryBudget) {
+        return;
+    }
+
+    QList<Entry> entries;
+    {
+        QMutexLocker locker(&mutex);
+        entries = sessions.values();
+    }
+
+    std::sort(entries.begin(), entries.end(), [](const Entry &e1, const Entry &e2) {
+        return e1.lastAccess < e2.lastAccess;
+    });
+
+    // the comics of the least recently used sessions are closed first, the most recently used one is kept
+    // even if it is over budget on its own. Comics still used by other sessions aren't freed until they are
+    // closed in all of them.
+    int evicted = 0;
+    for (int i = 0; i < entries.size() - 1 && usage > comicsMemoryBudget; i++) {
+        const auto &session = entries.at(i).session;
+        int sessionComics = session->openComics();
+        if (sessionComics == 0) {
+            continue;
+        }
+
+        evicted += sessionComics;
+        session->dismissCurrentComic();
+        session->dismissCurrentRemoteComic();
+        usage = openComics.memoryUsage();
+    }
+
+    if (evicted == 0) {
+        return;
+    }
+
+    {
+        QMutexLocker locker(&mutex);
+        evictedComics += evicted;
+    }
+
+    QLOG_INFO() << "Open comics over the memory budget, comics closed:" << evicted;
+}
+
+void YACReaderHttpSessionStore::sessionTimerEvent()
+{
+    removeExpiredSessions();
+    enforceMemoryBudget();
+
+    auto current = metrics();
+    QLOG_TRACE() << "Sessions:" << current.sessions << "open comics:" << current.openComics << "comics memory usage (bytes):" << current.comicsMemoryUsage
+                 << "expired sessions:" << current.expiredSessions << "evicted comics:" << current.evictedComics;
 }
@@ -4,28 +4,68 @@
 #include <QObject>
 #include <QtCore>
 
+#include "yacreader_open_comics_cache.h"
+
 namespace stefanfrings {
 class HttpSessionStore;
 }
 class YACReaderHttpSession;
+class Comic;
 
+// Sessions of the devices connected to the server. Sessions not used for a while (expirationTime) are
+// removed, and if the comics open in all the sessions use more memory than the budget (comicsMemoryBudget)
+// the comics of the least recently used sessions are closed, the clients open them again if needed.
+// Comics are shared by all the sessions reading them (see YACReaderOpenComicsCache).
 class YACReaderHttpSessionStore : public QObject
 {
     Q_OBJECT
 public:
-    explicit YACReaderHttpSessionStore(stefanfrings::HttpSessionStore *sessionStore, QObject *parent = nullptr);
+    struct Metrics {
+        int sessions;
+        int openComics; // different comics, no matter how many sessions are using them
+        qint64 comicsMemoryUsage; // bytes
+        quint64 expiredSessions; // since the server started
+        quint64 evictedComics; // comics closed in sessions to free memory, since the server started
+    };
+
+    // `settings` is the "sessions" group of the server settings
+    explicit YACReaderHttpSessionStore(stefanfrings::HttpSessionStore *sessionStore, QSettings *settings, QObject *parent = nullptr);
+
+    void addYACReaderHttpSession(const QByteArray &httpSessionId, const QSharedPointer<YACReaderHttpSession> &yacreaderHttpSession);
+    // null if there is no session, using a session counts as an access
+    QSharedPointer<YACReaderHttpSession> getYACReaderSessionHttpSession(const QByteArray &httpSessionId);
+
+    // the comic with `hash`, shared with the sessions that already have it open
+    QSharedPointer<Comic> openComic(const QString &hash, const QString &path);
 
-    void addYACReaderHttpSession(const QByteArray &httpSessionId, YACReaderHttpSession *yacreaderHttpSession);
-    YACReaderHttpSession *getYACReaderSessionHttpSession(const QByteArray &httpSessionId);
+    Metrics metrics();
 
 signals:
 
 public slots:
 
 private:
-    QMap<QByteArray, YACReaderHttpSession *> sessions;
+    struct Entry {
+        QSharedPointer<YACReaderHttpSession> session;
+        qint64 lastAccess; // msecs since the store was created
+    };
+
+    static constexpr int cleanupInterval = 10000;
+
+    void removeExpiredSessions();
+    void enforceMemoryBudget();
+
+    // declared before the sessions, their comics must be released before the cache is destroyed
+    YACReaderOpenComicsCache openComics;
+    QMap<QByteArray, Entry> sessions;
     stefanfrings::HttpSessionStore *sessionStore;
     QTimer cleanupTimer;
+    QElapsedTimer clock;
+
+    qint64 expirationTime; // msecs
+    qint64 comicsMemoryBudget; // bytes
+    quint64 expiredSessions;
+    quint64 evictedComics;
 
     QMutex mutex;
 
@@ -0,0 +1,109 @@
+#include "yacreader_open_comics_cache.h"
+
+#include "comic.h"
+
+#include <QFileInfo>
+
+#include "QsLog.h"
+
+QSharedPointer<Comic> YACReaderOpenComicsCache::open(const QString &comicHash, const QString &path)
+{
+    // comics without hash (not in the library yet) are identified by their path
+    QString hash = comicHash.isEmpty() ? path : comicHash;
+
+    // declared before the locker, releasing a comic takes the lock so the references must be dropped once it is unlocked
+    QSharedPointer<Comic> comic, failed;
+    QMutexLocker locker(&mutex);
+
+    // the page being rendered and the render size of a PDF comic are set by each client
+    if (QFileInfo(path).suffix().compare("pdf", Qt::CaseInsensitive) == 0) {
+        hash += QString("#%1").arg(++unsharedComics);
+    }
+
+    comic = comics.value(hash).toStrongRef();
+    if (!comic.isNull()) {
+        if (!comic->hasBeenAnErrorOpening()) {
+            QLOG_TRACE() << "Sharing open comic" << hash;
+            return comic;
+        }
+        // a comic that failed opening is tried again
+        failed.swap(comic);
+    }
+
+    Comic *comicFile = FactoryComic::newComic(path);
+    if (comicFile == nullptr) {
+        return QSharedPointer<Comic>();
+    }
+
+    auto thread = new QThread();
+
+    comicFile->moveToThread(thread);
+
+    QObject::connect(comicFile, QOverload<>::of(&Comic::errorOpening), thread, &QThread::quit);
+    QObject::connect(comicFile, QOverload<QString>::of(&Comic::errorOpening), thread, &QThread::quit);
+    QObject::connect(comicFile, &Comic::imagesLoaded, thread, &QThread::quit);
+    // comics closed while loading and PDF comics never emit imagesLoaded. It is emitted in the thread releasing the
+    // comic, quit() can be called from any thread
+    QObject::connect(comicFile, &Comic::invalidated, thread, &QThread::quit, Qt::DirectConnection);
+    QObject::connect(thread, &QThread::started, comicFile, &Comic::process);
+    QObject::connect(thread, &QThread::finished, thread, &QObject::deleteLater);
+    auto running = runningThreads;
+    QObject::connect(thread, &QThread::finished, [running] { (*running)--; });
+    (*running)++;
+
+    comicFile->load(path);
+
+    thread->start();
+
+    comic = QSharedPointer<Comic>(comicFile, [this, hash](Comic *comic) {
+        release(hash, comic);
+    });
+    comics.insert(hash, comic);
+
+    return comic;
+}
+
+void YACReaderOpenComicsCache::release(const QString &hash, Comic *comic)
+{
+    {
+        QMutexLocker locker(&mutex);
+        // the entry may belong to a comic opened again after this one failed
+        auto entry = comics.find(hash);
+        if (entry != comics.end() && entry->isNull()) {
+            comics.erase(entry);
+        }
+    }
+
+    // stops its loading thread, PDF comics keep it running to render pages on demand
+    comic->invalidate();
+    comic->deleteLater();
+}
+
+int YACReaderOpenComicsCache::loadingThreads() const
+{
+    return *runningThreads;
+}
+
+int YACReaderOpenComicsCache::count()
+{
+    QMutexLocker locker(&mutex);
+
+    return comics.size();
+}
+
+qint64 YACReaderOpenComicsCache::memoryUsage()
+{
+    // declared before the locker, see open()
+    QList<QSharedPointer<Comic>> openComics;
+    QMutexLocker locker(&mutex);
+
+    qint64 usage = 0;
+    for (const auto &entry : qAsConst(comics)) {
+        QSharedPointer<Comic> comic = entry.toStrongRef();
+        if (!comic.isNull()) {
+            usage += comic->memoryUsage();
+            openComics.append(comic);
+        }
+    }
+    return usage;
+}
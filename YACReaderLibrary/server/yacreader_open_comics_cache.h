@@ -0,0 +1,41 @@
+#ifndef YACREADER_OPEN_COMICS_CACHE_H
+#define YACREADER_OPEN_COMICS_CACHE_H
+
+#include <QHash>
+#include <QMutex>
+#include <QSharedPointer>
+#include <QWeakPointer>
+
+#include <atomic>
+#include <memory>
+
+class Comic;
+
+// Comics opened by the server, shared by all the sessions. A comic is opened (and extracted) once no matter
+// how many devices are reading it, and it is closed when the last session using it dismisses it.
+// PDF comics aren't shared, their pages are rendered for the page and the size each client asks for.
+// The cache must outlive the comics it opens.
+class YACReaderOpenComicsCache
+{
+public:
+    // the comic with `hash` if it is already open, otherwise the comic at `path` starts loading in its own
+    // thread. Null if `path` isn't a comic.
+    QSharedPointer<Comic> open(const QString &hash, const QString &path);
+
+    int count();
+    // memory used by the pages of the open comics, in bytes
+    qint64 memoryUsage();
+    // threads still loading comics, including the ones of comics already closed that haven't stopped yet
+    int loadingThreads() const;
+
+private:
+    void release(const QString &hash, Comic *comic);
+
+    QMutex mutex;
+    QHash<QString, QWeakPointer<Comic>> comics;
+    quint64 unsharedComics = 0;
+    // shared with the threads, they can finish after the cache is destroyed
+    std::shared_ptr<std::atomic<int>> runningThreads = std::make_shared<std::atomic<int>>(0);
+};
+
+#endif // YACREADER_OPEN_COMICS_CACHE_H
@@ -75,22 +75,19 @@ void XMLInfoLibraryScanner::run()
             updateFromSQLQuery(database, comicsInfo);
         } else {
             if (folderDestinationModelIndex.isValid()) {
-                YACReader::iterate(folderDestinationModelIndex, folderDestinationModelIndex.model(), [&](const QModelIndex &idx) {
-                    if (stopRunning) {
-                        return false;
-                    }
-
-                    auto item = static_cast<FolderItem *>(idx.internalPointer());
-
-                    QSqlQuery comicsInfo(database);
-                    comicsInfo.prepare("SELECT * FROM comic c INNER JOIN comic_info ci ON (c.comicInfoId = ci.id) WHERE c.parentId = :parentId");
-                    comicsInfo.bindValue(":parentId", item->id);
-                    comicsInfo.exec();
-
-                    updateFromSQLQuery(database, comicsInfo);
-
-                    return true;
-                });
+                auto item = static_cast<FolderItem *>(folderDestinationModelIndex.internalPointer());
+
+                // the subfolders are taken from the DB, the folders model may not have loaded them
+                QSqlQuery comicsInfo(database);
+                comicsInfo.prepare("WITH RECURSIVE subtree(id) AS ("
+                                   "SELECT :folderId UNION ALL "
+                                   "SELECT f.id FROM folder f INNER JOIN subtree s ON (f.parentId = s.id) WHERE f.id <> 1) "
+                                   "SELECT * FROM comic c INNER JOIN comic_info ci ON (c.comicInfoId = ci.id) "
+                                   "WHERE c.parentId IN (SELECT id FROM subtree)");
+                comicsInfo.bindValue(":folderId", item->id);
+                comicsInfo.exec();
+
+                updateFromSQLQuery(database, comicsInfo);
             }
         }
 
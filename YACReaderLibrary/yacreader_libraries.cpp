@@ -1,6 +1,32 @@
 #include "yacreader_libraries.h"
 #include "yacreader_global.h"
 
+namespace {
+struct LibrariesRegistry {
+    QReadWriteLock lock;
+    QMap<QString, QPair<int, QString>> libraries;
+    bool loaded = false;
+};
+
+LibrariesRegistry &librariesRegistry()
+{
+    static LibrariesRegistry registry;
+    return registry;
+}
+
+QString settingsFilePath()
+{
+    return YACReader::getSettingsPath() + "/" + QCoreApplication::applicationName() + ".ini";
+}
+
+void invalidateLibrariesRegistry()
+{
+    auto &registry = librariesRegistry();
+    QWriteLocker locker(&registry.lock);
+    registry.loaded = false;
+}
+}
+
 YACReaderLibraries::YACReaderLibraries()
     : QObject()
 {
@@ -96,7 +122,66 @@ void YACReaderLibraries::addLibrary(const QString &name, const QString &path)
 
 void YACReaderLibraries::load()
 {
-    QSettings settings(YACReader::getSettingsPath() + "/" + QCoreApplication::applicationName() + ".ini", QSettings::IniFormat);
+    auto &registry = librariesRegistry();
+    {
+        QReadLocker locker(&registry.lock);
+        if (registry.loaded) {
+            libraries = registry.libraries;
+            return;
+        }
+    }
+
+    QWriteLocker locker(&registry.lock);
+    if (!registry.loaded) {
+        libraries.clear();
+        loadFromSettings();
+        registry.libraries = libraries;
+        registry.loaded = true;
+    } else {
+        libraries = registry.libraries;
+    }
+}
+
+bool YACReaderLibraries::save()
+{
+    bool saved = saveToSettings();
+
+    auto &registry = librariesRegistry();
+    QWriteLocker locker(&registry.lock);
+    registry.libraries = libraries;
+    registry.loaded = true;
+
+    return saved;
+}
+
+void YACReaderLibraries::watchSettings()
+{
+    static QFileSystemWatcher *watcher = nullptr;
+    if (watcher != nullptr) {
+        return;
+    }
+
+    auto path = settingsFilePath();
+    watcher = new QFileSystemWatcher(QCoreApplication::instance());
+    // the settings file is replaced when it is written, so its folder is watched too to add the new file again
+    watcher->addPath(QFileInfo(path).absolutePath());
+    if (QFile::exists(path)) {
+        watcher->addPath(path);
+    }
+
+    auto onChange = [=] {
+        invalidateLibrariesRegistry();
+        if (!watcher->files().contains(path) && QFile::exists(path)) {
+            watcher->addPath(path);
+        }
+    };
+    connect(watcher, &QFileSystemWatcher::fileChanged, watcher, onChange);
+    connect(watcher, &QFileSystemWatcher::directoryChanged, watcher, onChange);
+}
+
+void YACReaderLibraries::loadFromSettings()
+{
+    QSettings settings(settingsFilePath(), QSettings::IniFormat);
 
     if (settings.value(LIBRARIES).isValid()) {
         QByteArray data = settings.value(LIBRARIES).toByteArray();
@@ -120,14 +205,14 @@ void YACReaderLibraries::load()
             i++;
         }
         f.close();
-        if (save())
+        if (saveToSettings())
             f.remove();
     }
 }
 
-bool YACReaderLibraries::save()
+bool YACReaderLibraries::saveToSettings()
 {
-    QSettings settings(YACReader::getSettingsPath() + "/" + QCoreApplication::applicationName() + ".ini", QSettings::IniFormat);
+    QSettings settings(settingsFilePath(), QSettings::IniFormat);
 
     QByteArray data;
     QDataStream out(&data, QIODevice::WriteOnly);
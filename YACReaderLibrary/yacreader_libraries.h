@@ -3,6 +3,8 @@
 
 #include <QtCore>
 
+// Libraries registered in the settings file. The registry is loaded once and kept in memory for the
+// whole process (it is read in every server request), load() and save() keep it in sync.
 class YACReaderLibraries : public QObject
 {
     Q_OBJECT
@@ -22,12 +24,18 @@ public:
     int getId(const QString &name);
     YACReaderLibraries &operator=(const YACReaderLibraries &source);
     QMap<QString, QPair<int, QString>> getLibraries();
+    // reloads the registry when the settings file is changed by another process (e.g. YACReaderLibraryServer
+    // commands), it must be called from the main thread
+    static void watchSettings();
 public slots:
     void addLibrary(const QString &name, const QString &path);
     void load();
     bool save();
 
 private:
+    void loadFromSettings();
+    bool saveToSettings();
+
     // name <id,path>
     QMap<QString, QPair<int, QString>> libraries;
 };
@@ -244,6 +244,8 @@ void YACReaderNavigationController::loadIndexFromHistory(const YACReaderLibraryS
 
 void YACReaderNavigationController::selectSubfolder(const QModelIndex &sourceMIParent, int child)
 {
+    if (libraryWindow->foldersModel->canFetchMore(sourceMIParent))
+        libraryWindow->foldersModel->fetchMore(sourceMIParent);
     QModelIndex dest = libraryWindow->foldersModel->index(child, 0, sourceMIParent);
     libraryWindow->foldersView->setCurrentIndex(libraryWindow->foldersModelProxy->mapFromSource(dest));
     libraryWindow->historyController->updateHistory(YACReaderLibrarySourceContainer(dest, YACReaderLibrarySourceContainer::Folder));
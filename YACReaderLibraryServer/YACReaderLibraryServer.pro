@@ -49,16 +49,20 @@ HEADERS += ../YACReaderLibrary/library_creator.h \
            ../YACReaderLibrary/bundle_creator.h \
            ../YACReaderLibrary/db_helper.h \
            ../YACReaderLibrary/db/data_base_management.h \
+           ../YACReaderLibrary/db/db_connection_pool.h \
+           ../YACReaderLibrary/db/remote_progress_sync.h \
            ../YACReaderLibrary/db/reading_list.h \
            ../YACReaderLibrary/initial_comic_info_extractor.h \
            ../YACReaderLibrary/xml_info_parser.h \
            ../common/comic_db.h \
+           ../common/cover_store.h \
            ../common/folder.h \
            ../common/library_item.h \
            ../common/comic.h \
            ../common/pdf_comic.h \
            ../common/bookmarks.h \
            ../common/qnaturalsorting.h \
+           ../common/concurrent_queue.h \
            ../common/yacreader_global.h \
            ../YACReaderLibrary/yacreader_local_server.h \
            ../YACReaderLibrary/comics_remover.h \
@@ -74,15 +78,19 @@ SOURCES += ../YACReaderLibrary/library_creator.cpp \
            ../YACReaderLibrary/bundle_creator.cpp \
            ../YACReaderLibrary/db_helper.cpp \
            ../YACReaderLibrary/db/data_base_management.cpp \
+           ../YACReaderLibrary/db/db_connection_pool.cpp \
+           ../YACReaderLibrary/db/remote_progress_sync.cpp \
            ../YACReaderLibrary/db/reading_list.cpp \
            ../YACReaderLibrary/initial_comic_info_extractor.cpp \
            ../YACReaderLibrary/xml_info_parser.cpp \
            ../common/comic_db.cpp \
+           ../common/cover_store.cpp \
            ../common/folder.cpp \
            ../common/library_item.cpp \
            ../common/comic.cpp \
            ../common/bookmarks.cpp \
            ../common/qnaturalsorting.cpp \
+           ../common/concurrent_queue.cpp \
            ../YACReaderLibrary/yacreader_local_server.cpp \
            ../YACReaderLibrary/comics_remover.cpp \
            ../common/http_worker.cpp \
@@ -193,6 +193,8 @@ int main(int argc, char **argv)
 
         QLOG_INFO() << "YACReaderLibrary starting";
 
+        YACReaderLibraries::watchSettings();
+
         // server
         YACReaderHttpServer *httpServer = new YACReaderHttpServer();
         if (parser.isSet("port")) {
@@ -8,10 +8,13 @@
 #include <QFileInfoList>
 #include <QCoreApplication>
 
+#include <atomic>
+
 #include "bookmarks.h" //TODO desacoplar la dependencia con bookmarks
 #include "qnaturalsorting.h"
 #include "compressed_archive.h"
 #include "comic_db.h"
+#include "concurrent_queue.h"
 
 #include "QsLog.h"
 
@@ -23,6 +26,32 @@ enum YACReaderPageSortingMode {
 
 void comic_pages_sort(QList<QString> &pageNames, YACReaderPageSortingMode sortingMode);
 
+namespace {
+// width of the copy of decoded pages sent with imageLoaded(int, QByteArray), it is only used for thumbnails
+const int decodedPagePreviewWidth = 640;
+
+QByteArray encodePage(const QImage &image)
+{
+    QByteArray ba;
+    QBuffer buf(&ba);
+    buf.open(QIODevice::WriteOnly);
+    image.save(&buf, "jpg", 96);
+    return ba;
+}
+
+#ifndef NO_PDF
+// true if a page rendered to fit in `rendered` is good enough to be shown at `target`
+bool coversSize(const QSize &rendered, const QSize &target)
+{
+    if (!rendered.isValid() || !target.isValid()) {
+        return rendered.isValid() == target.isValid();
+    }
+    // small increases (e.g. one zoom step) aren't worth rendering the page again
+    return target.width() <= rendered.width() * 1.1 && target.height() <= rendered.height() * 1.1;
+}
+#endif // NO_PDF
+}
+
 QStringList Comic::getSupportedImageFormats()
 {
     QList<QByteArray> supportedImageFormats = QImageReader::supportedImageFormats();
@@ -107,7 +136,7 @@ const QStringList Comic::literalComicExtensions = LiteralComicArchiveExtensions;
 
 //-----------------------------------------------------------------------------
 Comic::Comic()
-    : _pages(), _loadedPages(), _index(0), _path(), _loaded(false), _isPDF(false), _invalidated(false), _errorOpening(false), bm(new Bookmarks())
+    : _pages(), _loadedPages(), _index(0), _path(), _loaded(false), _isPDF(false), _errorOpening(false), bm(new Bookmarks())
 {
     setup();
 }
@@ -127,10 +156,14 @@ Comic::~Comic()
 void Comic::setup()
 {
     connect(this, &Comic::pageChanged, this, &Comic::checkIsBookmark);
-    connect(this, QOverload<int>::of(&Comic::imageLoaded), this, &Comic::updateBookmarkImage);
-    connect(this, QOverload<int>::of(&Comic::imageLoaded), this, &Comic::setPageLoaded);
+    // pages can be extracted by worker threads, the page state must be updated before the page is announced to other objects
+    connect(this, QOverload<int>::of(&Comic::imageLoaded), this, &Comic::updateBookmarkImage, Qt::DirectConnection);
+    connect(this, QOverload<int>::of(&Comic::imageLoaded), this, &Comic::setPageLoaded, Qt::DirectConnection);
 
-    auto l = [&]() { _errorOpening = true; };
+    auto l = [&]() {
+        _errorOpening = true;
+        wakePageWaiters();
+    };
 
     void (Comic::*errorOpeningPtr)() = &Comic::errorOpening;
     void (Comic::*errorOpeningWithStringPtr)(QString) = &Comic::errorOpening;
@@ -211,9 +244,7 @@ void Comic::loadFinished()
 //-----------------------------------------------------------------------------
 void Comic::setBookmark()
 {
-    QImage p;
-    p.loadFromData(_pages[_index]);
-    bm->setBookmark(_index, p);
+    bm->setBookmark(_index, getPageImage(_index));
     // emit bookmarksLoaded(*bm);
     emit bookmarksUpdated();
 }
@@ -227,9 +258,7 @@ void Comic::removeBookmark()
 //-----------------------------------------------------------------------------
 void Comic::saveBookmarks()
 {
-    QImage p;
-    p.loadFromData(_pages[_index]);
-    bm->setLastPage(_index, p);
+    bm->setLastPage(_index, getPageImage(_index));
     bm->save();
 }
 //-----------------------------------------------------------------------------
@@ -245,16 +274,12 @@ void Comic::updateBookmarkImage(int index)
     }
 
     if (bm->isBookmark(index)) {
-        QImage p;
-        p.loadFromData(_pages[index]);
-        bm->setBookmark(index, p);
+        bm->setBookmark(index, getPageImage(index));
         emit bookmarksUpdated();
         // emit bookmarksLoaded(*bm);
     }
     if (bm->getLastPage() == index) {
-        QImage p;
-        p.loadFromData(_pages[index]);
-        bm->setLastPage(index, p);
+        bm->setLastPage(index, getPageImage(index));
         emit bookmarksUpdated();
         // emit bookmarksLoaded(*bm);
     }
@@ -262,29 +287,123 @@ void Comic::updateBookmarkImage(int index)
 //-----------------------------------------------------------------------------
 void Comic::setPageLoaded(int page)
 {
-    _loadedPages[page] = true;
+    {
+        QMutexLocker locker(&_decodedPagesMutex);
+        _loadedPages[page] = true;
+    }
+    wakePageWaiters();
 }
 
 void Comic::invalidate()
 {
     _invalidated = true;
+    wakePageWaiters();
     emit invalidated();
 }
 //-----------------------------------------------------------------------------
+void Comic::wakePageWaiters()
+{
+    QMutexLocker locker(&_pageLoadedMutex);
+    _pageLoaded.wakeAll();
+}
+//-----------------------------------------------------------------------------
 QByteArray Comic::getRawPage(int page)
 {
     if (page < 0 || page >= _pages.size()) {
         return QByteArray();
     }
+
+    if (page < _decodedPages.size()) {
+        QMutexLocker locker(&_decodedPagesMutex);
+        if (!_decodedPages[page].isNull() && _pages[page].isEmpty()) {
+            _pages[page] = encodePage(_decodedPages[page]);
+            _memoryUsage += _pages[page].size();
+        }
+        return _pages[page];
+    }
+
     return _pages[page];
 }
 //-----------------------------------------------------------------------------
+QImage Comic::getDecodedPage(int page)
+{
+    if (page < 0 || page >= _decodedPages.size()) {
+        return QImage();
+    }
+    QMutexLocker locker(&_decodedPagesMutex);
+    return _decodedPages[page];
+}
+//-----------------------------------------------------------------------------
+QImage Comic::getPageImage(int page)
+{
+    QImage image = getDecodedPage(page);
+    if (image.isNull()) {
+        image.loadFromData(getRawPage(page));
+    }
+    return image;
+}
+//-----------------------------------------------------------------------------
+void Comic::setPageImage(int page, const QImage &image)
+{
+    if (page < 0 || page >= _decodedPages.size()) {
+        return;
+    }
+
+    {
+        QMutexLocker locker(&_decodedPagesMutex);
+        _memoryUsage += image.sizeInBytes() - _decodedPages[page].sizeInBytes() - _pages[page].size();
+        _decodedPages[page] = image;
+        // it may have been encoded from a previous render of the page
+        _pages[page].clear();
+    }
+    emit imageLoaded(page);
+
+    // encoding a preview is only worth it if someone is listening (e.g. the go to flow)
+    static const QMetaMethod compressedImageLoaded = QMetaMethod::fromSignal(QOverload<int, const QByteArray &>::of(&Comic::imageLoaded));
+    if (isSignalConnected(compressedImageLoaded)) {
+        if (image.width() > decodedPagePreviewWidth) {
+            emit imageLoaded(page, encodePage(image.scaledToWidth(decodedPagePreviewWidth, Qt::SmoothTransformation)));
+        } else {
+            emit imageLoaded(page, encodePage(image));
+        }
+    }
+}
+//-----------------------------------------------------------------------------
+void Comic::releasePage(int page)
+{
+    if (page < 0 || page >= _decodedPages.size()) {
+        return;
+    }
+
+    QMutexLocker locker(&_decodedPagesMutex);
+    _loadedPages[page] = false;
+    _memoryUsage -= _decodedPages[page].sizeInBytes() + _pages[page].size();
+    _decodedPages[page] = QImage();
+    _pages[page].clear();
+}
+//-----------------------------------------------------------------------------
 bool Comic::pageIsLoaded(int page)
 {
     if (page < 0 || page >= _pages.size()) {
         return false;
     }
-    return _loadedPages[page];
+    QMutexLocker locker(&_decodedPagesMutex);
+    return _loadedPages.at(page);
+}
+
+bool Comic::waitForPage(int page, int timeout)
+{
+    QDeadlineTimer deadline(timeout);
+    QMutexLocker locker(&_pageLoadedMutex);
+    while (!pageIsLoaded(page)) {
+        if (_errorOpening || _invalidated || (_loaded && page >= _pages.size())) {
+            return false;
+        }
+        if (!_pageLoaded.wait(&_pageLoadedMutex, deadline)) {
+            return pageIsLoaded(page);
+        }
+    }
+    return true;
 }
 
 bool Comic::hasBeenAnErrorOpening()
@@ -345,12 +464,12 @@ QList<QString> Comic::findValidComicFilesInFolder(const QString &path)
 ////////////////////////////////////////////////////////////////////////////////
 
 FileComic::FileComic()
-    : Comic()
+    : Comic(), _extractionWorkers(qMin(QThread::idealThreadCount(), maxExtractionWorkers))
 {
 }
 
 FileComic::FileComic(const QString &path, int atPage)
-    : Comic(path, atPage)
+    : Comic(path, atPage), _extractionWorkers(qMin(QThread::idealThreadCount(), maxExtractionWorkers))
 {
     FileComic::load(path, atPage);
 }
@@ -444,6 +563,7 @@ void FileComic::fileExtracted(int index, const QByteArray &rawData)
     if (sortedIndex == -1) {
         return;
     }
+    _memoryUsage += rawData.size() - _pages[sortedIndex].size();
     _pages[sortedIndex] = rawData;
     emit imageLoaded(sortedIndex);
     emit imageLoaded(sortedIndex, _pages[sortedIndex]);
@@ -462,6 +582,11 @@ void FileComic::unknownError(int index)
     // emit errorOpening();
 }
 
+void FileComic::setExtractionWorkers(int workers)
+{
+    _extractionWorkers = qMax(1, workers);
+}
+
 bool FileComic::isCancelled()
 {
     return _invalidated;
@@ -554,6 +679,70 @@ QList<QVector<quint32>> FileComic::getSections(int &sectionIndex)
     return sections;
 }
 
+// Entries in non-solid archives can be decoded independently, every worker opens its own handle to
+// the archive and takes the pending page closest to _firstPage. Returns the archive indexes that
+// couldn't be extracted.
+QVector<quint32> FileComic::extractInParallel(int workers)
+{
+    const int firstPage = _firstPage;
+    // readers usually move forward, so pages after _firstPage go first
+    auto priority = [firstPage](int page) {
+        return page >= firstPage ? page - firstPage : 2 * (firstPage - page);
+    };
+
+    QVector<int> pending;
+    for (int i = 0; i < _fileNames.size(); i++) {
+        pending.append(i);
+    }
+    std::stable_sort(pending.begin(), pending.end(), [&priority](int a, int b) {
+        return priority(a) < priority(b);
+    });
+
+    QVector<quint32> indexes;
+    for (int page : pending) {
+        indexes.append(_order.indexOf(_fileNames.at(page)));
+    }
+
+    QVector<bool> extracted(indexes.size(), false);
+    std::atomic<int> next { 0 };
+    QMutex deliveryMutex;
+
+    {
+        YACReader::ConcurrentQueue queue(workers);
+        for (int worker = 0; worker < workers; worker++) {
+            queue.enqueue([&] {
+                CompressedArchive archive(_path);
+                if (!archive.isValid()) {
+                    return;
+                }
+
+                int i;
+                while (!_invalidated && (i = next++) < indexes.size()) {
+                    QByteArray rawData = archive.getRawDataAtIndex(indexes.at(i));
+                    if (rawData.isEmpty()) {
+                        continue;
+                    }
+
+                    QMutexLocker locker(&deliveryMutex);
+                    if (!_invalidated) {
+                        fileExtracted(indexes.at(i), rawData);
+                        extracted[i] = true;
+                    }
+                }
+            });
+        }
+        queue.waitAll();
+    }
+
+    QVector<quint32> failed;
+    for (int i = 0; i < indexes.size(); i++) {
+        if (!extracted.at(i)) {
+            failed.append(indexes.at(i));
+        }
+    }
+    return failed;
+}
+
 void FileComic::process()
 {
     CompressedArchive archive(_path);
@@ -584,6 +773,7 @@ void FileComic::process()
     //_order = _fileNames;
 
     _pages.resize(_fileNames.size());
+    _memoryUsage = 0;
     _loadedPages = QVector<bool>(_fileNames.size(), false);
 
     emit pageChanged(0); // this indicates new comic, index=0
@@ -606,6 +796,21 @@ void FileComic::process()
     _index = _firstPage;
     emit openAt(_index);
 
+    if (!archive.isSolid() && _extractionWorkers > 1 && _fileNames.size() > 1) {
+        QVector<quint32> failed = extractInParallel(_extractionWorkers);
+        if (!failed.isEmpty() && !_invalidated) {
+            // retry sequentially, this way the backend reports the errors as usual
+            std::sort(failed.begin(), failed.end());
+            archive.getAllData(failed, this);
+        }
+
+        moveToThread(QCoreApplication::instance()->thread());
+        if (!_invalidated) {
+            emit imagesLoaded();
+        }
+        return;
+    }
+
     int sectionIndex;
     QList<QVector<quint32>> sections = getSections(sectionIndex);
 
@@ -683,6 +888,7 @@ void FolderComic::process()
     int nPages = list.size();
     _pages.clear();
     _pages.resize(nPages);
+    _memoryUsage = 0;
     _loadedPages = QVector<bool>(nPages, false);
 
     if (nPages == 0) {
@@ -718,6 +924,7 @@ void FolderComic::process()
             QFile f(list.at(i).absoluteFilePath());
             f.open(QIODevice::ReadOnly);
             _pages[i] = f.readAll();
+            _memoryUsage += _pages[i].size();
             emit imageLoaded(i);
             emit imageLoaded(i, _pages[i]);
             i++;
@@ -738,12 +945,12 @@ void FolderComic::process()
 #ifndef NO_PDF
 
 PDFComic::PDFComic()
-    : Comic()
+    : Comic(), requestedPage(-1)
 {
 }
 
 PDFComic::PDFComic(const QString &path, int atPage)
-    : Comic(path, atPage)
+    : Comic(path, atPage), requestedPage(-1)
 {
     PDFComic::load(path, atPage);
 }
@@ -836,9 +1043,15 @@ void PDFComic::process()
     _loaded = true;
     // QMessageBox::critical(NULL,QString("%1").arg(nPages),tr("Invalid PDF file"));
 
-    _pages.clear();
-    _pages.resize(nPages);
-    _loadedPages = QVector<bool>(nPages, false);
+    {
+        QMutexLocker locker(&_decodedPagesMutex);
+        _pages.clear();
+        _pages.resize(nPages);
+        _memoryUsage = 0;
+        _decodedPages.clear();
+        _decodedPages.resize(nPages);
+        _loadedPages = QVector<bool>(nPages, false);
+    }
 
     if (_firstPage == -1) {
         _firstPage = bm->getLastPage();
@@ -851,50 +1064,159 @@ void PDFComic::process()
     _index = _firstPage;
     emit openAt(_index);
 
-    // buffer index to avoid race conditions
-    int buffered_index = _index;
-    for (int i = buffered_index; i < nPages; i++) {
-        if (_invalidated) {
-            moveToThread(QCoreApplication::instance()->thread());
-            return;
-        }
+    renderedFor = QVector<QSize>(nPages);
+    renderFailed = QVector<bool>(nPages, false);
+    previewSent = QVector<bool>(nPages, false);
 
-        renderPage(i);
+    QMutexLocker locker(&requestMutex);
+    if (requestedPage < 0 || requestedPage >= nPages) {
+        requestedPage = _index;
     }
-    for (int i = 0; i < buffered_index; i++) {
-        if (_invalidated) {
-            moveToThread(QCoreApplication::instance()->thread());
-            return;
+
+    const QMetaMethod compressedImageLoaded = QMetaMethod::fromSignal(QOverload<int, const QByteArray &>::of(&Comic::imageLoaded));
+    while (!_invalidated) {
+        int current = requestedPage;
+        QSize size = targetSize;
+
+        int page = nextPageToRender(current, size);
+        bool preview = false;
+        // once the pages around the current one are ready the thumbnails of the rest are rendered, if someone wants them
+        if (page == -1 && isSignalConnected(compressedImageLoaded)) {
+            page = nextPreviewToRender(current);
+            preview = page != -1;
+        }
+
+        if (page == -1) {
+            requestCondition.wait(&requestMutex);
+            continue;
         }
-        renderPage(i);
+
+        locker.unlock();
+        if (preview) {
+            QImage img = renderPage(page, QSize(decodedPagePreviewWidth, maxRenderDimension));
+            previewSent[page] = true;
+            if (!img.isNull()) {
+                emit imageLoaded(page, encodePage(img));
+            }
+        } else {
+            QImage img = renderPage(page, size);
+            if (img.isNull()) {
+                QLOG_WARN() << "Unable to render page" << page << "of" << _path;
+                renderFailed[page] = true;
+            } else {
+                renderedFor[page] = size;
+                previewSent[page] = true;
+                // the page is kept decoded, it is only encoded if its compressed data is needed
+                setPageImage(page, img);
+                releaseFarthestPages(current);
+            }
+        }
+        locker.relock();
     }
+    locker.unlock();
 
+    // the pages are rendered until the comic is invalidated, imagesLoaded is never emitted
     moveToThread(QCoreApplication::instance()->thread());
-    emit imagesLoaded();
 }
 
-void PDFComic::renderPage(int page)
+void PDFComic::requestPage(int page)
+{
+    QMutexLocker locker(&requestMutex);
+    if (requestedPage != page) {
+        requestedPage = page;
+        requestCondition.wakeAll();
+    }
+}
+
+void PDFComic::setPageTargetSize(const QSize &size)
+{
+    QMutexLocker locker(&requestMutex);
+    if (targetSize != size) {
+        targetSize = size;
+        requestCondition.wakeAll();
+    }
+}
+
+void PDFComic::invalidate()
+{
+    Comic::invalidate();
+    QMutexLocker locker(&requestMutex);
+    requestCondition.wakeAll();
+}
+
+int PDFComic::nextPageToRender(int current, const QSize &size)
 {
+    int nPages = renderedFor.size();
+    // closest pages first, the next ones before the previous ones
+    for (int distance = 0; distance <= qMax(prefetchAhead, prefetchBehind); distance++) {
+        for (int page : { current + distance, current - distance }) {
+            if (page < 0 || page >= nPages || renderFailed[page]) {
+                continue;
+            }
+            if ((page > current && distance > prefetchAhead) || (page < current && distance > prefetchBehind)) {
+                continue;
+            }
+            if (getDecodedPage(page).isNull() || !coversSize(renderedFor[page], size)) {
+                return page;
+            }
+        }
+    }
+    return -1;
+}
+
+int PDFComic::nextPreviewToRender(int current)
+{
+    int nPages = previewSent.size();
+    // closest pages first, the next ones before the previous ones
+    for (int distance = 0; distance <= previewWindow; distance++) {
+        for (int page : { current + distance, current - distance }) {
+            if (page >= 0 && page < nPages && !previewSent[page] && !renderFailed[page]) {
+                return page;
+            }
+        }
+    }
+    return -1;
+}
+
+void PDFComic::releaseFarthestPages(int current)
+{
+    QVector<int> decoded;
+    for (int page = 0; page < renderedFor.size(); page++) {
+        if (!getDecodedPage(page).isNull()) {
+            decoded.append(page);
+        }
+    }
+    if (decoded.size() <= maxDecodedPages) {
+        return;
+    }
+
+    std::sort(decoded.begin(), decoded.end(), [current](int a, int b) { return qAbs(a - current) > qAbs(b - current); });
+    for (int i = 0; i < decoded.size() - maxDecodedPages; i++) {
+        releasePage(decoded[i]);
+        renderedFor[decoded[i]] = QSize();
+    }
+}
+
+QImage PDFComic::renderPage(int page, const QSize &size)
+{
+    QSize boundedSize = size.isValid() ? size.boundedTo(QSize(maxRenderDimension, maxRenderDimension)) : size;
 #if defined Q_OS_MAC && defined USE_PDFKIT
-    QImage img = pdfComic->getPage(page);
-    if (!img.isNull()) {
+    return pdfComic->getPage(page, boundedSize);
 #elif defined USE_PDFIUM
-    QImage img = pdfComic->getPage(page);
-    if (!img.isNull()) {
+    return pdfComic->getPage(page, boundedSize);
 #else
     std::unique_ptr<Poppler::Page> pdfpage(pdfComic->page(page));
-    if (pdfpage) {
-        QImage img = pdfpage->renderToImage(150, 150);
-#endif
-        QByteArray ba;
-        QBuffer buf(&ba);
-        buf.open(QIODevice::WriteOnly);
-        img.save(&buf, "jpg", 96);
-        _pages[page] = ba;
-        buf.close();
-        emit imageLoaded(page);
-        emit imageLoaded(page, _pages[page]);
+    if (!pdfpage) {
+        return QImage();
+    }
+
+    double dpi = 150;
+    QSizeF pageSize = pdfpage->pageSizeF(); // points
+    if (boundedSize.isValid() && !pageSize.isEmpty()) {
+        dpi = 72 * qMin(boundedSize.width() / pageSize.width(), boundedSize.height() / pageSize.height());
     }
+    return pdfpage->renderToImage(dpi, dpi);
+#endif
 }
 
 #endif // NO_PDF
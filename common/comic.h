@@ -6,6 +6,8 @@
 #include <QByteArray>
 #include <QMap>
 
+#include <atomic>
+
 #include "extract_delegate.h"
 #include "bookmarks.h"
 #ifndef NO_PDF
@@ -21,6 +23,16 @@ class Comic : public QObject
 protected:
     // Comic pages, one QPixmap for each file.
     QVector<QByteArray> _pages;
+    // Pages produced already decoded (PDF), they are used as they are and their compressed data in
+    // _pages is only encoded if someone asks for it (getRawPage)
+    QVector<QImage> _decodedPages;
+    // guards _decodedPages, the compressed data encoded from them and _loadedPages, they can be replaced while they are read
+    QMutex _decodedPagesMutex;
+    // bytes held by _pages and _decodedPages, pages are stored from the loading thread
+    std::atomic<qint64> _memoryUsage { 0 };
+    // signaled when a page is loaded, the comic fails opening or it is invalidated
+    QMutex _pageLoadedMutex;
+    QWaitCondition _pageLoaded;
     QVector<bool> _loadedPages;
     // QVector<uint> _sizes;
     QStringList _fileNames;
@@ -37,10 +49,16 @@ protected:
 
     bool _isPDF;
 
-    bool _invalidated;
+    // read by the threads extracting pages while it is set from any thread
+    std::atomic<bool> _invalidated { false };
 
     bool _errorOpening;
 
+    void setPageImage(int page, const QImage &image);
+    // drops a decoded page, it isn't loaded anymore until it is set again
+    void releasePage(int page);
+    void wakePageWaiters();
+
 public:
     static const QStringList imageExtensions;
     static const QStringList literalImageExtensions;
@@ -71,11 +89,26 @@ public:
     // QPixmap * operator[](unsigned int index);
     QVector<QByteArray> *getRawData() { return &_pages; }
     QByteArray getRawPage(int page);
+    // null if the page only has compressed data
+    QImage getDecodedPage(int page);
+    // decoded page, from its compressed data if needed
+    QImage getPageImage(int page);
     bool pageIsLoaded(int page);
+    // blocks the calling thread until `page` is loaded, the comic fails opening or is invalidated, or `timeout` (ms)
+    // expires, returns whether the page is loaded. It can't be used from the thread loading the comic.
+    bool waitForPage(int page, int timeout);
+    // memory used by the loaded pages (compressed and decoded), in bytes
+    qint64 memoryUsage() const { return _memoryUsage; }
 
     // check if the comic has failed loading
     bool hasBeenAnErrorOpening();
 
+    // Hints for comics that produce their pages on demand (PDF), the rest load all their pages anyway.
+    // requestPage() asks for `page` (and the pages around it) to be loaded soon. `size` is the size, in
+    // device pixels, pages have to fit in without being enlarged, an invalid size means the default resolution.
+    virtual void requestPage(int page) { Q_UNUSED(page) }
+    virtual void setPageTargetSize(const QSize &size) { Q_UNUSED(size) }
+
     static QStringList getSupportedImageFormats();
     static QStringList getSupportedImageLiteralFormats();
 
@@ -91,14 +124,17 @@ public slots:
     void checkIsBookmark(int index);
     void updateBookmarkImage(int);
     void setPageLoaded(int page);
-    void invalidate();
+    virtual void invalidate();
     virtual void process() {};
 
 signals:
     void invalidated();
     void destroyed();
+    // all the pages are loaded. It isn't emitted when the comic is invalidated before, nor by PDF comics (they render
+    // pages on demand until they are invalidated), so the loading thread must also be stopped on invalidated()
     void imagesLoaded();
     void imageLoaded(int index);
+    // compressed data of the page, a reduced copy is sent for decoded pages
     void imageLoaded(int index, const QByteArray &image);
     void pageChanged(int index);
     void openAt(int index);
@@ -117,7 +153,11 @@ class FileComic : public Comic, public ExtractDelegate
     Q_OBJECT
 
 private:
+    static constexpr int maxExtractionWorkers = 4;
+    int _extractionWorkers;
+
     QList<QVector<quint32>> getSections(int &sectionIndex);
+    QVector<quint32> extractInParallel(int workers);
 
 public:
     FileComic();
@@ -126,6 +166,8 @@ public:
     bool load(const QString &path, int atPage = -1);
     bool load(const QString &path, const ComicDB &comic);
     static QList<QString> filter(const QList<QString> &src);
+    // threads extracting the pages of non-solid archives, 1 extracts all the archives in the loading thread
+    void setExtractionWorkers(int workers);
 
     // ExtractDelegate
     void fileExtracted(int index, const QByteArray &rawData);
@@ -171,7 +213,27 @@ private:
 #else
     std::unique_ptr<Poppler::Document> pdfComic;
 #endif
-    void renderPage(int page);
+    // pages are rendered when they are needed: the requested page first, then the pages around it
+    static constexpr int prefetchAhead = 4;
+    static constexpr int prefetchBehind = 4;
+    static constexpr int maxDecodedPages = 16;
+    static constexpr int maxRenderDimension = 8192;
+    // thumbnails are only rendered for the pages around the current one
+    static constexpr int previewWindow = 20;
+
+    QMutex requestMutex;
+    QWaitCondition requestCondition;
+    int requestedPage;
+    QSize targetSize;
+    // target size used for each decoded page, they are rendered again if they are needed bigger
+    QVector<QSize> renderedFor;
+    QVector<bool> renderFailed;
+    QVector<bool> previewSent;
+
+    QImage renderPage(int page, const QSize &size);
+    int nextPageToRender(int current, const QSize &size);
+    int nextPreviewToRender(int current);
+    void releaseFarthestPages(int current);
 
     // void run();
 
@@ -183,9 +245,13 @@ public:
     bool load(const QString &path, int atPage = -1);
     bool load(const QString &path, const ComicDB &comic);
 
+    void requestPage(int page) override;
+    void setPageTargetSize(const QSize &size) override;
+
 public slots:
 
     void process();
+    void invalidate() override;
 };
 #endif // NO_PDF
 class FactoryComic
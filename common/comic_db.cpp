@@ -1,5 +1,7 @@
 #include "comic_db.h"
 
+#include "cover_store.h"
+
 #include <QVariant>
 #include <QFileInfo>
 
@@ -425,7 +427,7 @@ void ComicInfo::setNotes(QString value)
 QPixmap ComicInfo::getCover(const QString &basePath)
 {
     if (cover.isNull()) {
-        cover.load(basePath + "/.yacreaderlibrary/covers/" + hash + ".jpg");
+        cover.load(YACReader::CoverStore::forLibrary(basePath + "/.yacreaderlibrary")->coverPath(hash));
     }
     QPixmap c;
     c.convertFromImage(cover);
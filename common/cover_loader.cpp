@@ -0,0 +1,142 @@
+#include "cover_loader.h"
+
+#include <QImageReader>
+#include <QThread>
+
+#include <algorithm>
+
+using namespace YACReader;
+
+namespace {
+
+std::size_t loaderThreadCount()
+{
+    return std::clamp(QThread::idealThreadCount(), 2, 4);
+}
+
+QImage loadCover(const QString &path, int width)
+{
+    QImageReader reader(path);
+
+    QSize size = reader.size();
+    if (width > 0 && size.isValid() && size.width() > width) {
+        reader.setScaledSize(QSize(width, qRound(static_cast<qreal>(size.height()) * width / size.width())));
+    }
+
+    return reader.read();
+}
+
+}
+
+CoverLoader::CoverLoader()
+    : generation(0), coverWidth(0), workers(loaderThreadCount())
+{
+}
+
+CoverLoader::~CoverLoader()
+{
+    workers.cancelPending();
+}
+
+void CoverLoader::setCoverWidth(int width)
+{
+    QMutexLocker locker(&mutex);
+    coverWidth = width;
+}
+
+void CoverLoader::load(const QList<Request> &requests)
+{
+    QList<Request> newPending;
+
+    {
+        QMutexLocker locker(&mutex);
+
+        QSet<int> alreadyLoaded;
+        for (const auto &cover : loaded) {
+            alreadyLoaded.insert(cover.index);
+        }
+
+        for (const auto &request : requests) {
+            if (!running.contains(request.index) && !alreadyLoaded.contains(request.index)) {
+                newPending.append(request);
+            }
+        }
+
+        // the flows ask for the same covers until they are loaded
+        bool samePending = newPending.size() == pending.size()
+                && std::equal(newPending.cbegin(), newPending.cend(), pending.cbegin(), [](const Request &r1, const Request &r2) {
+                       return r1.index == r2.index;
+                   });
+        if (samePending) {
+            return;
+        }
+
+        pending = newPending;
+    }
+
+    // every job loads the first pending cover when it runs, so the jobs of the previous requests aren't needed
+    workers.cancelPending();
+    for (int i = 0; i < newPending.size(); i++) {
+        workers.enqueue([this] { loadNext(); });
+    }
+}
+
+void CoverLoader::reset()
+{
+    workers.cancelPending();
+
+    QMutexLocker locker(&mutex);
+    pending.clear();
+    running.clear();
+    loaded.clear();
+    generation++;
+}
+
+bool CoverLoader::isLoading() const
+{
+    QMutexLocker locker(&mutex);
+    return !pending.isEmpty() || !running.isEmpty() || !loaded.isEmpty();
+}
+
+QList<CoverLoader::Cover> CoverLoader::takeLoaded(int max)
+{
+    QMutexLocker locker(&mutex);
+
+    if (max < 0 || max >= loaded.size()) {
+        QList<Cover> covers;
+        covers.swap(loaded);
+        return covers;
+    }
+
+    QList<Cover> covers = loaded.mid(0, max);
+    loaded.erase(loaded.begin(), loaded.begin() + max);
+    return covers;
+}
+
+void CoverLoader::loadNext()
+{
+    Request request;
+    quint64 requestGeneration;
+    int width;
+
+    {
+        QMutexLocker locker(&mutex);
+        if (pending.isEmpty()) {
+            return;
+        }
+
+        request = pending.takeFirst();
+        running.insert(request.index);
+        requestGeneration = generation;
+        width = coverWidth;
+    }
+
+    QImage image = loadCover(request.path, width);
+
+    QMutexLocker locker(&mutex);
+    // covers requested before a reset don't belong to the current covers
+    if (requestGeneration == generation) {
+        running.remove(request.index);
+        loaded.append({ request.index, image });
+    }
+}
@@ -0,0 +1,66 @@
+#ifndef COVER_LOADER_H
+#define COVER_LOADER_H
+
+#include <QImage>
+#include <QList>
+#include <QMutex>
+#include <QSet>
+#include <QString>
+
+#include "concurrent_queue.h"
+
+namespace YACReader {
+
+// Loads the covers shown by the flows (ComicFlow and YACReaderComicFlowGL) using several threads.
+//
+// The flows ask for the covers around the current one, closest first, every time they check for new covers;
+// the covers waiting to be loaded are replaced by the new ones, so moving through a big folder doesn't load
+// the covers left behind. Covers are decoded scaled to the width the flow needs (the JPEG decoder scales
+// them while decoding) and the flows take the loaded ones from the UI thread when they can show them.
+class CoverLoader
+{
+public:
+    struct Request {
+        int index;
+        QString path;
+    };
+
+    struct Cover {
+        int index;
+        QImage image; // null if the cover couldn't be loaded
+    };
+
+    CoverLoader();
+    ~CoverLoader();
+
+    // covers wider than `width` are scaled down while they are decoded, 0 keeps their size
+    void setCoverWidth(int width);
+
+    // replaces the covers waiting to be loaded by `requests`, they are loaded in order. Covers being loaded or
+    // loaded and not taken yet are skipped.
+    void load(const QList<Request> &requests);
+    // forgets every request (e.g. the covers of the flow have changed), loads still running are discarded
+    void reset();
+
+    // true until all the requested covers are loaded and taken
+    bool isLoading() const;
+    // takes at most `max` (-1 for all) of the covers loaded so far
+    QList<Cover> takeLoaded(int max = -1);
+
+private:
+    void loadNext();
+
+    mutable QMutex mutex;
+    QList<Request> pending;
+    QSet<int> running;
+    QList<Cover> loaded;
+    quint64 generation;
+    int coverWidth;
+
+    // declared last, its threads must be joined before the rest of the members are destroyed
+    ConcurrentQueue workers;
+};
+
+}
+
+#endif // COVER_LOADER_H
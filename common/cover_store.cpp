@@ -0,0 +1,300 @@
+#include "cover_store.h"
+
+#include <QBuffer>
+#include <QDir>
+#include <QDirIterator>
+#include <QFile>
+#include <QFileInfo>
+
+using namespace YACReader;
+
+namespace {
+const quint8 allSizes = (1 << (CoverStore::Full + 1)) - 1;
+}
+
+CoverStore::CoverStore(const QString &libraryDataPath)
+    : coversPath(libraryDataPath + "/covers"), indexLoaded(false)
+{
+}
+
+std::shared_ptr<CoverStore> CoverStore::forLibrary(const QString &libraryDataPath)
+{
+    static QMutex storesMutex;
+    static QHash<QString, std::shared_ptr<CoverStore>> stores;
+
+    QMutexLocker locker(&storesMutex);
+    auto key = QDir::cleanPath(libraryDataPath);
+    auto store = stores.value(key);
+    if (store == nullptr) {
+        store = std::make_shared<CoverStore>(key);
+        store->loadIndex();
+        stores.insert(key, store);
+    }
+
+    return store;
+}
+
+QString CoverStore::filePath(const QString &hash, Size size) const
+{
+    return sizePath(coversPath + "/" + hash.left(2) + "/" + hash + ".jpg", size);
+}
+
+QString CoverStore::coverPath(const QString &hash, Size size) const
+{
+    for (int s = size; s <= Full; s++) {
+        if (isStored(hash, static_cast<Size>(s))) {
+            return filePath(hash, static_cast<Size>(s));
+        }
+    }
+
+    if (isLegacyCover(hash)) {
+        return coversPath + "/" + hash + ".jpg";
+    }
+
+    return filePath(hash, Full);
+}
+
+QUrl CoverStore::coverUrl(const QString &hash, Size size) const
+{
+    return QUrl("file:" + coverPath(hash, size));
+}
+
+CoverStore::Size CoverStore::fittingSize(const QSize &size)
+{
+    for (int s = Thumbnail; s < Full; s++) {
+        int width = sizeWidth(static_cast<Size>(s));
+        if (width >= size.width() && width * 3 / 2 >= size.height()) {
+            return static_cast<Size>(s);
+        }
+    }
+
+    return Full;
+}
+
+CoverStore::EncodedCover CoverStore::encode(const QImage &cover, int quality)
+{
+    EncodedCover encoded;
+
+    for (int s = Thumbnail; s <= Full; s++) {
+        auto size = static_cast<Size>(s);
+        QImage scaled = cover;
+        if (size != Full) {
+            // the views crop the covers to fill their cells, a size box is 2:3
+            QSize box(sizeWidth(size), sizeWidth(size) * 3 / 2);
+            if (cover.width() > box.width() && cover.height() > box.height()) {
+                scaled = cover.scaled(box, Qt::KeepAspectRatioByExpanding, Qt::SmoothTransformation);
+            }
+        }
+
+        QBuffer buffer(&encoded.data[size]);
+        buffer.open(QIODevice::WriteOnly);
+        scaled.save(&buffer, "JPG", quality);
+    }
+
+    return encoded;
+}
+
+bool CoverStore::writeFile(const QString &path, const EncodedCover &cover)
+{
+    // the full size is written last, a cover is only considered stored when all its sizes are
+    for (int s = Thumbnail; s <= Full; s++) {
+        QFile file(sizePath(path, static_cast<Size>(s)));
+        if (!file.open(QFile::WriteOnly | QFile::Truncate)) {
+            QDir().mkpath(QFileInfo(path).absolutePath());
+            if (!file.open(QFile::WriteOnly | QFile::Truncate)) {
+                return false;
+            }
+        }
+        file.write(cover.data[s]);
+    }
+
+    return true;
+}
+
+bool CoverStore::write(const QString &hash, const EncodedCover &cover)
+{
+    if (!writeFile(filePath(hash), cover)) {
+        return false;
+    }
+
+    QMutexLocker locker(&indexMutex);
+    if (indexLoaded) {
+        index.insert(hash, allSizes);
+    }
+
+    return true;
+}
+
+bool CoverStore::createSizes(const QString &hash)
+{
+    QImage cover(coverPath(hash));
+    if (cover.isNull()) {
+        return false;
+    }
+
+    return write(hash, encode(cover));
+}
+
+void CoverStore::loadIndex()
+{
+    QHash<QString, quint8> covers;
+    QSet<QString> legacyCovers;
+
+    QDirIterator legacyFiles(coversPath, { "*.jpg" }, QDir::Files);
+    while (legacyFiles.hasNext()) {
+        legacyFiles.next();
+        legacyCovers.insert(legacyFiles.fileName().chopped(4));
+    }
+
+    QDirIterator shards(coversPath, QDir::Dirs | QDir::NoDotAndDotDot);
+    while (shards.hasNext()) {
+        QDirIterator files(shards.next(), { "*.jpg" }, QDir::Files);
+        while (files.hasNext()) {
+            files.next();
+            // <hash>.jpg or <hash>.<size>.jpg
+            auto parts = files.fileName().split('.');
+            if (parts.size() > 3) {
+                continue;
+            }
+            Size size = Full;
+            if (parts.size() == 3) {
+                for (int s = Thumbnail; s < Full; s++) {
+                    if (parts.at(1) == sizeSuffix(static_cast<Size>(s))) {
+                        size = static_cast<Size>(s);
+                    }
+                }
+            }
+            covers[parts.first()] |= 1 << size;
+        }
+    }
+
+    QMutexLocker locker(&indexMutex);
+    index = covers;
+    legacyIndex = legacyCovers;
+    indexLoaded = true;
+}
+
+bool CoverStore::contains(const QString &hash) const
+{
+    return isStored(hash, Full);
+}
+
+bool CoverStore::containsAllSizes(const QString &hash) const
+{
+    for (int s = Thumbnail; s <= Full; s++) {
+        if (!isStored(hash, static_cast<Size>(s))) {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+QStringList CoverStore::incompleteCovers() const
+{
+    QStringList hashes;
+
+    QMutexLocker locker(&indexMutex);
+    for (auto cover = index.cbegin(); cover != index.cend(); ++cover) {
+        if ((cover.value() & (1 << Full)) && cover.value() != allSizes) {
+            hashes.append(cover.key());
+        }
+    }
+
+    return hashes;
+}
+
+int CoverStore::migrate()
+{
+    int moved = 0;
+
+    QDir covers(coversPath);
+    const auto legacyCovers = covers.entryList({ "*.jpg" }, QDir::Files);
+    for (const auto &fileName : legacyCovers) {
+        auto hash = fileName.chopped(4);
+        auto destination = filePath(hash);
+        QDir().mkpath(QFileInfo(destination).absolutePath());
+
+        // a cover stored by a newer scan wins
+        if (QFile::exists(destination)) {
+            covers.remove(fileName);
+        } else if (covers.rename(fileName, destination)) {
+            moved++;
+        } else {
+            continue;
+        }
+
+        QMutexLocker locker(&indexMutex);
+        if (indexLoaded) {
+            legacyIndex.remove(hash);
+            index[hash] |= 1 << Full;
+        }
+    }
+
+    return moved;
+}
+
+const char *CoverStore::sizeSuffix(Size size)
+{
+    switch (size) {
+    case Thumbnail:
+        return "thumbnail";
+    case Grid:
+        return "grid";
+    case Flow:
+        return "flow";
+    case Full:
+        break;
+    }
+
+    return "";
+}
+
+int CoverStore::sizeWidth(Size size)
+{
+    switch (size) {
+    case Thumbnail:
+        return 120;
+    case Grid:
+        return 320;
+    case Flow:
+        return 400;
+    case Full:
+        break;
+    }
+
+    return 0;
+}
+
+QString CoverStore::sizePath(const QString &path, Size size)
+{
+    if (size == Full) {
+        return path;
+    }
+
+    return path.chopped(3) + sizeSuffix(size) + ".jpg";
+}
+
+bool CoverStore::isStored(const QString &hash, Size size) const
+{
+    {
+        QMutexLocker locker(&indexMutex);
+        if (indexLoaded) {
+            return index.value(hash) & (1 << size);
+        }
+    }
+
+    return QFile::exists(filePath(hash, size));
+}
+
+bool CoverStore::isLegacyCover(const QString &hash) const
+{
+    {
+        QMutexLocker locker(&indexMutex);
+        if (indexLoaded) {
+            return legacyIndex.contains(hash);
+        }
+    }
+
+    return QFile::exists(coversPath + "/" + hash + ".jpg");
+}
@@ -0,0 +1,100 @@
+#ifndef COVER_STORE_H
+#define COVER_STORE_H
+
+#include <QByteArray>
+#include <QHash>
+#include <QImage>
+#include <QMutex>
+#include <QSet>
+#include <QString>
+#include <QStringList>
+#include <QUrl>
+
+#include <memory>
+
+namespace YACReader {
+
+// Covers of a library, stored in .yacreaderlibrary/covers. Covers are named after the hash of their comic and
+// sharded in subfolders named after the first two characters of the hash (a folder with 100k+ files is very slow
+// in some file systems). Every cover is stored in several sizes, so the views don't need to decode and scale the
+// full cover:
+//
+//   covers/3f/3f0a...91.jpg            full size (the size the covers always had, 480px wide for most comics)
+//   covers/3f/3f0a...91.flow.jpg       other sizes, scaled to fill the size box
+//
+// Covers stored by older versions (covers/<hash>.jpg) are still found until migrate() moves them.
+class CoverStore
+{
+public:
+    enum Size {
+        Thumbnail,
+        Grid,
+        Flow,
+        Full,
+    };
+
+    // JPEG data of every size of a cover
+    struct EncodedCover {
+        QByteArray data[Full + 1];
+
+        bool isEmpty() const { return data[Full].isEmpty(); }
+    };
+
+    // `libraryDataPath` is the .yacreaderlibrary folder of the library
+    explicit CoverStore(const QString &libraryDataPath);
+    // the store shared by everything showing or writing the covers of the library, its index is loaded the first time
+    // it is requested, so finding covers doesn't need any file system call
+    static std::shared_ptr<CoverStore> forLibrary(const QString &libraryDataPath);
+
+    // where the cover of `hash` is stored at `size`
+    QString filePath(const QString &hash, Size size = Full) const;
+    // the file to show the cover of `hash` at `size`, a bigger size is used if `size` isn't stored yet
+    // (e.g. covers stored by older versions)
+    QString coverPath(const QString &hash, Size size = Full) const;
+    QUrl coverUrl(const QString &hash, Size size = Full) const;
+    // the smallest size that fills `size` (width x height in pixels, 0 if any is fine), Full if none does
+    static Size fittingSize(const QSize &size);
+
+    // encodes all the sizes of `cover` (already scaled to the full size), it can be used in any thread
+    static EncodedCover encode(const QImage &cover, int quality = 75);
+    // writes all the sizes of a cover, `path` is the full size path (see filePath()). It doesn't update any index, use
+    // write() on the store of the library when there is one
+    static bool writeFile(const QString &path, const EncodedCover &cover);
+
+    // writes the cover of `hash` and adds it to the index
+    bool write(const QString &hash, const EncodedCover &cover);
+    // creates the sizes of a cover that only has the full size stored
+    bool createSizes(const QString &hash);
+
+    // Existence index, it is loaded listing the shard folders once, so checking lots of covers (e.g. in a library
+    // update) doesn't need a file system call per cover. Covers written by this store are added to the index, once
+    // it is loaded covers not found in it aren't stored (they are looked up in the file system until then). All the
+    // methods are thread safe.
+    void loadIndex();
+    // true if the full size of the cover is stored
+    bool contains(const QString &hash) const;
+    bool containsAllSizes(const QString &hash) const;
+    // covers in the index that only have some of the sizes stored
+    QStringList incompleteCovers() const;
+
+    // moves the covers stored by older versions in the covers folder to their shard, returns the number of moved covers
+    int migrate();
+
+private:
+    static const char *sizeSuffix(Size size);
+    static int sizeWidth(Size size);
+    static QString sizePath(const QString &path, Size size);
+    bool isStored(const QString &hash, Size size) const;
+    bool isLegacyCover(const QString &hash) const;
+
+    QString coversPath;
+
+    mutable QMutex indexMutex;
+    bool indexLoaded;
+    QHash<QString, quint8> index; // hash -> stored sizes (bit mask)
+    QSet<QString> legacyIndex; // covers stored by older versions
+};
+
+}
+
+#endif // COVER_STORE_H
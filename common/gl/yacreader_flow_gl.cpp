@@ -1,4 +1,5 @@
 #include "yacreader_flow_gl.h"
+#include "cover_loader.h"
 
 #include <QtGui>
 #include <QMatrix4x4>
@@ -661,7 +662,9 @@ void YACReaderFlowGL::updatePositions()
         {
 
             updateCount = 0;
-            updateImageData();
+            // keep drawing frames until the covers are ready
+            if (updateImageData())
+                stopAnimation = false;
         } else
             updateCount++;
     } else
@@ -1127,15 +1130,15 @@ QVector3D YACReaderFlowGL::getPlaneIntersection(int x, int y, YACReader3DImage p
 }
 
 YACReaderComicFlowGL::YACReaderComicFlowGL(QWidget *parent, struct Preset p)
-    : YACReaderFlowGL(parent, p)
+    : YACReaderFlowGL(parent, p), loader(new YACReader::CoverLoader)
 {
-    worker = new ImageLoaderGL(this);
-    worker->flow = this;
 }
 
+YACReaderComicFlowGL::~YACReaderComicFlowGL() = default;
+
 void YACReaderComicFlowGL::setImagePaths(QStringList paths)
 {
-    worker->reset();
+    loader->reset();
     reset();
     numObjects = 0;
     if (lazyPopulateObjects != -1 || hasBeenInitialized)
@@ -1151,93 +1154,88 @@ void YACReaderComicFlowGL::setImagePaths(QStringList paths)
 //////////////////////////////////////////////////////////////////////////
 //////////////////////////////////////////////////////////////////////////
 
-void YACReaderComicFlowGL::updateImageData()
+bool YACReaderComicFlowGL::updateImageData()
 {
-    // can't do anything, wait for the next possibility
-    if (worker->busy())
-        return;
+    // create the textures of the covers loaded since the last frame
+    const auto covers = loader->takeLoaded(maxTexturesPerFrame);
+    for (const auto &cover : covers) {
+        int idx = cover.index;
+        if (idx >= numObjects || loaded[idx])
+            continue;
 
-    // set image of last one
-    int idx = worker->index();
-    if (idx >= 0 && !worker->result().isNull()) {
-        if (!loaded[idx]) {
-            float x = 1;
-            QImage img = worker->result();
-            QOpenGLTexture *texture = new QOpenGLTexture(img);
+        // covers that can't be loaded keep the default texture, they aren't requested again
+        if (cover.image.isNull()) {
+            loaded[idx] = true;
+            continue;
+        }
 
-            if (performance == high || performance == ultraHigh) {
-                texture->setAutoMipMapGenerationEnabled(true);
-                texture->setMinMagFilters(QOpenGLTexture::LinearMipMapLinear, QOpenGLTexture::LinearMipMapLinear);
-            } else {
-                texture->setMinMagFilters(QOpenGLTexture::Linear, QOpenGLTexture::Linear);
-            }
+        float x = 1;
+        const QImage &img = cover.image;
+        QOpenGLTexture *texture = new QOpenGLTexture(img);
 
-            float y = 1 * (float(img.height()) / img.width());
-            QString s = "cover";
-            replace(s.toLocal8Bit().data(), texture, x, y, idx);
+        if (performance == high || performance == ultraHigh) {
+            texture->setAutoMipMapGenerationEnabled(true);
+            texture->setMinMagFilters(QOpenGLTexture::LinearMipMapLinear, QOpenGLTexture::LinearMipMapLinear);
+        } else {
+            texture->setMinMagFilters(QOpenGLTexture::Linear, QOpenGLTexture::Linear);
         }
+
+        float y = 1 * (float(img.height()) / img.width());
+        QString s = "cover";
+        replace(s.toLocal8Bit().data(), texture, x, y, idx);
     }
 
     // try to load only few images on the left and right side
     // i.e. all visible ones plus some extra
+    // covers are decoded at the width they are drawn at
     int count = 8;
     switch (performance) {
     case low:
         count = 8;
+        loader->setCoverWidth(200);
         break;
     case medium:
         count = 10;
+        loader->setCoverWidth(256);
         break;
     case high:
         count = 12;
+        loader->setCoverWidth(320);
         break;
     case ultraHigh:
         count = 14;
+        loader->setCoverWidth(0); // no scaling in ultraHigh
         break;
     }
-    int *indexes = new int[2 * count + 1];
+
     int center = currentSelected;
-    indexes[0] = center;
+    QList<int> indexes { center };
     for (int j = 0; j < count; j++) {
-        indexes[j * 2 + 1] = center + j + 1;
-        indexes[j * 2 + 2] = center - j - 1;
+        indexes << center + j + 1 << center - j - 1;
     }
-    for (int c = 0; c < 2 * count + 1; c++) {
-        int i = indexes[c];
-        if ((i >= 0) && (i < numObjects))
-            if (!loaded[i]) // slide(i).isNull())
-            {
-                // loader->loadTexture(i);
-                // loaded[i]=true;
-                //  schedule thumbnail generation
-                if (paths.size() > 0) {
-                    QString fname = paths.at(i);
-                    // loaded[i]=true;
-
-                    worker->generate(i, fname);
-                }
-                delete[] indexes;
-                return;
-            }
+    // the closest covers to the center are loaded first
+    QList<YACReader::CoverLoader::Request> requests;
+    for (int i : indexes) {
+        if ((i >= 0) && (i < numObjects) && (i < paths.size()) && !loaded[i])
+            requests.append({ i, paths.at(i) });
     }
 
-    delete[] indexes;
+    loader->load(requests);
+
+    return loader->isLoading();
 }
 
 void YACReaderComicFlowGL::remove(int item)
 {
-    worker->lock();
-    worker->reset();
+    loader->reset();
     YACReaderFlowGL::remove(item);
     if (item >= 0 && item < paths.size())
         paths.removeAt(item);
-    worker->unlock();
 }
 
 void YACReaderComicFlowGL::resortCovers(QList<int> newOrder)
 {
-    worker->lock();
-    worker->reset(); // is this necesary?
+    loader->reset();
     startAnimationTimer();
     QList<QString> pathsNew;
     QVector<bool> loadedNew;
@@ -1257,8 +1255,6 @@ void YACReaderComicFlowGL::resortCovers(QList<int> newOrder)
     loaded = loadedNew;
     marks = marksNew;
     images = imagesNew;
-
-    worker->unlock();
 }
 
 YACReaderPageFlowGL::YACReaderPageFlowGL(QWidget *parent, struct Preset p)
@@ -1300,11 +1296,11 @@ YACReaderPageFlowGL::~YACReaderPageFlowGL()
 //////////////////////////////////////////////////////////////////////////
 //////////////////////////////////////////////////////////////////////////
 
-void YACReaderPageFlowGL::updateImageData()
+bool YACReaderPageFlowGL::updateImageData()
 {
     // can't do anything, wait for the next possibility
     if (worker->busy())
-        return;
+        return true;
 
     // set image of last one
     int idx = worker->index();
@@ -1362,11 +1358,12 @@ void YACReaderPageFlowGL::updateImageData()
                     worker->generate(i, rawImages.at(i));
 
                     delete[] indexes;
-                    return;
+                    return true;
                 }
     }
 
     delete[] indexes;
+    return false;
 }
 
 void YACReaderPageFlowGL::populate(int n)
@@ -1380,111 +1377,6 @@ void YACReaderPageFlowGL::populate(int n)
     imagesSetted = QVector<bool>(n, false); // puede sobrar
 }
 
-//-----------------------------------------------------------------------------
-// ImageLoader
-//-----------------------------------------------------------------------------
-QImage ImageLoaderGL::loadImage(const QString &fileName)
-{
-    QImage image;
-
-    if (!image.load(fileName)) {
-        return QImage();
-    }
-
-    switch (flow->performance) {
-    case low:
-        image = image.scaledToWidth(200, Qt::SmoothTransformation);
-        break;
-    case medium:
-        image = image.scaledToWidth(256, Qt::SmoothTransformation);
-        break;
-    case high:
-        image = image.scaledToWidth(320, Qt::SmoothTransformation);
-        break;
-    case ultraHigh:
-        break; // no scaling in ultraHigh
-    }
-
-    return image;
-}
-
-ImageLoaderGL::ImageLoaderGL(YACReaderFlowGL *flow)
-    : QThread(), flow(flow), restart(false), working(false), idx(-1)
-{
-}
-
-ImageLoaderGL::~ImageLoaderGL()
-{
-    mutex.lock();
-    condition.wakeOne();
-    mutex.unlock();
-    wait();
-}
-
-bool ImageLoaderGL::busy() const
-{
-    return isRunning() ? working : false;
-}
-
-void ImageLoaderGL::generate(int index, const QString &fileName)
-{
-    mutex.lock();
-    this->idx = index;
-    this->fileName = fileName;
-    this->size = size;
-    this->img = QImage();
-    mutex.unlock();
-
-    if (!isRunning())
-        start();
-    else {
-        // already running, wake up whenever ready
-        restart = true;
-        condition.wakeOne();
-    }
-}
-
-void ImageLoaderGL::lock()
-{
-    mutex.lock();
-}
-
-void ImageLoaderGL::unlock()
-{
-    mutex.unlock();
-}
-
-void ImageLoaderGL::run()
-{
-    for (;;) {
-        // copy necessary data
-        mutex.lock();
-        this->working = true;
-        QString fileName = this->fileName;
-        mutex.unlock();
-
-        QImage image = loadImage(fileName);
-
-        // let everyone knows it is ready
-        mutex.lock();
-        this->working = false;
-        this->img = image;
-        mutex.unlock();
-
-        // put to sleep
-        mutex.lock();
-        if (!this->restart)
-            condition.wait(&mutex);
-        restart = false;
-        mutex.unlock();
-    }
-}
-
-QImage ImageLoaderGL::result()
-{
-    return img;
-}
-
 //-----------------------------------------------------------------------------
 // ImageLoader
 //-----------------------------------------------------------------------------
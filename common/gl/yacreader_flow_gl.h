@@ -18,7 +18,11 @@
 #include "pictureflow.h" //TODO mover los tipos de flow de sitio
 #include "scroll_management.h"
 
-class ImageLoaderGL;
+#include <memory>
+
+namespace YACReader {
+class CoverLoader;
+}
 class ImageLoaderByteArrayGL;
 
 enum Performance {
@@ -253,7 +257,8 @@ public slots:
 
     void setFlowRightToLeft(bool b);
 
-    virtual void updateImageData() = 0;
+    // returns true while there are covers being loaded, the animation timer keeps running to show them
+    virtual bool updateImageData() = 0;
 
     void reset();
     void reload();
@@ -280,7 +285,6 @@ public slots:
     void wheelEvent(QWheelEvent *event);
     void keyPressEvent(QKeyEvent *event);
     void resizeGL(int width, int height);
-    friend class ImageLoaderGL;
     friend class ImageLoaderByteArrayGL;
 
 signals:
@@ -292,14 +296,17 @@ class YACReaderComicFlowGL : public YACReaderFlowGL
 {
 public:
     YACReaderComicFlowGL(QWidget *parent = 0, struct Preset p = defaultYACReaderFlowConfig);
+    ~YACReaderComicFlowGL();
     void setImagePaths(QStringList paths);
-    void updateImageData();
+    bool updateImageData();
     void remove(int item);
     void resortCovers(QList<int> newOrder);
-    friend class ImageLoaderGL;
 
 private:
-    ImageLoaderGL *worker;
+    // textures created in a frame, the rest of the loaded covers wait for the next frames
+    static const int maxTexturesPerFrame = 8;
+
+    std::unique_ptr<YACReader::CoverLoader> loader;
 
 protected:
     QList<QString> paths;
@@ -310,7 +317,7 @@ class YACReaderPageFlowGL : public YACReaderFlowGL
 public:
     YACReaderPageFlowGL(QWidget *parent = 0, struct Preset p = defaultYACReaderFlowConfig);
     ~YACReaderPageFlowGL();
-    void updateImageData();
+    bool updateImageData();
     void populate(int n);
     QVector<bool> imagesReady;
     QVector<QByteArray> rawImages;
@@ -321,42 +328,6 @@ private:
     ImageLoaderByteArrayGL *worker;
 };
 
-class ImageLoaderGL : public QThread
-{
-public:
-    ImageLoaderGL(YACReaderFlowGL *flow);
-    ~ImageLoaderGL();
-    // returns FALSE if worker is still busy and can't take the task
-    bool busy() const;
-    void generate(int index, const QString &fileName);
-    void reset()
-    {
-        idx = -1;
-        fileName = "";
-    }
-    int index() const { return idx; }
-    void lock();
-    void unlock();
-    QImage result();
-    YACReaderFlowGL *flow;
-    GLuint resultTexture;
-    QImage loadImage(const QString &fileName);
-
-protected:
-    void run();
-
-private:
-    QMutex mutex;
-    QWaitCondition condition;
-
-    bool restart;
-    bool working;
-    int idx;
-    QString fileName;
-    QSize size;
-    QImage img;
-};
-
 class ImageLoaderByteArrayGL : public QThread
 {
 public:
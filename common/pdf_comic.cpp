@@ -86,7 +86,7 @@ unsigned int PdfiumComic::numPages()
     }
 }
 
-QImage PdfiumComic::getPage(const int page)
+QImage PdfiumComic::getPage(const int page, const QSize &size)
 {
     if (!doc) {
         return QImage();
@@ -105,12 +105,16 @@ QImage PdfiumComic::getPage(const int page)
         return QImage();
     }
 
-    // TODO: make target DPI configurable
-    QSize pagesize((FPDF_GetPageWidth(pdfpage) / 72) * 150,
-                   (FPDF_GetPageHeight(pdfpage) / 72) * 150);
-    // TODO: max render size too
-    if (pagesize.width() > 3840 || pagesize.height() > 3840) {
-        pagesize.scale(3840, 3840, Qt::KeepAspectRatio);
+    QSize pagesize;
+    if (size.isValid()) {
+        pagesize = QSizeF(FPDF_GetPageWidth(pdfpage), FPDF_GetPageHeight(pdfpage)).scaled(QSizeF(size), Qt::KeepAspectRatio).toSize();
+    } else {
+        pagesize = QSize((FPDF_GetPageWidth(pdfpage) / 72) * 150,
+                         (FPDF_GetPageHeight(pdfpage) / 72) * 150);
+        // TODO: max render size too
+        if (pagesize.width() > 3840 || pagesize.height() > 3840) {
+            pagesize.scale(3840, 3840, Qt::KeepAspectRatio);
+        }
     }
     image = QImage(pagesize, QImage::Format_ARGB32); // QImage::Format_RGBX8888);
     if (image.isNull()) {
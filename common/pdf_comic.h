@@ -16,7 +16,8 @@ public:
     bool openComic(const QString &path);
     void closeComic();
     unsigned int numPages();
-    QImage getPage(const int page);
+    // renders the page to fit in `size`, or at the default resolution if `size` isn't valid
+    QImage getPage(const int page, const QSize &size = QSize());
     // void releaseLastPageData();
 
 private:
@@ -35,7 +36,8 @@ public:
     bool openComic(const QString &path);
     void closeComic();
     unsigned int numPages();
-    QImage getPage(const int page);
+    // renders the page to fit in `size`, or at the default resolution if `size` isn't valid
+    QImage getPage(const int page, const QSize &size = QSize());
 
 private:
     static int refcount;
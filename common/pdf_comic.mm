@@ -48,7 +48,7 @@ unsigned int MacOSXPDFComic::numPages()
     return (int)CGPDFDocumentGetNumberOfPages((CGPDFDocumentRef)document);
 }
 
-QImage MacOSXPDFComic::getPage(const int pageNum)
+QImage MacOSXPDFComic::getPage(const int pageNum, const QSize &size)
 {
     CGPDFPageRef page = CGPDFDocumentGetPage((CGPDFDocumentRef)document, pageNum + 1);
     // Changed this line for the line above which is a generic line
@@ -59,6 +59,9 @@ QImage MacOSXPDFComic::getPage(const int pageNum)
 
     // NSLog(@"-----%f",pageRect.size.width);
     CGFloat pdfScale = float(width) / pageRect.size.width;
+    if (size.isValid()) {
+        pdfScale = qMin(size.width() / pageRect.size.width, size.height() / pageRect.size.height);
+    }
 
     pageRect.size = CGSizeMake(pageRect.size.width * pdfScale, pageRect.size.height * pdfScale);
     pageRect.origin = CGPointZero;
@@ -10,6 +10,9 @@
 
 #define REMOTE_BROWSE_PERFORMANCE_WORKAROUND "REMOTE_BROWSE_PERFORMANCE_WORKAROUND"
 #define IMPORT_COMIC_INFO_XML_METADATA "IMPORT_COMIC_INFO_XML_METADATA"
+#define NUMBER_OF_LIBRARY_SCAN_WORKERS "NUMBER_OF_LIBRARY_SCAN_WORKERS"
+#define SEARCH_RESULTS_LIMIT "SEARCH_RESULTS_LIMIT"
+#define DEFAULT_SEARCH_RESULTS_LIMIT 5000
 
 #define NUM_DAYS_BETWEEN_VERSION_CHECKS "NUM_DAYS_BETWEEN_VERSION_CHECKS"
 #define LAST_VERSION_CHECK "LAST_VERSION_CHECK"
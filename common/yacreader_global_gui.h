@@ -34,6 +34,7 @@
 #define ENLARGE_IMAGES "ENLARGE_IMAGES"
 #define DO_NOT_TURN_PAGE_ON_SCROLL "DO_NOT_TURN_PAGE_ON_SCROLL"
 #define USE_SINGLE_SCROLL_STEP_TO_TURN_PAGE "USE_SINGLE_SCROLL_STEP_TO_TURN_PAGE"
+#define RENDERED_PAGES_CACHE_SIZE "RENDERED_PAGES_CACHE_SIZE"
 
 #define FLOW_TYPE_GL "FLOW_TYPE_GL"
 #define Y_POSITION "Y_POSITION"
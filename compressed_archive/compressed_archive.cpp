@@ -418,6 +418,20 @@ CompressedArchive::CompressedArchive(const QString &filePath, QObject *parent)
         return tools;
     }
 
+    bool CompressedArchive::isSolid()
+    {
+        if (!valid) {
+            return true;
+        }
+
+        // formats without the property (zip, tar...) are never solid
+        NWindows::NCOM::CPropVariant prop;
+        if (szInterface->archive->GetArchiveProperty(kpidSolid, &prop) == S_OK && prop.vt == VT_BOOL) {
+            return VARIANT_BOOLToBool(prop.boolVal);
+        }
+        return false;
+    }
+
     int CompressedArchive::getNumFiles()
     {
         return files.length();
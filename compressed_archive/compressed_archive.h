@@ -55,6 +55,7 @@ public slots:
     QList<QString> getFileNames();
     bool isValid();
     bool toolsLoaded();
+    bool isSolid();
 
 private:
     SevenZipInterface *szInterface;
@@ -1,18 +1,88 @@
 #include "compressed_archive.h"
 
+#include <QHash>
+#include <QSet>
+#include <QtEndian>
+
+#include <cstring>
+
 #define archive_error(msg) msg << ": [" << archive_errno(a) << "]" << archive_error_string(a)
 
+namespace {
+const quint32 zipLocalHeaderSignature = 0x04034b50;
+const quint32 zipCentralHeaderSignature = 0x02014b50;
+const quint32 zipEndOfCentralDirSignature = 0x06054b50;
+const quint32 zip64EndOfCentralDirSignature = 0x06064b50;
+const quint32 zip64EndOfCentralDirLocatorSignature = 0x07064b50;
+const int zipLocalHeaderSize = 30;
+const int zipCentralHeaderSize = 46;
+const int zipEndOfCentralDirSize = 22;
+const int zip64EndOfCentralDirSize = 56;
+const int zip64EndOfCentralDirLocatorSize = 20;
+const int zipDataDescriptorMaxSize = 24;
+const quint16 zipStored = 0;
+const int tarBlockSize = 512;
+
+quint16 read16(const QByteArray &data, int pos)
+{
+    return qFromLittleEndian<quint16>(reinterpret_cast<const uchar *>(data.constData() + pos));
+}
+
+quint32 read32(const QByteArray &data, int pos)
+{
+    return qFromLittleEndian<quint32>(reinterpret_cast<const uchar *>(data.constData() + pos));
+}
+
+quint64 read64(const QByteArray &data, int pos)
+{
+    return qFromLittleEndian<quint64>(reinterpret_cast<const uchar *>(data.constData() + pos));
+}
+
+// octal, or base-256 (GNU) for values that don't fit, -1 if the field can't be parsed
+qint64 parseTarNumber(const char *field, int length)
+{
+    auto first = static_cast<unsigned char>(field[0]);
+    if (first & 0x80) {
+        if (first == 0xff) {
+            return -1;
+        }
+        qint64 value = first & 0x7f;
+        for (int i = 1; i < length; i++) {
+            value = (value << 8) | static_cast<unsigned char>(field[i]);
+        }
+        return value;
+    }
+
+    qint64 value = 0;
+    int i = 0;
+    while (i < length && field[i] == ' ') {
+        i++;
+    }
+    for (; i < length && field[i] >= '0' && field[i] <= '7'; i++) {
+        value = value * 8 + (field[i] - '0');
+    }
+    return value;
+}
+
+QByteArray tarString(const char *field, int length)
+{
+    return QByteArray(field, qstrnlen(field, length));
+}
+}
+
 CompressedArchive::CompressedArchive(const QString &filePath, QObject *parent)
-    : QObject(parent), a(nullptr), num_entries(0), valid(false), idx(0), filename(filePath)
+    : QObject(parent), a(nullptr), num_entries(0), valid(false), idx(0), filename(filePath), indexFormat(NoIndex)
 {
     if (!open_archive()) {
         qWarning() << "error opening archive:" << filename;
         return;
     }
 
+    QList<QByteArray> pathnames;
     archive_entry *entry;
     int result;
     while ((result = archive_read_next_header(a, &entry)) == ARCHIVE_OK) {
+        pathnames.append(archive_entry_pathname(entry));
         entries.append(archive_entry_pathname(entry));
         archive_read_data_skip(a);
         idx++;
@@ -28,6 +98,8 @@ CompressedArchive::CompressedArchive(const QString &filePath, QObject *parent)
     } else {
         qDebug() << "# of pages in archive:" << num_entries;
         valid = true;
+
+        build_index(pathnames, archive_format(a), archive_filter_code(a, 0));
     }
 
     close_archive();
@@ -146,6 +218,14 @@ QByteArray CompressedArchive::read_entry()
 QByteArray CompressedArchive::getRawDataAtIndex(int index)
 {
     QByteArray bytes;
+    if (indexFormat != NoIndex && index >= 0 && index < indexEntries.size()) {
+        if (read_indexed_entry(index, bytes)) {
+            return bytes;
+        }
+        qWarning() << "error reading indexed entry, falling back to streaming. index:" << index;
+        bytes.clear();
+    }
+
     if (archive_seek(index)) {
         bytes = read_entry();
     } else {
@@ -153,3 +233,335 @@ QByteArray CompressedArchive::getRawDataAtIndex(int index)
     }
     return bytes;
 }
+
+void CompressedArchive::build_index(const QList<QByteArray> &pathnames, int format, int filter)
+{
+    // compressed tars and solid formats (7z, solid rar) can only be read sequentially
+    if (filter != ARCHIVE_FILTER_NONE) {
+        return;
+    }
+
+    IndexFormat candidate = NoIndex;
+    if ((format & ARCHIVE_FORMAT_BASE_MASK) == ARCHIVE_FORMAT_ZIP) {
+        candidate = ZipIndex;
+    } else if ((format & ARCHIVE_FORMAT_BASE_MASK) == ARCHIVE_FORMAT_TAR) {
+        candidate = TarIndex;
+    }
+
+    if (candidate == NoIndex) {
+        return;
+    }
+
+    indexFile.setFileName(filename);
+    if (!indexFile.open(QIODevice::ReadOnly)) {
+        qWarning() << "error opening archive for indexing:" << filename;
+        return;
+    }
+
+    bool built = candidate == ZipIndex ? build_zip_index(pathnames) : build_tar_index(pathnames);
+    if (built) {
+        qDebug() << "random access index built for" << indexEntries.size() << "entries";
+        indexFormat = candidate;
+    } else {
+        qDebug() << "unable to index archive, falling back to streaming:" << filename;
+        indexEntries.clear();
+        indexFile.close();
+    }
+}
+
+// Reads the central directory and maps it to the entries reported by libarchive. Archives
+// libarchive doesn't report 1:1 (duplicated names, names in legacy encodings, encryption)
+// are not indexed.
+bool CompressedArchive::build_zip_index(const QList<QByteArray> &pathnames)
+{
+    qint64 fileSize = indexFile.size();
+    if (fileSize < zipEndOfCentralDirSize) {
+        return false;
+    }
+
+    // the end of central directory record can be followed by a comment of up to 64KB
+    qint64 tailSize = qMin<qint64>(fileSize, zipEndOfCentralDirSize + 0xffff);
+    if (!indexFile.seek(fileSize - tailSize)) {
+        return false;
+    }
+    QByteArray tail = indexFile.read(tailSize);
+
+    int eocd = -1;
+    for (int pos = tail.size() - zipEndOfCentralDirSize; pos >= 0; pos--) {
+        if (read32(tail, pos) == zipEndOfCentralDirSignature) {
+            eocd = pos;
+            break;
+        }
+    }
+    if (eocd < 0) {
+        return false;
+    }
+
+    quint64 count = read16(tail, eocd + 10);
+    quint64 centralDirSize = read32(tail, eocd + 12);
+    quint64 centralDirOffset = read32(tail, eocd + 16);
+
+    if (count == 0xffff || centralDirSize == 0xffffffff || centralDirOffset == 0xffffffff) {
+        int locator = eocd - zip64EndOfCentralDirLocatorSize;
+        if (locator < 0 || read32(tail, locator) != zip64EndOfCentralDirLocatorSignature) {
+            return false;
+        }
+        if (!indexFile.seek(read64(tail, locator + 8))) {
+            return false;
+        }
+        QByteArray zip64 = indexFile.read(zip64EndOfCentralDirSize);
+        if (zip64.size() != zip64EndOfCentralDirSize || read32(zip64, 0) != zip64EndOfCentralDirSignature) {
+            return false;
+        }
+        count = read64(zip64, 32);
+        centralDirSize = read64(zip64, 40);
+        centralDirOffset = read64(zip64, 48);
+    }
+
+    if (centralDirOffset + centralDirSize > quint64(fileSize) || !indexFile.seek(centralDirOffset)) {
+        return false;
+    }
+    QByteArray centralDir = indexFile.read(centralDirSize);
+    if (quint64(centralDir.size()) != centralDirSize) {
+        return false;
+    }
+
+    QHash<QByteArray, IndexEntry> byName;
+    QSet<QByteArray> duplicated;
+    int pos = 0;
+    for (quint64 i = 0; i < count; i++) {
+        if (pos + zipCentralHeaderSize > centralDir.size() || read32(centralDir, pos) != zipCentralHeaderSignature) {
+            return false;
+        }
+
+        quint16 flags = read16(centralDir, pos + 8);
+        quint16 method = read16(centralDir, pos + 10);
+        quint64 compressedSize = read32(centralDir, pos + 20);
+        quint64 size = read32(centralDir, pos + 24);
+        int nameLength = read16(centralDir, pos + 28);
+        int extraLength = read16(centralDir, pos + 30);
+        int commentLength = read16(centralDir, pos + 32);
+        quint64 headerOffset = read32(centralDir, pos + 42);
+
+        int extraPos = pos + zipCentralHeaderSize + nameLength;
+        int extraEnd = extraPos + extraLength;
+        if (extraEnd + commentLength > centralDir.size()) {
+            return false;
+        }
+
+        // encrypted entries
+        if (flags & 0x1) {
+            return false;
+        }
+
+        // zip64 extended information, it only contains the values that overflow in the header
+        for (int field = extraPos; field + 4 <= extraEnd;) {
+            int value = field + 4;
+            int fieldEnd = value + read16(centralDir, field + 2);
+            if (fieldEnd > extraEnd) {
+                break;
+            }
+            if (read16(centralDir, field) == 0x0001) {
+                if (size == 0xffffffff && value + 8 <= fieldEnd) {
+                    size = read64(centralDir, value);
+                    value += 8;
+                }
+                if (compressedSize == 0xffffffff && value + 8 <= fieldEnd) {
+                    compressedSize = read64(centralDir, value);
+                    value += 8;
+                }
+                if (headerOffset == 0xffffffff && value + 8 <= fieldEnd) {
+                    headerOffset = read64(centralDir, value);
+                }
+            }
+            field = fieldEnd;
+        }
+
+        QByteArray name = centralDir.mid(pos + zipCentralHeaderSize, nameLength);
+        if (byName.contains(name)) {
+            duplicated.insert(name);
+        }
+        byName.insert(name, { qint64(headerOffset), qint64(compressedSize), qint64(size), method });
+
+        pos = extraEnd + commentLength;
+    }
+
+    QVector<IndexEntry> index;
+    index.reserve(pathnames.size());
+    for (const auto &pathname : pathnames) {
+        auto entry = byName.constFind(pathname);
+        if (entry == byName.constEnd() || duplicated.contains(pathname)) {
+            return false;
+        }
+        index.append(entry.value());
+    }
+
+    indexEntries = index;
+    return true;
+}
+
+// Walks the tar headers (ustar, GNU long names and pax) and checks that they match the entries
+// reported by libarchive.
+bool CompressedArchive::build_tar_index(const QList<QByteArray> &pathnames)
+{
+    QVector<IndexEntry> index;
+    index.reserve(pathnames.size());
+
+    qint64 fileSize = indexFile.size();
+    qint64 pos = 0;
+    QByteArray longName;
+    QByteArray paxPath;
+    qint64 paxSize = -1;
+
+    while (index.size() < pathnames.size()) {
+        if (pos + tarBlockSize > fileSize || !indexFile.seek(pos)) {
+            return false;
+        }
+        QByteArray header = indexFile.read(tarBlockSize);
+        if (header.size() != tarBlockSize) {
+            return false;
+        }
+
+        const char *h = header.constData();
+        char type = h[156];
+        qint64 size = parseTarNumber(h + 124, 12);
+        if (size < 0) {
+            return false;
+        }
+
+        qint64 dataOffset = pos + tarBlockSize;
+        bool isMetadata = type == 'L' || type == 'K' || type == 'x' || type == 'g';
+
+        if (type == 'L' || type == 'x') {
+            if (!indexFile.seek(dataOffset)) {
+                return false;
+            }
+            QByteArray data = indexFile.read(size);
+            if (data.size() != size) {
+                return false;
+            }
+
+            if (type == 'L') {
+                longName = tarString(data.constData(), data.size());
+            } else {
+                // "<length> <key>=<value>\n" records
+                int record = 0;
+                while (record < data.size()) {
+                    int space = data.indexOf(' ', record);
+                    int length = space > record ? data.mid(record, space - record).toInt() : 0;
+                    if (length <= 0 || record + length > data.size()) {
+                        break;
+                    }
+                    QByteArray keyValue = data.mid(space + 1, record + length - space - 2);
+                    int equals = keyValue.indexOf('=');
+                    QByteArray key = keyValue.left(equals);
+                    if (key == "path") {
+                        paxPath = keyValue.mid(equals + 1);
+                    } else if (key == "size") {
+                        paxSize = keyValue.mid(equals + 1).toLongLong();
+                    } else if (key.startsWith("GNU.sparse")) {
+                        return false;
+                    }
+                    record += length;
+                }
+            }
+        } else if (!isMetadata) {
+            // sparse files, multi-volume archives and other vendor extensions
+            if (type >= 'A' && type <= 'Z') {
+                return false;
+            }
+
+            QByteArray name;
+            if (!paxPath.isEmpty()) {
+                name = paxPath;
+            } else if (!longName.isEmpty()) {
+                name = longName;
+            } else {
+                name = tarString(h, 100);
+                // POSIX ustar prefix, GNU tar uses that space for other fields
+                if (memcmp(h + 257, "ustar", 6) == 0 && h[345] != '\0') {
+                    name = tarString(h + 345, 155) + '/' + name;
+                }
+            }
+
+            if (paxSize >= 0) {
+                size = paxSize;
+            }
+
+            if (name != pathnames.at(index.size()) || dataOffset + size > fileSize) {
+                return false;
+            }
+
+            index.append({ dataOffset, size, size, 0 });
+
+            longName.clear();
+            paxPath.clear();
+            paxSize = -1;
+        }
+
+        pos = dataOffset + (size + tarBlockSize - 1) / tarBlockSize * tarBlockSize;
+    }
+
+    indexEntries = index;
+    return true;
+}
+
+bool CompressedArchive::read_indexed_entry(quint32 index, QByteArray &bytes)
+{
+    const IndexEntry &entry = indexEntries.at(index);
+
+    if (indexFormat == ZipIndex) {
+        return read_zip_entry(entry, bytes);
+    }
+
+    if (!indexFile.seek(entry.headerOffset)) {
+        return false;
+    }
+    bytes = indexFile.read(entry.size);
+    return bytes.size() == entry.size;
+}
+
+bool CompressedArchive::read_zip_entry(const IndexEntry &entry, QByteArray &bytes)
+{
+    if (!indexFile.seek(entry.headerOffset)) {
+        return false;
+    }
+    QByteArray header = indexFile.read(zipLocalHeaderSize);
+    if (header.size() != zipLocalHeaderSize || read32(header, 0) != zipLocalHeaderSignature) {
+        return false;
+    }
+    qint64 dataOffset = entry.headerOffset + zipLocalHeaderSize + read16(header, 26) + read16(header, 28);
+
+    if (entry.method == zipStored) {
+        if (entry.compressedSize != entry.size || !indexFile.seek(dataOffset)) {
+            return false;
+        }
+        bytes = indexFile.read(entry.size);
+        return bytes.size() == entry.size;
+    }
+
+    // compressed entries are decoded by libarchive from the bytes of that entry alone, the data
+    // descriptor is included in case the local header doesn't have the sizes
+    if (!indexFile.seek(entry.headerOffset)) {
+        return false;
+    }
+    QByteArray raw = indexFile.read(dataOffset - entry.headerOffset + entry.compressedSize + zipDataDescriptorMaxSize);
+
+    archive *entryArchive = archive_read_new();
+    archive_read_support_format_zip_streamable(entryArchive);
+
+    bool ok = false;
+    archive_entry *archiveEntry;
+    if (archive_read_open_memory(entryArchive, raw.constData(), raw.size()) == ARCHIVE_OK &&
+        archive_read_next_header(entryArchive, &archiveEntry) == ARCHIVE_OK) {
+        bytes.resize(entry.size);
+        ok = archive_read_data(entryArchive, bytes.data(), entry.size) == entry.size;
+    }
+
+    if (!ok) {
+        qWarning() << "error decoding indexed entry: [" << archive_errno(entryArchive) << "]" << archive_error_string(entryArchive);
+    }
+
+    archive_read_free(entryArchive);
+    return ok;
+}
@@ -5,6 +5,8 @@
 
 #include <QObject>
 #include <QDebug>
+#include <QFile>
+#include <QVector>
 
 extern "C" {
 #include <archive.h>
@@ -26,19 +28,45 @@ public slots:
     QList<QString> getFileNames() { return entries; }
     bool isValid() { return valid; }
     bool toolsLoaded() { return true; }
+    // entries can only be read efficiently in order
+    bool isSolid() { return indexFormat == NoIndex; }
 
 private:
+    // location of an entry inside a non-solid archive, used to read it without streaming
+    // through the entries before it
+    struct IndexEntry {
+        qint64 headerOffset; // zip local file header, tar data
+        qint64 compressedSize;
+        qint64 size;
+        quint16 method; // zip only, 0 == stored
+    };
+
+    enum IndexFormat {
+        NoIndex,
+        ZipIndex,
+        TarIndex
+    };
+
     archive *a;
     QStringList entries;
     int num_entries;
     bool valid;
     quint32 idx;
     QString filename;
+    IndexFormat indexFormat;
+    QVector<IndexEntry> indexEntries;
+    QFile indexFile;
 
     bool open_archive();
     void close_archive();
     bool archive_seek(quint32 index);
     QByteArray read_entry();
+
+    void build_index(const QList<QByteArray> &pathnames, int format, int filter);
+    bool build_zip_index(const QList<QByteArray> &pathnames);
+    bool build_tar_index(const QList<QByteArray> &pathnames);
+    bool read_indexed_entry(quint32 index, QByteArray &bytes);
+    bool read_zip_entry(const IndexEntry &entry, QByteArray &bytes);
 };
 
 #endif // COMPRESSED_ARCHIVE_H
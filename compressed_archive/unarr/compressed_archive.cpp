@@ -7,7 +7,7 @@
 #include <unarr.h>
 
 CompressedArchive::CompressedArchive(const QString &filePath, QObject *parent)
-    : QObject(parent), tools(true), valid(false), numFiles(0), ar(NULL), stream(NULL)
+    : QObject(parent), tools(true), valid(false), solid(true), numFiles(0), ar(NULL), stream(NULL)
 {
     // open file
 #ifdef Q_OS_WIN
@@ -24,11 +24,16 @@ CompressedArchive::CompressedArchive(const QString &filePath, QObject *parent)
     // TODO: build unarr with 7z support and test this!
     if (!ar)
         ar = ar_open_7z_archive(stream);
-    if (!ar)
+    // unarr doesn't tell if rar and 7z archives are solid, tar and zip entries are always independent
+    if (!ar) {
         ar = ar_open_tar_archive(stream);
+        solid = !ar;
+    }
     // zip detection is costly, so it comes last...
-    if (!ar)
+    if (!ar) {
         ar = ar_open_zip_archive(stream, false);
+        solid = !ar;
+    }
     if (!ar) {
         return;
     }
@@ -69,6 +74,11 @@ bool CompressedArchive::isValid()
     return valid;
 }
 
+bool CompressedArchive::isSolid()
+{
+    return solid;
+}
+
 bool CompressedArchive::toolsLoaded()
 {
     // for backwards compatibilty
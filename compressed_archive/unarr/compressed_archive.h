@@ -23,10 +23,12 @@ public slots:
     QList<QString> getFileNames();
     bool isValid();
     bool toolsLoaded();
+    bool isSolid();
 
 private:
     bool tools;
     bool valid;
+    bool solid;
     QList<QString> fileNames;
     int numFiles;
     ar_archive *ar;
@@ -0,0 +1,268 @@
+#include "compressed_archive.h"
+
+#include <QDataStream>
+#include <QDir>
+#include <QElapsedTimer>
+#include <QFile>
+#include <QObject>
+#include <QTemporaryDir>
+#include <QTest>
+
+#include <algorithm>
+#include <random>
+
+namespace {
+
+struct Entry {
+    QString name;
+    QByteArray data;
+};
+
+// pages of different sizes, some of them compress well and some don't
+QList<Entry> testEntries()
+{
+    QList<Entry> entries;
+    std::mt19937 generator(42);
+    std::uniform_int_distribution<int> byte(0, 255);
+
+    for (int i = 0; i < 12; i++) {
+        QByteArray data;
+        int size = 700 + i * 5111;
+        data.reserve(size);
+        for (int j = 0; j < size; j++) {
+            data.append(i % 2 == 0 ? static_cast<char>(byte(generator)) : static_cast<char>('a' + (j / 64 + i) % 26));
+        }
+        entries.append({ QString("%1/page%2.jpg").arg(i < 6 ? "first" : "second").arg(i, 2, 10, QChar('0')), data });
+    }
+
+    return entries;
+}
+
+quint32 crc32(const QByteArray &data)
+{
+    quint32 crc = 0xFFFFFFFF;
+    for (char c : data) {
+        crc ^= static_cast<unsigned char>(c);
+        for (int i = 0; i < 8; i++) {
+            crc = (crc >> 1) ^ (0xEDB88320 & (0 - (crc & 1)));
+        }
+    }
+    return ~crc;
+}
+
+QByteArray tarArchive(const QList<Entry> &entries)
+{
+    QByteArray archive;
+
+    for (const auto &entry : entries) {
+        QByteArray header(512, '\0');
+        auto write = [&header](int offset, const QByteArray &value) {
+            header.replace(offset, value.size(), value);
+        };
+
+        write(0, entry.name.toUtf8());
+        write(100, "0000644");
+        write(108, "0000000");
+        write(116, "0000000");
+        write(124, QByteArray::number(entry.data.size(), 8).rightJustified(11, '0'));
+        write(136, QByteArray::number(1600000000, 8).rightJustified(11, '0'));
+        write(148, QByteArray(8, ' '));
+        header[156] = '0';
+        write(257, QByteArray("ustar\0", 6));
+        write(263, "00");
+
+        unsigned int checksum = 0;
+        for (char c : header) {
+            checksum += static_cast<unsigned char>(c);
+        }
+        write(148, QByteArray::number(checksum, 8).rightJustified(6, '0') + QByteArray("\0 ", 2));
+
+        archive.append(header);
+        archive.append(entry.data);
+        archive.append(QByteArray((512 - entry.data.size() % 512) % 512, '\0'));
+    }
+
+    archive.append(QByteArray(1024, '\0'));
+    return archive;
+}
+
+QByteArray zipArchive(const QList<Entry> &entries, bool compressed)
+{
+    QByteArray archive;
+    QByteArray centralDirectory;
+    QDataStream out(&archive, QIODevice::WriteOnly);
+    QDataStream directory(&centralDirectory, QIODevice::WriteOnly);
+    out.setByteOrder(QDataStream::LittleEndian);
+    directory.setByteOrder(QDataStream::LittleEndian);
+
+    const quint16 method = compressed ? 8 : 0;
+    const quint16 time = 0;
+    const quint16 date = 0x21; // 1980-01-01
+
+    for (const auto &entry : entries) {
+        QByteArray name = entry.name.toUtf8();
+        QByteArray data = entry.data;
+        if (compressed) {
+            // qCompress writes the size and a zlib stream, zip entries only have the raw deflate data
+            data = qCompress(entry.data, 9);
+            data = data.mid(6, data.size() - 10);
+        }
+        quint32 crc = crc32(entry.data);
+        quint32 offset = archive.size();
+
+        out << quint32(0x04034b50) << quint16(20) << quint16(0) << method << time << date << crc
+            << quint32(data.size()) << quint32(entry.data.size()) << quint16(name.size()) << quint16(0);
+        out.writeRawData(name.constData(), name.size());
+        out.writeRawData(data.constData(), data.size());
+
+        directory << quint32(0x02014b50) << quint16(20) << quint16(20) << quint16(0) << method << time << date << crc
+                  << quint32(data.size()) << quint32(entry.data.size()) << quint16(name.size()) << quint16(0) << quint16(0)
+                  << quint16(0) << quint16(0) << quint32(0) << offset;
+        directory.writeRawData(name.constData(), name.size());
+    }
+
+    quint32 directoryOffset = archive.size();
+    out.writeRawData(centralDirectory.constData(), centralDirectory.size());
+    out << quint32(0x06054b50) << quint16(0) << quint16(0) << quint16(entries.size()) << quint16(entries.size())
+        << quint32(centralDirectory.size()) << directoryOffset << quint16(0);
+
+    return archive;
+}
+
+}
+
+class CompressedArchiveTest : public QObject
+{
+    Q_OBJECT
+private slots:
+    void init();
+
+    void outOfOrderEntries_data();
+    void outOfOrderEntries();
+    void protosTestSuite();
+
+private:
+    QTemporaryDir dir;
+};
+
+void CompressedArchiveTest::init()
+{
+    QVERIFY(dir.isValid());
+}
+
+void CompressedArchiveTest::outOfOrderEntries_data()
+{
+    QTest::addColumn<QString>("fileName");
+    QTest::addColumn<QByteArray>("data");
+
+    auto entries = testEntries();
+    QTest::newRow("tar") << "comic.cbt" << tarArchive(entries);
+    QTest::newRow("stored zip") << "stored.cbz" << zipArchive(entries, false);
+    QTest::newRow("deflated zip") << "deflated.cbz" << zipArchive(entries, true);
+}
+
+// comics are read starting at the last page read, going back and jumping around, every entry must match
+// whatever was read before it
+void CompressedArchiveTest::outOfOrderEntries()
+{
+    QFETCH(QString, fileName);
+    QFETCH(QByteArray, data);
+
+    QString path = dir.filePath(fileName);
+    QFile file(path);
+    QVERIFY(file.open(QFile::WriteOnly));
+    file.write(data);
+    file.close();
+
+    CompressedArchive archive(path);
+    if (!archive.toolsLoaded()) {
+        QSKIP("The decompression backend couldn't be loaded");
+    }
+    QVERIFY(archive.isValid());
+#ifdef use_libarchive
+    // read through the random-access entry index
+    QVERIFY(!archive.isSolid());
+#endif
+
+    QHash<QString, QByteArray> expected;
+    for (const auto &entry : testEntries()) {
+        expected.insert(entry.name, entry.data);
+    }
+
+    auto names = archive.getFileNames();
+    QCOMPARE(archive.getNumFiles(), expected.size());
+    QCOMPARE(names.size(), expected.size());
+
+    QList<int> order;
+    for (int i = names.size() - 1; i >= 0; i--) {
+        order.append(i);
+    }
+    std::vector<int> shuffled(order.cbegin(), order.cend());
+    std::shuffle(shuffled.begin(), shuffled.end(), std::mt19937(7));
+    for (int index : shuffled) {
+        order.append(index);
+    }
+    // the same entry twice in a row, and the first one after the last one
+    order << 5 << 5 << names.size() - 1 << 0;
+
+    for (int index : order) {
+        QVERIFY2(expected.contains(names.at(index)), qPrintable(names.at(index)));
+        QCOMPARE(archive.getRawDataAtIndex(index), expected.value(names.at(index)));
+    }
+}
+
+// This test uses PROTOS Genome Test Suite c10-archive [0] for testing the CompressedArchive wrapper files support
+// It tests the following formats: RAR, ZIP, TAR
+// Arter downloading c10-archive-r1.iso, open it and full extract RAR_TAR.BZ2, ZIP_TAR.BZ2, TAR_TAR.BZ2 files into a folder
+// and set the PROTOS_C10_ARCHIVE environment variable to the path of that folder. The archives are malformed,
+// the test only checks that opening them doesn't crash.
+//
+//  [0] https://www.ee.oulu.fi/research/ouspg/PROTOS_Test-Suite_c10-archive#Download
+//
+void CompressedArchiveTest::protosTestSuite()
+{
+    QString s = qEnvironmentVariable("PROTOS_C10_ARCHIVE");
+    if (s.isEmpty()) {
+        QSKIP("PROTOS_C10_ARCHIVE is not set");
+    }
+
+    QStringList supportedFormats;
+    supportedFormats << "rar"
+                     << "zip"
+                     << "tar";
+
+    QElapsedTimer timer;
+    timer.start();
+
+    foreach (QString format, supportedFormats) {
+        QDir rootDir(s);
+        if (!rootDir.cd(format)) {
+            qWarning() << "Folder for format" << format << "not found";
+            continue;
+        }
+        rootDir.setFilter(QDir::Files | QDir::NoDotAndDotDot);
+
+        QFileInfoList files = rootDir.entryInfoList();
+        quint32 errors = 0;
+        quint64 init = timer.elapsed();
+
+        foreach (QFileInfo fileInfo, files) {
+            CompressedArchive archive(fileInfo.filePath());
+            if (!archive.isValid())
+                errors++;
+            else {
+                QList<QString> filenames = archive.getFileNames();
+                if (!filenames.isEmpty()) {
+                    archive.getRawDataAtIndex(0);
+                }
+            }
+        }
+        quint64 end = timer.elapsed();
+
+        qInfo() << "Format" << format << "- total files:" << files.size() << "errors:" << errors << "elapsed time:" << (end - init) / 1000 << "s";
+    }
+}
+
+QTEST_GUILESS_MAIN(CompressedArchiveTest)
+
+#include "compressed_archive_test.moc"
@@ -1,10 +1,7 @@
-TEMPLATE = app
-CONFIG += console
+include(../qt_test.pri)
 
 SOURCES += \
-    main.cpp \
-
-QT += core
+    compressed_archive_test.cpp
 
 win32 {
     LIBS +=  -loleaut32 -lole32
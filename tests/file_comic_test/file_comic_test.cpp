@@ -0,0 +1,212 @@
+#include "comic.h"
+
+#include <QDataStream>
+#include <QFile>
+#include <QObject>
+#include <QSignalSpy>
+#include <QTemporaryDir>
+#include <QTest>
+
+#include <random>
+
+namespace {
+
+struct Entry {
+    QString name;
+    QByteArray data;
+};
+
+// the pages aren't decoded, any data is fine. They are stored out of order so the sorted pages don't match the archive order
+QList<Entry> testEntries()
+{
+    QList<Entry> entries;
+    std::mt19937 generator(42);
+    std::uniform_int_distribution<int> byte(0, 255);
+
+    for (int i = 0; i < 24; i++) {
+        int page = (i * 7) % 24;
+        QByteArray data;
+        int size = 500 + page * 3001;
+        data.reserve(size);
+        for (int j = 0; j < size; j++) {
+            data.append(page % 2 == 0 ? static_cast<char>(byte(generator)) : static_cast<char>('a' + (j / 64 + page) % 26));
+        }
+        entries.append({ QString("page%1.jpg").arg(page + 1, 2, 10, QChar('0')), data });
+    }
+
+    return entries;
+}
+
+quint32 crc32(const QByteArray &data)
+{
+    quint32 crc = 0xFFFFFFFF;
+    for (char c : data) {
+        crc ^= static_cast<unsigned char>(c);
+        for (int i = 0; i < 8; i++) {
+            crc = (crc >> 1) ^ (0xEDB88320 & (0 - (crc & 1)));
+        }
+    }
+    return ~crc;
+}
+
+QByteArray tarArchive(const QList<Entry> &entries)
+{
+    QByteArray archive;
+
+    for (const auto &entry : entries) {
+        QByteArray header(512, '\0');
+        auto write = [&header](int offset, const QByteArray &value) {
+            header.replace(offset, value.size(), value);
+        };
+
+        write(0, entry.name.toUtf8());
+        write(100, "0000644");
+        write(108, "0000000");
+        write(116, "0000000");
+        write(124, QByteArray::number(entry.data.size(), 8).rightJustified(11, '0'));
+        write(136, QByteArray::number(1600000000, 8).rightJustified(11, '0'));
+        write(148, QByteArray(8, ' '));
+        header[156] = '0';
+        write(257, QByteArray("ustar\0", 6));
+        write(263, "00");
+
+        unsigned int checksum = 0;
+        for (char c : header) {
+            checksum += static_cast<unsigned char>(c);
+        }
+        write(148, QByteArray::number(checksum, 8).rightJustified(6, '0') + QByteArray("\0 ", 2));
+
+        archive.append(header);
+        archive.append(entry.data);
+        archive.append(QByteArray((512 - entry.data.size() % 512) % 512, '\0'));
+    }
+
+    archive.append(QByteArray(1024, '\0'));
+    return archive;
+}
+
+QByteArray zipArchive(const QList<Entry> &entries)
+{
+    QByteArray archive;
+    QByteArray centralDirectory;
+    QDataStream out(&archive, QIODevice::WriteOnly);
+    QDataStream directory(&centralDirectory, QIODevice::WriteOnly);
+    out.setByteOrder(QDataStream::LittleEndian);
+    directory.setByteOrder(QDataStream::LittleEndian);
+
+    const quint16 method = 8;
+    const quint16 time = 0;
+    const quint16 date = 0x21; // 1980-01-01
+
+    for (const auto &entry : entries) {
+        QByteArray name = entry.name.toUtf8();
+        // qCompress writes the size and a zlib stream, zip entries only have the raw deflate data
+        QByteArray data = qCompress(entry.data, 9);
+        data = data.mid(6, data.size() - 10);
+        quint32 crc = crc32(entry.data);
+        quint32 offset = archive.size();
+
+        out << quint32(0x04034b50) << quint16(20) << quint16(0) << method << time << date << crc
+            << quint32(data.size()) << quint32(entry.data.size()) << quint16(name.size()) << quint16(0);
+        out.writeRawData(name.constData(), name.size());
+        out.writeRawData(data.constData(), data.size());
+
+        directory << quint32(0x02014b50) << quint16(20) << quint16(20) << quint16(0) << method << time << date << crc
+                  << quint32(data.size()) << quint32(entry.data.size()) << quint16(name.size()) << quint16(0) << quint16(0)
+                  << quint16(0) << quint16(0) << quint32(0) << offset;
+        directory.writeRawData(name.constData(), name.size());
+    }
+
+    quint32 directoryOffset = archive.size();
+    out.writeRawData(centralDirectory.constData(), centralDirectory.size());
+    out << quint32(0x06054b50) << quint16(0) << quint16(0) << quint16(entries.size()) << quint16(entries.size())
+        << quint32(centralDirectory.size()) << directoryOffset << quint16(0);
+
+    return archive;
+}
+
+}
+
+class FileComicTest : public QObject
+{
+    Q_OBJECT
+private slots:
+    void init();
+
+    void parallelExtractionMatchesSerialExtraction_data();
+    void parallelExtractionMatchesSerialExtraction();
+
+private:
+    QTemporaryDir dir;
+    // the pages of the comic at `path`, loaded in the calling thread
+    QList<QByteArray> pages(const QString &path, int firstPage, int workers);
+};
+
+void FileComicTest::init()
+{
+    QVERIFY(dir.isValid());
+}
+
+QList<QByteArray> FileComicTest::pages(const QString &path, int firstPage, int workers)
+{
+    FileComic comic(path, firstPage);
+    comic.setExtractionWorkers(workers);
+
+    QSignalSpy loaded(&comic, &Comic::imagesLoaded);
+    comic.process();
+
+    QList<QByteArray> pages;
+    if (loaded.count() != 1 || comic.hasBeenAnErrorOpening()) {
+        return pages;
+    }
+    for (unsigned int i = 0; i < comic.numPages(); i++) {
+        pages.append(comic.getRawPage(i));
+    }
+    return pages;
+}
+
+void FileComicTest::parallelExtractionMatchesSerialExtraction_data()
+{
+    QTest::addColumn<QString>("fileName");
+    QTest::addColumn<QByteArray>("data");
+    QTest::addColumn<int>("firstPage");
+
+    auto entries = testEntries();
+    QTest::newRow("tar") << "comic.cbt" << tarArchive(entries) << 0;
+    QTest::newRow("tar opened in the middle") << "comic.cbt" << tarArchive(entries) << 13;
+    QTest::newRow("zip") << "comic.cbz" << zipArchive(entries) << 0;
+    QTest::newRow("zip opened at the last page") << "comic.cbz" << zipArchive(entries) << 23;
+}
+
+void FileComicTest::parallelExtractionMatchesSerialExtraction()
+{
+    QFETCH(QString, fileName);
+    QFETCH(QByteArray, data);
+    QFETCH(int, firstPage);
+
+    QString path = dir.filePath(fileName);
+    QFile file(path);
+    QVERIFY(file.open(QFile::WriteOnly | QFile::Truncate));
+    file.write(data);
+    file.close();
+
+    QMap<QString, QByteArray> expected;
+    for (const auto &entry : testEntries()) {
+        expected.insert(entry.name, entry.data);
+    }
+
+    auto serial = pages(path, firstPage, 1);
+    if (serial.isEmpty()) {
+        QSKIP("The decompression backend couldn't open the comic");
+    }
+    // the names are zero padded, the map keeps the reading order
+    QCOMPARE(serial, expected.values());
+
+    for (int workers : { 2, 4 }) {
+        QCOMPARE(pages(path, firstPage, workers), serial);
+    }
+}
+
+QTEST_GUILESS_MAIN(FileComicTest)
+
+#include "file_comic_test.moc"
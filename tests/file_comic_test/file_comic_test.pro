@@ -0,0 +1,47 @@
+include(../qt_test.pri)
+
+QT += gui
+greaterThan(QT_MAJOR_VERSION, 5): QT += core5compat
+
+# the fixture comics are tar and zip files
+DEFINES += NO_PDF
+
+PATH_TO_common = ../../common
+
+INCLUDEPATH += $$PATH_TO_common
+
+HEADERS += \
+    $${PATH_TO_common}/comic.h \
+    $${PATH_TO_common}/comic_db.h \
+    $${PATH_TO_common}/cover_store.h \
+    $${PATH_TO_common}/library_item.h \
+    $${PATH_TO_common}/bookmarks.h \
+    $${PATH_TO_common}/qnaturalsorting.h \
+    $${PATH_TO_common}/concurrent_queue.h \
+    $${PATH_TO_common}/yacreader_global.h
+
+SOURCES += \
+    $${PATH_TO_common}/comic.cpp \
+    $${PATH_TO_common}/comic_db.cpp \
+    $${PATH_TO_common}/cover_store.cpp \
+    $${PATH_TO_common}/library_item.cpp \
+    $${PATH_TO_common}/bookmarks.cpp \
+    $${PATH_TO_common}/qnaturalsorting.cpp \
+    $${PATH_TO_common}/concurrent_queue.cpp \
+    $${PATH_TO_common}/yacreader_global.cpp \
+    file_comic_test.cpp
+
+unix:!macx {
+  DEFINES += "LIBDIR=\\\"$$LIBDIR\\\""
+}
+
+CONFIG(7zip) {
+include(../../compressed_archive/wrapper.pri)
+} else:CONFIG(unarr) {
+include(../../compressed_archive/unarr/unarr-wrapper.pri)
+} else:CONFIG(libarchive) {
+include(../../compressed_archive/libarchive/libarchive-wrapper.pri)
+} else {
+  error(No compression backend specified. Did you mess with the build system?)
+}
+include(../../third_party/QsLog/QsLog.pri)
@@ -0,0 +1,222 @@
+#include "library_creator.h"
+#include "yacreader_global.h"
+
+#include <QBuffer>
+#include <QColor>
+#include <QDir>
+#include <QFile>
+#include <QImage>
+#include <QObject>
+#include <QSettings>
+#include <QSqlDatabase>
+#include <QSqlQuery>
+#include <QSqlRecord>
+#include <QTemporaryDir>
+#include <QTest>
+
+namespace {
+
+QByteArray tarHeader(const QString &name, qint64 size)
+{
+    QByteArray header(512, '\0');
+
+    auto write = [&header](int offset, const QByteArray &value) {
+        header.replace(offset, value.size(), value);
+    };
+
+    write(0, name.toUtf8().left(99));
+    write(100, "0000644");
+    write(108, "0000000");
+    write(116, "0000000");
+    write(124, QByteArray::number(size, 8).rightJustified(11, '0'));
+    write(136, QByteArray::number(1600000000, 8).rightJustified(11, '0'));
+    write(148, QByteArray(8, ' '));
+    header[156] = '0';
+    write(257, QByteArray("ustar\0", 6));
+    write(263, "00");
+
+    unsigned int checksum = 0;
+    for (char c : header) {
+        checksum += static_cast<unsigned char>(c);
+    }
+    write(148, QByteArray::number(checksum, 8).rightJustified(6, '0') + QByteArray("\0 ", 2));
+
+    return header;
+}
+
+// writes a tar comic, every backend can read them and they are easy to build. Comics with different ids have different hashes
+void writeComic(const QString &path, int id, int numPages, const QByteArray &comicInfo = QByteArray())
+{
+    QByteArray data;
+
+    auto append = [&data](const QString &name, const QByteArray &content) {
+        data.append(tarHeader(name, content.size()));
+        data.append(content);
+        data.append(QByteArray((512 - content.size() % 512) % 512, '\0'));
+    };
+
+    for (int i = 0; i < numPages; i++) {
+        // a different size for every page, so the cover size tells which page was used
+        QImage page(200 + 10 * i, 300 + id, QImage::Format_RGB32);
+        page.fill(QColor::fromHsv((37 * id + 59 * i) % 360, 200, 200));
+
+        QByteArray encoded;
+        QBuffer buffer(&encoded);
+        buffer.open(QIODevice::WriteOnly);
+        page.save(&buffer, "PNG");
+
+        append(QString("page%1.png").arg(i + 1, 2, 10, QChar('0')), encoded);
+    }
+
+    if (!comicInfo.isEmpty()) {
+        append("ComicInfo.xml", comicInfo);
+    }
+
+    data.append(QByteArray(1024, '\0'));
+
+    QFile file(path);
+    file.open(QFile::WriteOnly);
+    file.write(data);
+}
+
+QByteArray comicInfo(int number)
+{
+    return QString("<?xml version=\"1.0\"?>\n"
+                   "<ComicInfo>\n"
+                   "  <Title>Issue %1</Title>\n"
+                   "  <Series>Test series</Series>\n"
+                   "  <Number>%1</Number>\n"
+                   "  <Writer>Writer %1</Writer>\n"
+                   "</ComicInfo>\n")
+            .arg(number)
+            .toUtf8();
+}
+
+QStringList table(const QString &libraryPath, const QString &tableName)
+{
+    QStringList rows;
+
+    const QString connectionName = "library_creator_test_" + tableName;
+    {
+        auto db = QSqlDatabase::addDatabase("QSQLITE", connectionName);
+        db.setDatabaseName(libraryPath + "/library.ydb");
+        db.open();
+
+        QSqlQuery query(db);
+        query.exec(QString("SELECT * FROM %1 ORDER BY id").arg(tableName));
+        while (query.next()) {
+            QStringList row;
+            for (int i = 0; i < query.record().count(); i++) {
+                row.append(query.value(i).toString());
+            }
+            rows.append(row.join(","));
+        }
+        db.close();
+    }
+    QSqlDatabase::removeDatabase(connectionName);
+
+    return rows;
+}
+
+}
+
+class LibraryCreatorTest : public QObject
+{
+    Q_OBJECT
+private slots:
+    void init();
+
+    void parallelScanMatchesSerialScan_data();
+    void parallelScanMatchesSerialScan();
+
+private:
+    QTemporaryDir dir;
+    QString source() const { return dir.filePath("comics"); }
+    void scan(const QString &libraryPath, int workers, bool update);
+    void compareLibraries(const QString &serial, const QString &parallel);
+};
+
+void LibraryCreatorTest::init()
+{
+    QVERIFY(dir.isValid());
+
+    QDir(dir.path()).removeRecursively();
+    QDir().mkpath(source() + "/Series A/Volume 1");
+    QDir().mkpath(source() + "/Series B");
+    QDir().mkpath(source() + "/Empty");
+
+    for (int i = 1; i <= 6; i++) {
+        writeComic(QString("%1/Series A/Volume 1/issue %2.cbt").arg(source()).arg(i), i, 2 + i % 3, comicInfo(i));
+    }
+    for (int i = 1; i <= 6; i++) {
+        writeComic(QString("%1/Series B/issue %2.cbt").arg(source()).arg(i), 10 + i, 3);
+    }
+    writeComic(source() + "/one shot.cbt", 20, 4, comicInfo(100));
+    // not a comic, it is skipped by both scans
+    QFile broken(source() + "/Series B/broken.cbt");
+    broken.open(QFile::WriteOnly);
+    broken.write("not a comic");
+}
+
+void LibraryCreatorTest::scan(const QString &libraryPath, int workers, bool update)
+{
+    QSettings settings(dir.filePath(QString("settings_%1.ini").arg(workers)), QSettings::IniFormat);
+    settings.setValue(NUMBER_OF_LIBRARY_SCAN_WORKERS, workers);
+    settings.setValue(IMPORT_COMIC_INFO_XML_METADATA, true);
+
+    LibraryCreator creator(&settings);
+    if (update) {
+        creator.updateLibrary(source(), libraryPath);
+    } else {
+        creator.createLibrary(source(), libraryPath);
+    }
+    creator.start();
+    creator.wait();
+}
+
+void LibraryCreatorTest::compareLibraries(const QString &serial, const QString &parallel)
+{
+    for (const auto &tableName : { "folder", "comic", "comic_info" }) {
+        auto serialRows = table(serial, tableName);
+        auto parallelRows = table(parallel, tableName);
+        QVERIFY2(!serialRows.isEmpty(), tableName);
+        QCOMPARE(parallelRows, serialRows);
+    }
+}
+
+void LibraryCreatorTest::parallelScanMatchesSerialScan_data()
+{
+    QTest::addColumn<int>("workers");
+
+    QTest::newRow("2 workers") << 2;
+    QTest::newRow("8 workers") << 8;
+}
+
+void LibraryCreatorTest::parallelScanMatchesSerialScan()
+{
+    QFETCH(int, workers);
+
+    const QString serial = dir.filePath("serial/.yacreaderlibrary");
+    const QString parallel = dir.filePath("parallel/.yacreaderlibrary");
+
+    scan(serial, 1, false);
+    scan(parallel, workers, false);
+    compareLibraries(serial, parallel);
+
+    // the updates add, remove and keep comics
+    QFile::remove(source() + "/Series B/issue 2.cbt");
+    QDir(source() + "/Series A/Volume 1").removeRecursively();
+    QDir().mkpath(source() + "/Series A/Volume 2");
+    for (int i = 7; i <= 10; i++) {
+        writeComic(QString("%1/Series A/Volume 2/issue %2.cbt").arg(source()).arg(i), i, 5, comicInfo(i));
+    }
+    writeComic(source() + "/Empty/found later.cbt", 21, 2);
+
+    scan(serial, 1, true);
+    scan(parallel, workers, true);
+    compareLibraries(serial, parallel);
+}
+
+QTEST_GUILESS_MAIN(LibraryCreatorTest)
+
+#include "library_creator_test.moc"
@@ -0,0 +1,71 @@
+include(../qt_test.pri)
+
+QT += gui sql
+greaterThan(QT_MAJOR_VERSION, 5): QT += core5compat
+
+# the fixture comics are tar files, the scan is the same for every format
+DEFINES += YACREADER_LIBRARY NO_PDF
+
+PATH_TO_common = ../../common
+PATH_TO_YACReaderLibrary = ../../YACReaderLibrary
+
+INCLUDEPATH += \
+    $$PATH_TO_common \
+    $$PATH_TO_YACReaderLibrary \
+    $${PATH_TO_YACReaderLibrary}/db
+
+HEADERS += \
+    $${PATH_TO_YACReaderLibrary}/library_creator.h \
+    $${PATH_TO_YACReaderLibrary}/db_helper.h \
+    $${PATH_TO_YACReaderLibrary}/db/data_base_management.h \
+    $${PATH_TO_YACReaderLibrary}/db/db_connection_pool.h \
+    $${PATH_TO_YACReaderLibrary}/db/remote_progress_sync.h \
+    $${PATH_TO_YACReaderLibrary}/db/reading_list.h \
+    $${PATH_TO_YACReaderLibrary}/initial_comic_info_extractor.h \
+    $${PATH_TO_YACReaderLibrary}/xml_info_parser.h \
+    $${PATH_TO_YACReaderLibrary}/yacreader_libraries.h \
+    $${PATH_TO_common}/comic_db.h \
+    $${PATH_TO_common}/cover_store.h \
+    $${PATH_TO_common}/folder.h \
+    $${PATH_TO_common}/library_item.h \
+    $${PATH_TO_common}/comic.h \
+    $${PATH_TO_common}/bookmarks.h \
+    $${PATH_TO_common}/qnaturalsorting.h \
+    $${PATH_TO_common}/concurrent_queue.h \
+    $${PATH_TO_common}/yacreader_global.h
+
+SOURCES += \
+    $${PATH_TO_YACReaderLibrary}/library_creator.cpp \
+    $${PATH_TO_YACReaderLibrary}/db_helper.cpp \
+    $${PATH_TO_YACReaderLibrary}/db/data_base_management.cpp \
+    $${PATH_TO_YACReaderLibrary}/db/db_connection_pool.cpp \
+    $${PATH_TO_YACReaderLibrary}/db/remote_progress_sync.cpp \
+    $${PATH_TO_YACReaderLibrary}/db/reading_list.cpp \
+    $${PATH_TO_YACReaderLibrary}/initial_comic_info_extractor.cpp \
+    $${PATH_TO_YACReaderLibrary}/xml_info_parser.cpp \
+    $${PATH_TO_YACReaderLibrary}/yacreader_libraries.cpp \
+    $${PATH_TO_common}/comic_db.cpp \
+    $${PATH_TO_common}/cover_store.cpp \
+    $${PATH_TO_common}/folder.cpp \
+    $${PATH_TO_common}/library_item.cpp \
+    $${PATH_TO_common}/comic.cpp \
+    $${PATH_TO_common}/bookmarks.cpp \
+    $${PATH_TO_common}/qnaturalsorting.cpp \
+    $${PATH_TO_common}/concurrent_queue.cpp \
+    $${PATH_TO_common}/yacreader_global.cpp \
+    library_creator_test.cpp
+
+unix:!macx {
+  DEFINES += "LIBDIR=\\\"$$LIBDIR\\\""
+}
+
+CONFIG(7zip) {
+include(../../compressed_archive/wrapper.pri)
+} else:CONFIG(unarr) {
+include(../../compressed_archive/unarr/unarr-wrapper.pri)
+} else:CONFIG(libarchive) {
+include(../../compressed_archive/libarchive/libarchive-wrapper.pri)
+} else {
+  error(No compression backend specified. Did you mess with the build system?)
+}
+include(../../third_party/QsLog/QsLog.pri)
@@ -0,0 +1,207 @@
+#include "image_kernels.h"
+
+#include <QColor>
+#include <QImage>
+#include <QList>
+#include <QObject>
+#include <QTest>
+
+#include <algorithm>
+#include <random>
+
+namespace {
+// The per pixel implementations that were used by MeanNoiseReductionFilter and
+// MedianNoiseReductionFilter, kept as the reference for the results and the timings.
+QImage referenceMean(const QImage &image, int filterSize)
+{
+    int width = image.width();
+    int height = image.height();
+    QImage result = image.copy();
+    int area = filterSize * filterSize;
+    int bound = filterSize / 2;
+    QRgb pix;
+    int r, g, b;
+    for (int j = bound; j < height - bound; j++) {
+        for (int i = bound; i < width - bound; i++) {
+            r = g = b = 0;
+            for (int y = j - bound; y <= j + bound; y++) {
+                for (int x = i - bound; x <= i + bound; x++) {
+                    pix = image.pixel(x, y);
+                    r += qRed(pix);
+                    g += qGreen(pix);
+                    b += qBlue(pix);
+                }
+            }
+            result.setPixel(i, j, QColor(r / area, g / area, b / area).rgb());
+        }
+    }
+    return result;
+}
+
+QImage referenceMedian(const QImage &image, int filterSize)
+{
+    int width = image.width();
+    int height = image.height();
+    QImage result = image.copy();
+    int bound = filterSize / 2;
+    int median = (filterSize * filterSize) / 2;
+    QRgb pix;
+    QList<int> redChannel;
+    QList<int> greenChannel;
+    QList<int> blueChannel;
+    for (int j = bound; j < height - bound; j++) {
+        for (int i = bound; i < width - bound; i++) {
+            redChannel.clear();
+            greenChannel.clear();
+            blueChannel.clear();
+            for (int y = j - bound; y <= j + bound; y++) {
+                for (int x = i - bound; x <= i + bound; x++) {
+                    pix = image.pixel(x, y);
+                    redChannel.push_back(qRed(pix));
+                    greenChannel.push_back(qGreen(pix));
+                    blueChannel.push_back(qBlue(pix));
+                }
+            }
+
+            std::sort(redChannel.begin(), redChannel.end());
+            std::sort(greenChannel.begin(), greenChannel.end());
+            std::sort(blueChannel.begin(), blueChannel.end());
+            result.setPixel(i, j, QColor(redChannel.at(median), greenChannel.at(median), blueChannel.at(median)).rgb());
+        }
+    }
+    return result;
+}
+
+QImage noise(int width, int height)
+{
+    QImage image(width, height, QImage::Format_RGB32);
+    std::mt19937 generator(width * height);
+    std::uniform_int_distribution<int> distribution(0, 255);
+    for (int y = 0; y < height; y++) {
+        auto line = reinterpret_cast<QRgb *>(image.scanLine(y));
+        for (int x = 0; x < width; x++) {
+            line[x] = qRgb(distribution(generator), distribution(generator), distribution(generator));
+        }
+    }
+    return image;
+}
+}
+
+class NoiseReductionBenchmark : public QObject
+{
+    Q_OBJECT
+private slots:
+    void mean_data();
+    void mean();
+    void median_data();
+    void median();
+    void rowBands_data();
+    void rowBands();
+
+    void benchmark_data();
+    void benchmark();
+};
+
+void NoiseReductionBenchmark::mean_data()
+{
+    QTest::addColumn<int>("width");
+    QTest::addColumn<int>("height");
+    QTest::addColumn<int>("filterSize");
+
+    QTest::newRow("3x3") << 211 << 157 << 3;
+    QTest::newRow("5x5") << 211 << 157 << 5;
+    QTest::newRow("smaller than the filter") << 4 << 4 << 5;
+    QTest::newRow("one row") << 64 << 5 << 5;
+}
+
+void NoiseReductionBenchmark::mean()
+{
+    QFETCH(int, width);
+    QFETCH(int, height);
+    QFETCH(int, filterSize);
+
+    const QImage image = noise(width, height);
+    QCOMPARE(YACReader::meanFilter(image, filterSize), referenceMean(image, filterSize));
+}
+
+void NoiseReductionBenchmark::median_data()
+{
+    mean_data();
+}
+
+void NoiseReductionBenchmark::median()
+{
+    QFETCH(int, width);
+    QFETCH(int, height);
+    QFETCH(int, filterSize);
+
+    const QImage image = noise(width, height);
+    QCOMPARE(YACReader::medianFilter(image, filterSize), referenceMedian(image, filterSize));
+}
+
+void NoiseReductionBenchmark::rowBands_data()
+{
+    QTest::addColumn<bool>("median");
+    QTest::addColumn<int>("filterSize");
+
+    QTest::newRow("mean 5x5") << false << 5;
+    QTest::newRow("median 5x5") << true << 5;
+}
+
+// the kernels are compared with the reference above on small images, big images (split in several row bands)
+// must give the same result as the kernel running on a single band
+void NoiseReductionBenchmark::rowBands()
+{
+    QFETCH(bool, median);
+    QFETCH(int, filterSize);
+
+    auto filter = [median, filterSize](const QImage &image) {
+        return median ? YACReader::medianFilter(image, filterSize) : YACReader::meanFilter(image, filterSize);
+    };
+
+    const QImage image = noise(1600, 2400);
+    const QImage bands = filter(image);
+
+    YACReader::setSequentialRowBands(true);
+    const QImage sequential = filter(image);
+    YACReader::setSequentialRowBands(false);
+
+    QCOMPARE(bands, sequential);
+}
+
+void NoiseReductionBenchmark::benchmark_data()
+{
+    QTest::addColumn<bool>("median");
+    QTest::addColumn<bool>("reference");
+    QTest::addColumn<int>("filterSize");
+
+    // a scanned page is around 3000x4500, the reference implementations take too long for that
+    for (int filterSize : { 3, 5 }) {
+        QTest::addRow("mean %dx%d reference", filterSize, filterSize) << false << true << filterSize;
+        QTest::addRow("mean %dx%d", filterSize, filterSize) << false << false << filterSize;
+        QTest::addRow("median %dx%d reference", filterSize, filterSize) << true << true << filterSize;
+        QTest::addRow("median %dx%d", filterSize, filterSize) << true << false << filterSize;
+    }
+}
+
+void NoiseReductionBenchmark::benchmark()
+{
+    QFETCH(bool, median);
+    QFETCH(bool, reference);
+    QFETCH(int, filterSize);
+
+    const QImage image = noise(1000, 1500);
+    QImage result;
+    QBENCHMARK {
+        if (median) {
+            result = reference ? referenceMedian(image, filterSize) : YACReader::medianFilter(image, filterSize);
+        } else {
+            result = reference ? referenceMean(image, filterSize) : YACReader::meanFilter(image, filterSize);
+        }
+    }
+    QVERIFY(!result.isNull());
+}
+
+QTEST_GUILESS_MAIN(NoiseReductionBenchmark)
+
+#include "noise_reduction_benchmark.moc"
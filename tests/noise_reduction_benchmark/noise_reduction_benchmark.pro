@@ -0,0 +1,11 @@
+include(../qt_test.pri)
+
+QT += gui
+
+PATH_TO_YACReader = ../../YACReader
+
+INCLUDEPATH += $$PATH_TO_YACReader
+HEADERS += $${PATH_TO_YACReader}/image_kernels.h
+SOURCES += \
+    $${PATH_TO_YACReader}/image_kernels.cpp \
+    noise_reduction_benchmark.cpp
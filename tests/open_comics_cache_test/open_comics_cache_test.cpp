@@ -0,0 +1,128 @@
+#include "yacreader_open_comics_cache.h"
+#include "comic.h"
+
+#include <QFile>
+#include <QObject>
+#include <QTemporaryDir>
+#include <QTest>
+
+namespace {
+
+// tar comic with `numPages` pages of `pageSize` bytes, the pages aren't decoded
+void writeComic(const QString &path, int numPages, int pageSize)
+{
+    QByteArray data;
+
+    for (int i = 0; i < numPages; i++) {
+        QByteArray header(512, '\0');
+        auto write = [&header](int offset, const QByteArray &value) {
+            header.replace(offset, value.size(), value);
+        };
+
+        write(0, QString("page%1.jpg").arg(i + 1, 3, 10, QChar('0')).toUtf8());
+        write(100, "0000644");
+        write(108, "0000000");
+        write(116, "0000000");
+        write(124, QByteArray::number(pageSize, 8).rightJustified(11, '0'));
+        write(136, QByteArray::number(1600000000, 8).rightJustified(11, '0'));
+        write(148, QByteArray(8, ' '));
+        header[156] = '0';
+        write(257, QByteArray("ustar\0", 6));
+        write(263, "00");
+
+        unsigned int checksum = 0;
+        for (char c : header) {
+            checksum += static_cast<unsigned char>(c);
+        }
+        write(148, QByteArray::number(checksum, 8).rightJustified(6, '0') + QByteArray("\0 ", 2));
+
+        data.append(header);
+        data.append(QByteArray(pageSize, static_cast<char>('a' + i % 26)));
+        data.append(QByteArray((512 - pageSize % 512) % 512, '\0'));
+    }
+
+    data.append(QByteArray(1024, '\0'));
+
+    QFile file(path);
+    file.open(QFile::WriteOnly);
+    file.write(data);
+}
+
+}
+
+class OpenComicsCacheTest : public QObject
+{
+    Q_OBJECT
+private slots:
+    void init();
+
+    void loadedComic();
+    void comicReleasedWhileLoading();
+    void sharedComic();
+
+private:
+    QTemporaryDir dir;
+};
+
+void OpenComicsCacheTest::init()
+{
+    QVERIFY(dir.isValid());
+}
+
+// the loading thread stops once all the pages are loaded, the comic is still open
+void OpenComicsCacheTest::loadedComic()
+{
+    QString path = dir.filePath("small.cbt");
+    writeComic(path, 4, 1000);
+
+    YACReaderOpenComicsCache cache;
+    auto comic = cache.open("small", path);
+    QVERIFY(!comic.isNull());
+    QTRY_VERIFY(comic->pageIsLoaded(3) || comic->hasBeenAnErrorOpening());
+
+    QTRY_COMPARE(cache.loadingThreads(), 0);
+    QCOMPARE(cache.count(), 1);
+
+    comic.reset();
+    QCOMPARE(cache.count(), 0);
+}
+
+// comics dismissed before they are loaded don't emit imagesLoaded, their threads must stop anyway
+void OpenComicsCacheTest::comicReleasedWhileLoading()
+{
+    QString path = dir.filePath("big.cbt");
+    writeComic(path, 300, 128 * 1024);
+
+    YACReaderOpenComicsCache cache;
+    for (int i = 0; i < 5; i++) {
+        auto comic = cache.open("big", path);
+        QVERIFY(!comic.isNull());
+    }
+
+    QCOMPARE(cache.count(), 0);
+    QTRY_COMPARE_WITH_TIMEOUT(cache.loadingThreads(), 0, 10000);
+}
+
+// the same comic is opened once, the thread stops when the last session releases it
+void OpenComicsCacheTest::sharedComic()
+{
+    QString path = dir.filePath("shared.cbt");
+    writeComic(path, 300, 128 * 1024);
+
+    YACReaderOpenComicsCache cache;
+    auto first = cache.open("shared", path);
+    auto second = cache.open("shared", path);
+    QCOMPARE(first, second);
+    QVERIFY(cache.loadingThreads() <= 1);
+
+    first.reset();
+    QCOMPARE(cache.count(), 1);
+
+    second.reset();
+    QCOMPARE(cache.count(), 0);
+    QTRY_COMPARE_WITH_TIMEOUT(cache.loadingThreads(), 0, 10000);
+}
+
+QTEST_GUILESS_MAIN(OpenComicsCacheTest)
+
+#include "open_comics_cache_test.moc"
@@ -0,0 +1,371 @@
+#include "remote_progress_sync.h"
+
+#include <QDir>
+#include <QFile>
+#include <QObject>
+#include <QSqlDatabase>
+#include <QSqlQuery>
+#include <QTemporaryDir>
+#include <QTest>
+
+#include <algorithm>
+#include <random>
+
+using Progress = RemoteProgressSync::Progress;
+
+namespace {
+const char *connectionName = "remote_progress_sync_benchmark";
+
+// the comic and comic_info columns used by the sync
+void createLibrary(QSqlDatabase &db, int comics)
+{
+    QSqlQuery query(db);
+    query.exec("CREATE TABLE comic_info (id INTEGER PRIMARY KEY, hash TEXT UNIQUE NOT NULL, numPages INTEGER, currentPage INTEGER DEFAULT 1, "
+               "read BOOLEAN DEFAULT 0, hasBeenOpened BOOLEAN DEFAULT 0, lastTimeOpened INTEGER, rating INTEGER DEFAULT 0)");
+    query.exec("CREATE TABLE comic (id INTEGER PRIMARY KEY, parentId INTEGER NOT NULL, comicInfoId INTEGER NOT NULL, fileName TEXT NOT NULL, path TEXT)");
+
+    QVariantList ids, hashes, numPages, currentPages, read, lastTimeOpened;
+    std::mt19937 generator(comics);
+    std::uniform_int_distribution<int> pages(10, 200);
+    for (int i = 1; i <= comics; i++) {
+        int comicPages = pages(generator);
+        int currentPage = std::uniform_int_distribution<int>(1, comicPages)(generator);
+        ids.append(i);
+        hashes.append(QString("%1%2").arg(i, 40, 16, QChar('0')).arg(comicPages * 1000000));
+        numPages.append(comicPages);
+        currentPages.append(currentPage);
+        read.append(currentPage == comicPages);
+        lastTimeOpened.append(i % 3 == 0 ? QVariant() : QVariant(1600000000 + i));
+    }
+
+    db.transaction();
+    query.prepare("INSERT INTO comic_info (id, hash, numPages, currentPage, read, hasBeenOpened, lastTimeOpened) VALUES (?, ?, ?, ?, ?, ?, ?)");
+    query.addBindValue(ids);
+    query.addBindValue(hashes);
+    query.addBindValue(numPages);
+    query.addBindValue(currentPages);
+    query.addBindValue(read);
+    query.addBindValue(read);
+    query.addBindValue(lastTimeOpened);
+    query.execBatch();
+    query.prepare("INSERT INTO comic (id, parentId, comicInfoId, fileName, path) VALUES (?, 1, ?, 'comic.cbz', '/comic.cbz')");
+    query.addBindValue(ids);
+    query.addBindValue(ids);
+    query.execBatch();
+    db.commit();
+}
+
+// progress of `count` comics of the library in a client, some of them with a hash that doesn't match
+QList<Progress> payload(QSqlDatabase &db, int count)
+{
+    QList<Progress> comics;
+    QSqlQuery query(db);
+    query.exec(QString("SELECT c.id, ci.hash, ci.numPages FROM comic c INNER JOIN comic_info ci ON (c.comicInfoId = ci.id) ORDER BY c.id DESC LIMIT %1").arg(count));
+
+    std::mt19937 generator(count);
+    while (query.next()) {
+        Progress comic;
+        comic.comicId = query.value(0).toULongLong();
+        comic.hash = query.value(1).toString();
+        if (comic.comicId % 50 == 0) {
+            comic.hash = "unknown";
+        }
+        int numPages = query.value(2).toInt();
+        comic.currentPage = std::uniform_int_distribution<int>(0, numPages)(generator);
+        comic.rating = std::uniform_int_distribution<int>(0, 5)(generator);
+        comic.lastTimeOpened = comic.currentPage > 0 ? 1700000000 + comic.comicId : 0;
+        comic.read = comic.currentPage == numPages;
+        comics.append(comic);
+    }
+
+    return comics;
+}
+
+// the per comic implementation that was used by DBHelper::updateFromRemoteClient, kept as the reference
+// for the results and the timings
+QList<qulonglong> referenceSyncById(const QList<Progress> &comics, QSqlDatabase &db)
+{
+    QList<qulonglong> moreRecentComics;
+
+    db.transaction();
+
+    QSqlQuery updateComicInfo(db);
+    updateComicInfo.prepare("UPDATE comic_info SET "
+                            "read = :read, "
+                            "currentPage = :currentPage, "
+                            "hasBeenOpened = :hasBeenOpened, "
+                            "lastTimeOpened = :lastTimeOpened, "
+                            "rating = :rating"
+                            " WHERE id = :id ");
+
+    for (const auto &comic : comics) {
+        QSqlQuery selectQuery(db);
+        selectQuery.prepare("SELECT ci.id, ci.hash, ci.numPages, ci.currentPage, ci.read, ci.hasBeenOpened, ci.lastTimeOpened, ci.rating "
+                            "FROM comic c INNER JOIN comic_info ci ON (c.comicInfoId = ci.id) WHERE c.id = :id");
+        selectQuery.bindValue(":id", comic.comicId);
+        selectQuery.exec();
+
+        if (!selectQuery.next() || selectQuery.value(1).toString() != comic.hash) {
+            continue;
+        }
+
+        auto id = selectQuery.value(0);
+        int numPages = selectQuery.value(2).toInt();
+        int currentPage = selectQuery.value(3).toInt();
+        bool read = selectQuery.value(4).toBool();
+        bool hasBeenOpened = selectQuery.value(5).toBool();
+        QVariant lastTimeOpened = selectQuery.value(6);
+        int rating = selectQuery.value(7).toInt();
+
+        bool isMoreRecent = false;
+
+        if ((currentPage > 1 && currentPage > comic.currentPage) || hasBeenOpened || (read && !comic.read)) {
+            isMoreRecent = true;
+        }
+
+        if (lastTimeOpened.toULongLong() > 0 && comic.lastTimeOpened == 0) {
+            isMoreRecent = true;
+        }
+
+        currentPage = qMax(currentPage, comic.currentPage);
+
+        if (currentPage == numPages)
+            read = true;
+
+        read = read || comic.read;
+
+        hasBeenOpened = hasBeenOpened || comic.currentPage > 0;
+
+        if (lastTimeOpened.toULongLong() < comic.lastTimeOpened && comic.lastTimeOpened > 0)
+            lastTimeOpened = comic.lastTimeOpened;
+
+        if (comic.rating > 0)
+            rating = comic.rating;
+
+        updateComicInfo.bindValue(":read", read ? 1 : 0);
+        updateComicInfo.bindValue(":currentPage", currentPage);
+        updateComicInfo.bindValue(":hasBeenOpened", hasBeenOpened ? 1 : 0);
+        updateComicInfo.bindValue(":lastTimeOpened", lastTimeOpened);
+        updateComicInfo.bindValue(":id", id);
+        updateComicInfo.bindValue(":rating", rating);
+        updateComicInfo.exec();
+
+        if (isMoreRecent) {
+            moreRecentComics.append(comic.comicId);
+        }
+    }
+
+    db.commit();
+
+    return moreRecentComics;
+}
+
+QStringList progressTable(QSqlDatabase &db)
+{
+    QStringList rows;
+    QSqlQuery query(db);
+    query.exec("SELECT id, currentPage, read, hasBeenOpened, lastTimeOpened, rating FROM comic_info ORDER BY id");
+    while (query.next()) {
+        QStringList row;
+        for (int i = 0; i < 6; i++) {
+            row.append(query.value(i).toString());
+        }
+        rows.append(row.join(","));
+    }
+    return rows;
+}
+
+// records the ids of the comic_info rows written from now on in `temp.updated_comic_info`
+void recordUpdates(QSqlDatabase &db)
+{
+    QSqlQuery query(db);
+    query.exec("CREATE TEMP TABLE updated_comic_info (id INTEGER)");
+    query.exec("CREATE TEMP TRIGGER record_comic_info_updates AFTER UPDATE ON main.comic_info "
+               "BEGIN INSERT INTO updated_comic_info VALUES (NEW.id); END");
+}
+
+int updatedRows(QSqlDatabase &db)
+{
+    QSqlQuery query(db);
+    query.exec("SELECT COUNT(*) FROM temp.updated_comic_info");
+    return query.next() ? query.value(0).toInt() : -1;
+}
+}
+
+class RemoteProgressSyncBenchmark : public QObject
+{
+    Q_OBJECT
+private slots:
+    void init();
+    void cleanup();
+
+    void syncById_data();
+    void syncById();
+    void syncByIdUnchangedProgress();
+    void syncByHash();
+    void syncByHashUnchangedProgress();
+    void benchmark_data();
+    void benchmark();
+
+private:
+    QTemporaryDir dir;
+    QSqlDatabase openLibrary(const QString &name, int comics);
+};
+
+QSqlDatabase RemoteProgressSyncBenchmark::openLibrary(const QString &name, int comics)
+{
+    auto db = QSqlDatabase::addDatabase("QSQLITE", connectionName + name);
+    db.setDatabaseName(dir.filePath(name + ".ydb"));
+    db.open();
+    createLibrary(db, comics);
+    return db;
+}
+
+void RemoteProgressSyncBenchmark::init()
+{
+    QVERIFY(dir.isValid());
+}
+
+void RemoteProgressSyncBenchmark::cleanup()
+{
+    for (const auto &name : QSqlDatabase::connectionNames()) {
+        QSqlDatabase::database(name).close();
+        QSqlDatabase::removeDatabase(name);
+    }
+    for (const auto &file : QDir(dir.path()).entryList(QDir::Files)) {
+        QFile::remove(dir.filePath(file));
+    }
+}
+
+void RemoteProgressSyncBenchmark::syncById_data()
+{
+    QTest::addColumn<int>("comics");
+    QTest::addColumn<int>("payloadSize");
+
+    QTest::newRow("empty payload") << 100 << 0;
+    QTest::newRow("some comics") << 100 << 30;
+    // several chunks
+    QTest::newRow("whole library") << 2000 << 2000;
+}
+
+void RemoteProgressSyncBenchmark::syncById()
+{
+    QFETCH(int, comics);
+    QFETCH(int, payloadSize);
+
+    auto reference = openLibrary("reference", comics);
+    auto db = openLibrary("batched", comics);
+
+    auto progress = payload(db, payloadSize);
+    // the same comic can be sent twice
+    if (!progress.isEmpty()) {
+        progress.append(progress.first());
+    }
+
+    auto expected = referenceSyncById(progress, reference);
+    auto moreRecent = RemoteProgressSync::syncById(progress, db);
+
+    std::sort(expected.begin(), expected.end());
+    std::sort(moreRecent.begin(), moreRecent.end());
+    QCOMPARE(moreRecent, expected);
+    QCOMPARE(progressTable(db), progressTable(reference));
+}
+
+// comics already up to date aren't written
+void RemoteProgressSyncBenchmark::syncByIdUnchangedProgress()
+{
+    auto db = openLibrary("unchanged", 100);
+
+    QSqlQuery query(db);
+    query.exec("UPDATE comic_info SET hasBeenOpened = 1, lastTimeOpened = 1600000010 WHERE id = 10");
+    query.exec("SELECT currentPage, read FROM comic_info WHERE id = 10");
+    QVERIFY(query.next());
+
+    Progress comic;
+    comic.comicId = 10;
+    comic.currentPage = query.value(0).toInt();
+    comic.read = query.value(1).toBool();
+    comic.lastTimeOpened = 1600000010;
+
+    auto before = progressTable(db);
+    recordUpdates(db);
+
+    RemoteProgressSync::syncById({ comic }, db);
+
+    QCOMPARE(updatedRows(db), 0);
+    QCOMPARE(progressTable(db), before);
+}
+
+void RemoteProgressSyncBenchmark::syncByHash()
+{
+    auto db = openLibrary("hash", 100);
+
+    Progress comic;
+    QSqlQuery query(db);
+    query.exec("SELECT hash, numPages FROM comic_info WHERE id = 10");
+    QVERIFY(query.next());
+    comic.hash = query.value(0).toString();
+    comic.currentPage = query.value(1).toInt();
+    comic.rating = 4;
+
+    Progress unknown;
+    unknown.hash = "unknown";
+    unknown.currentPage = 3;
+
+    RemoteProgressSync::syncByHash({ comic, unknown }, db);
+
+    query.exec("SELECT currentPage, read, hasBeenOpened, rating FROM comic_info WHERE id = 10");
+    QVERIFY(query.next());
+    QCOMPARE(query.value(0).toInt(), comic.currentPage);
+    QCOMPARE(query.value(1).toBool(), true);
+    QCOMPARE(query.value(2).toBool(), true);
+    QCOMPARE(query.value(3).toInt(), 4);
+}
+
+// comics sent without progress or rating keep their lastTimeOpened
+void RemoteProgressSyncBenchmark::syncByHashUnchangedProgress()
+{
+    auto db = openLibrary("hash_unchanged", 100);
+
+    Progress comic;
+    QSqlQuery query(db);
+    query.exec("SELECT hash FROM comic_info WHERE id = 10");
+    QVERIFY(query.next());
+    comic.hash = query.value(0).toString();
+    comic.currentPage = 0;
+    comic.rating = 0;
+
+    auto before = progressTable(db);
+    recordUpdates(db);
+
+    RemoteProgressSync::syncByHash({ comic }, db);
+
+    QCOMPARE(updatedRows(db), 0);
+    QCOMPARE(progressTable(db), before);
+}
+
+void RemoteProgressSyncBenchmark::benchmark_data()
+{
+    QTest::addColumn<bool>("reference");
+
+    QTest::newRow("50000 comics reference") << true;
+    QTest::newRow("50000 comics") << false;
+}
+
+void RemoteProgressSyncBenchmark::benchmark()
+{
+    QFETCH(bool, reference);
+
+    auto db = openLibrary("benchmark", 50000);
+    auto progress = payload(db, 50000);
+
+    QList<qulonglong> moreRecent;
+    QBENCHMARK_ONCE {
+        moreRecent = reference ? referenceSyncById(progress, db) : RemoteProgressSync::syncById(progress, db);
+    }
+    QVERIFY(!moreRecent.isEmpty());
+}
+
+QTEST_GUILESS_MAIN(RemoteProgressSyncBenchmark)
+
+#include "remote_progress_sync_benchmark.moc"
@@ -0,0 +1,11 @@
+include(../qt_test.pri)
+
+QT += sql
+
+PATH_TO_YACReaderLibrary = ../../YACReaderLibrary
+
+INCLUDEPATH += $${PATH_TO_YACReaderLibrary}/db
+HEADERS += $${PATH_TO_YACReaderLibrary}/db/remote_progress_sync.h
+SOURCES += \
+    $${PATH_TO_YACReaderLibrary}/db/remote_progress_sync.cpp \
+    remote_progress_sync_benchmark.cpp
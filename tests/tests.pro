@@ -1,2 +1,2 @@
 TEMPLATE = subdirs
-SUBDIRS += concurrent_queue_test
+SUBDIRS += concurrent_queue_test noise_reduction_benchmark remote_progress_sync_benchmark library_creator_test compressed_archive_test file_comic_test open_comics_cache_test
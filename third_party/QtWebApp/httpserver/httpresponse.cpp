@@ -76,7 +76,7 @@ void HttpResponse::writeHeaders()
 bool HttpResponse::writeToSocket(QByteArray data)
 {
     int remaining=data.size();
-    char* ptr=data.data();
+    const char* ptr=data.constData();
     while (socket->isOpen() && remaining>0)
     {
         // If the output buffer has become large, then wait until it has been sent.
@@ -107,8 +107,12 @@ void HttpResponse::write(QByteArray data, bool lastPart)
         // size of the response and therefore can set the Content-Length header automatically.
         if (lastPart)
         {
-           // Automatically set the Content-Length header
-           headers.insert("Content-Length",QByteArray::number(data.size()));
+           // Automatically set the Content-Length header. Responses that never have a body (204, 304) don't
+           // get it, a 304 would otherwise replace the length of the cached response with 0
+           if (statusCode!=204 && statusCode!=304)
+           {
+               headers.insert("Content-Length",QByteArray::number(data.size()));
+           }
         }
 
         // else if we will not close the connection at the end, them we must use the chunked mode.